@@ -0,0 +1,105 @@
+/**
+ * @file bench_ddt_query.cpp
+ * @brief Bulk DDT query throughput: descriptor scan vs. SoA mirror
+ *
+ * Usage:
+ *   bench_ddt_query [rounds]
+ *
+ * Fills the DDT to V4STD_DDT_MAX_DEVICES descriptors and times a few
+ * single-field predicates through Ddt::count_matching() (which scans the
+ * structure-of-arrays mirror in V4STD_DDT_SOA builds) against a plain
+ * loop over Ddt::get_all_devices(). Configure with -DV4STD_DDT_SOA=ON
+ * to compare both paths.
+ */
+
+#include "v4std/ddt.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace v4std;
+
+class BenchProvider : public DdtProvider {
+public:
+  explicit BenchProvider(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      uint8_t kind = static_cast<uint8_t>(1 + i % 12);
+      uint8_t flags = (i % 3 == 0) ? V4DEV_FLAG_ACTIVE_LOW : 0;
+      devices_.push_back({kind, static_cast<uint8_t>(1 + (i / 12) % 5),
+                          static_cast<uint8_t>(i / 60), flags,
+                          static_cast<uint32_t>(i * 7)});
+    }
+  }
+
+  span<const DeviceDesc> get_devices() const override {
+    return span<const DeviceDesc>{devices_.data(), devices_.size()};
+  }
+
+private:
+  std::vector<DeviceDesc> devices_;
+};
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start) {
+  return static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+}
+
+int main(int argc, char **argv) {
+  unsigned long rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+  if (rounds == 0) {
+    std::fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+    return 1;
+  }
+
+  BenchProvider provider(V4STD_DDT_MAX_DEVICES);
+  Ddt::set_provider(&provider);
+  size_t devices = Ddt::get_all_devices().size();
+
+  struct Case {
+    const char *name;
+    DeviceQuery query;
+  };
+  const Case cases[] = {
+      {"kind", DeviceQuery{}.with_kind(V4DEV_LED)},
+      {"flags", DeviceQuery{}.with_flags(V4DEV_FLAG_ACTIVE_LOW,
+                                         V4DEV_FLAG_ACTIVE_LOW)},
+      {"handle", DeviceQuery{}.with_handle(70)},
+      {"kind+role", DeviceQuery{}.with_kind(V4DEV_UART).with_role(
+                        V4ROLE_CONSOLE)},
+  };
+
+  std::printf("%zu devices, %lu rounds, SoA mirror %s\n", devices, rounds,
+              V4STD_DDT_SOA ? "on" : "off");
+  std::printf("%-10s %14s %14s %8s\n", "query", "scan ns/dev", "query ns/dev",
+              "matches");
+
+  for (const Case &c : cases) {
+    volatile size_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long r = 0; r < rounds; ++r) {
+      Ddt::ReadGuard guard;
+      size_t count = 0;
+      for (const auto &dev : Ddt::get_all_devices()) {
+        count += c.query.matches(dev);
+      }
+      sink = count;
+    }
+    double scan_ns = elapsed_ns(start) / (rounds * devices);
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long r = 0; r < rounds; ++r) {
+      sink = Ddt::count_matching(c.query);
+    }
+    double query_ns = elapsed_ns(start) / (rounds * devices);
+
+    std::printf("%-10s %14.3f %14.3f %8zu\n", c.name, scan_ns, query_ns,
+                static_cast<size_t>(sink));
+  }
+
+  Ddt::set_provider(nullptr);
+  return 0;
+}
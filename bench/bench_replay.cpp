@@ -0,0 +1,147 @@
+/**
+ * @file bench_replay.cpp
+ * @brief Record and replay SYS call logs against a virtual board
+ *
+ * Usage:
+ *   bench_replay record <log> [calls] [devices_per_role]
+ *   bench_replay replay <log> [devices_per_role] [--paced] [speed]
+ *
+ * "record" runs a synthetic LED workload on a VirtualBoard with a trace
+ * recorder attached and writes the log. "replay" loads a log (recorded
+ * here or captured from a device with SysTraceRecorder) and replays it
+ * against a fresh VirtualBoard, reporting throughput, latency
+ * percentiles, and result divergence.
+ */
+
+#include "v4std/ddt.hpp"
+#include "v4std/sim/sys_replay.hpp"
+#include "v4std/sim/virtual_board.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_led.hpp"
+#include "v4std/sys_trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace v4std;
+
+static uint32_t host_clock_us() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
+static uint32_t xorshift(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static void setup_board(VirtualBoard &board, size_t per_role) {
+  board.add_all(per_role);
+  Ddt::set_provider(&board);
+  set_led_hal(&board.led_hal());
+  register_led_sys_handlers();
+}
+
+static int record(const char *path, unsigned long calls, size_t per_role) {
+  VirtualBoard board;
+  setup_board(board, per_role);
+
+  std::vector<uint8_t> buffer(kSysTraceHeaderSize +
+                              calls * kSysTraceMaxRecordSize);
+  SysTraceRecorder recorder{span<uint8_t>{buffer.data(), buffer.size()},
+                            host_clock_us};
+  recorder.attach();
+
+  static const uint16_t ops[] = {V4SYS_LED_ON, V4SYS_LED_OFF,
+                                 V4SYS_LED_TOGGLE, V4SYS_LED_GET};
+  uint32_t rng = 0x12345678u;
+  for (unsigned long i = 0; i < calls; ++i) {
+    uint32_t r = xorshift(rng);
+    int32_t role = 1 + static_cast<int32_t>(r % V4ROLE_DEBUG);
+    int32_t index = static_cast<int32_t>((r >> 8) % (per_role + 1));
+    invoke_sys_handler(ops[(r >> 24) & 3], V4DEV_LED, role, index);
+  }
+  recorder.detach();
+
+  std::FILE *file = std::fopen(path, "wb");
+  if (!file) {
+    std::perror(path);
+    return 1;
+  }
+  std::fwrite(recorder.data().data(), 1, recorder.data().size(), file);
+  std::fclose(file);
+
+  std::printf("records:      %zu\n", recorder.record_count());
+  std::printf("log size:     %zu bytes (%.2f bytes/call)\n",
+              recorder.data().size(),
+              static_cast<double>(recorder.data().size()) /
+                  recorder.record_count());
+  return 0;
+}
+
+static int replay(const char *path, size_t per_role, bool paced,
+                  double speed) {
+  std::FILE *file = std::fopen(path, "rb");
+  if (!file) {
+    std::perror(path);
+    return 1;
+  }
+  std::vector<uint8_t> log;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    log.insert(log.end(), chunk, chunk + n);
+  }
+  std::fclose(file);
+
+  VirtualBoard board;
+  setup_board(board, per_role);
+
+  SysReplayOptions options;
+  options.paced = paced;
+  options.speed = speed;
+  SysReplayStats stats =
+      replay_sys_trace(span<const uint8_t>{log.data(), log.size()}, options);
+
+  if (stats.malformed) {
+    std::fprintf(stderr, "warning: log is malformed or truncated\n");
+  }
+  std::printf("calls:        %llu\n",
+              static_cast<unsigned long long>(stats.calls));
+  std::printf("divergences:  %llu\n",
+              static_cast<unsigned long long>(stats.divergences));
+  std::printf("elapsed:      %.3f s\n", stats.elapsed_ns / 1e9);
+  std::printf("throughput:   %.0f calls/s\n", stats.throughput());
+  std::printf("mean latency: %.1f ns\n", stats.mean_latency_ns());
+  std::printf("p50 / p99:    < %llu ns / < %llu ns\n",
+              static_cast<unsigned long long>(stats.latency_percentile_ns(50)),
+              static_cast<unsigned long long>(stats.latency_percentile_ns(99)));
+  return stats.malformed ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc >= 3 && std::strcmp(argv[1], "record") == 0) {
+    unsigned long calls = argc > 3 ? std::strtoul(argv[3], nullptr, 0) : 100000;
+    size_t per_role = argc > 4 ? std::strtoul(argv[4], nullptr, 0) : 16;
+    return record(argv[2], calls, per_role);
+  }
+
+  if (argc >= 3 && std::strcmp(argv[1], "replay") == 0) {
+    size_t per_role = argc > 3 ? std::strtoul(argv[3], nullptr, 0) : 16;
+    bool paced = argc > 4 && std::strcmp(argv[4], "--paced") == 0;
+    double speed = argc > 5 ? std::strtod(argv[5], nullptr) : 1.0;
+    return replay(argv[2], per_role, paced, speed);
+  }
+
+  std::fprintf(stderr,
+               "usage: %s record <log> [calls] [devices_per_role]\n"
+               "       %s replay <log> [devices_per_role] [--paced] [speed]\n",
+               argv[0], argv[0]);
+  return 2;
+}
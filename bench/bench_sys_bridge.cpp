@@ -0,0 +1,117 @@
+/**
+ * @file bench_sys_bridge.cpp
+ * @brief SYS call latency: inline vs. shared-memory bridge
+ *
+ * Usage:
+ *   bench_sys_bridge [calls] [batch]
+ *
+ * Times the same trivial handler called inline through
+ * invoke_sys_handler(), through SysBridge::call() to a forked HAL
+ * process (one round-trip per call), and through
+ * SysBridge::call_batch() in groups of [batch] calls.
+ */
+
+#include "v4std/linux/sys_bridge.hpp"
+#include "v4std/sys_handlers.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace v4std;
+
+static constexpr uint16_t kBenchId = 0x7F00;
+
+static int32_t bench_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                             int32_t arg2) {
+  (void)sys_id;
+  return arg0 + arg1 + arg2;
+}
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start) {
+  return static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+}
+
+int main(int argc, char **argv) {
+  unsigned long calls = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  unsigned long batch = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+  if (calls == 0 || batch == 0) {
+    std::fprintf(stderr, "usage: %s [calls] [batch]\n", argv[0]);
+    return 1;
+  }
+
+  register_sys_handler(kBenchId, bench_handler);
+
+  // Inline baseline
+  volatile int32_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < calls; ++i) {
+    sink = invoke_sys_handler(kBenchId, static_cast<int32_t>(i), 1, 2);
+  }
+  double inline_ns = elapsed_ns(start) / calls;
+
+  SysBridge bridge;
+  if (!bridge.create()) {
+    std::perror("memfd");
+    return 1;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    std::perror("fork");
+    return 1;
+  }
+  if (pid == 0) {
+    bridge.run();
+    _exit(0);
+  }
+
+  // One round-trip per call
+  int32_t result = 0;
+  start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < calls; ++i) {
+    if (!bridge.call(kBenchId, static_cast<int32_t>(i), 1, 2, result)) {
+      std::fprintf(stderr, "bridge call failed\n");
+      return 1;
+    }
+  }
+  double call_ns = elapsed_ns(start) / calls;
+  uint64_t call_waits = bridge.futex_waits();
+
+  // Batched
+  std::vector<SysBridgeCall> requests(batch);
+  std::vector<int32_t> results(batch);
+  for (unsigned long i = 0; i < batch; ++i) {
+    requests[i] = {kBenchId, {static_cast<int32_t>(i), 1, 2}};
+  }
+  unsigned long batched = 0;
+  start = std::chrono::steady_clock::now();
+  while (batched < calls) {
+    size_t n = calls - batched < batch ? calls - batched : batch;
+    if (bridge.call_batch(requests.data(), results.data(), n) != n) {
+      std::fprintf(stderr, "bridge batch failed\n");
+      return 1;
+    }
+    batched += n;
+  }
+  double batch_ns = elapsed_ns(start) / calls;
+
+  bridge.shutdown();
+  waitpid(pid, nullptr, 0);
+  (void)sink;
+
+  std::printf("calls:            %lu\n", calls);
+  std::printf("inline:           %.1f ns/call\n", inline_ns);
+  std::printf("bridge call:      %.1f ns/call (%.1fx inline, %llu parks)\n",
+              call_ns, call_ns / inline_ns,
+              static_cast<unsigned long long>(call_waits));
+  std::printf("bridge batch %-4lu %.1f ns/call (%.1fx inline)\n", batch,
+              batch_ns, batch_ns / inline_ns);
+  std::printf("final spin:       %u\n", bridge.spin_budget());
+  return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file bench_virtual_board.cpp
+ * @brief Load test: LED SYS calls across a large virtual board
+ *
+ * Usage: bench_virtual_board [devices_per_role] [calls] [threads]
+ *                            [latency_ns]
+ *
+ * Populates a VirtualBoard with devices_per_role devices for every
+ * kind/role, registers the LED handlers, and drives random LED calls
+ * through invoke_sys_handler() from each thread. Reports throughput and
+ * HAL call counts.
+ */
+
+#include "v4std/ddt.hpp"
+#include "v4std/sim/virtual_board.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_led.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace v4std;
+
+static uint32_t xorshift(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static unsigned long parse_arg(int argc, char **argv, int i,
+                               unsigned long fallback) {
+  return argc > i ? std::strtoul(argv[i], nullptr, 0) : fallback;
+}
+
+int main(int argc, char **argv) {
+  size_t per_role = parse_arg(argc, argv, 1, 64);
+  unsigned long calls = parse_arg(argc, argv, 2, 1000000);
+  unsigned long thread_count = parse_arg(argc, argv, 3, 1);
+  uint32_t latency_ns = static_cast<uint32_t>(parse_arg(argc, argv, 4, 0));
+
+  if (thread_count == 0) {
+    thread_count = 1;
+  }
+
+  VirtualBoard board;
+  if (!board.add_all(per_role)) {
+    std::fprintf(stderr, "devices_per_role must be <= %zu\n",
+                 VirtualBoard::kMaxPerRole);
+    return 1;
+  }
+  board.hal(V4DEV_LED).set_latency_ns(latency_ns);
+
+  Ddt::set_provider(&board);
+  set_led_hal(&board.led_hal());
+  register_led_sys_handlers();
+
+  static const uint16_t ops[] = {V4SYS_LED_ON, V4SYS_LED_OFF,
+                                 V4SYS_LED_TOGGLE, V4SYS_LED_GET};
+  const int32_t roles = V4ROLE_DEBUG;
+  const int32_t indices = static_cast<int32_t>(per_role);
+  unsigned long per_thread = calls / thread_count;
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> threads;
+  for (unsigned long t = 0; t < thread_count; ++t) {
+    threads.emplace_back([=] {
+      uint32_t rng = 0x9E3779B9u ^ static_cast<uint32_t>(t + 1);
+      for (unsigned long i = 0; i < per_thread; ++i) {
+        uint32_t r = xorshift(rng);
+        int32_t role = 1 + static_cast<int32_t>(r % roles);
+        int32_t index = static_cast<int32_t>((r >> 8) % indices);
+        invoke_sys_handler(ops[(r >> 24) & 3], V4DEV_LED, role, index);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double seconds = std::chrono::duration<double>(elapsed).count();
+  unsigned long total = per_thread * thread_count;
+
+  std::printf("devices:      %zu (%zu per kind/role)\n", board.device_count(),
+              per_role);
+  std::printf("threads:      %lu\n", thread_count);
+  std::printf("SYS calls:    %lu\n", total);
+  std::printf("HAL calls:    %llu\n",
+              static_cast<unsigned long long>(board.total_calls()));
+  std::printf("elapsed:      %.3f s\n", seconds);
+  std::printf("throughput:   %.0f calls/s\n", total / seconds);
+  std::printf("per call:     %.1f ns\n", seconds * 1e9 / total);
+
+  return 0;
+}
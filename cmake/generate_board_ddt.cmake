@@ -0,0 +1,283 @@
+#!/usr/bin/env cmake -P
+# @file generate_board_ddt.cmake
+# @brief Generate a board's device table header from board_devices.def
+#
+# Usage: cmake -DINPUT_FILE=... -DOUTPUT_FILE=... -DBOARD=... [-DCOMPACT=ON]
+# -P generate_board_ddt.cmake
+#
+# Each V4DEV_DEF(KIND, ROLE, INDEX, FLAGS, HANDLE) line becomes one
+# DeviceDesc. KIND and ROLE are v4dev_kind_t / v4dev_role_t names without
+# their prefix (or numbers); FLAGS is 0, a number, or V4DEV_FLAG_* suffixes
+# joined with '|'. The header also holds a collision-free hash table over the
+# (kind, role, index) keys (see static_ddt.hpp) and a Provider class, in
+# namespace v4std::boards::BOARD. With COMPACT (builds with
+# V4STD_DDT_COMPACT), roles and flags must be below 16 and handles below 256.
+
+if(NOT INPUT_FILE
+   OR NOT OUTPUT_FILE
+   OR NOT BOARD)
+  message(
+    FATAL_ERROR
+      "Usage: cmake -DINPUT_FILE=<def> -DOUTPUT_FILE=<hpp> -DBOARD=<name> -P generate_board_ddt.cmake"
+  )
+endif()
+
+if(NOT BOARD MATCHES "^[A-Za-z_][A-Za-z0-9_]*$")
+  message(FATAL_ERROR "Board name '${BOARD}' is not a C++ identifier")
+endif()
+
+# Enumerator names in value order (ddt_types.h)
+set(KIND_NAMES
+    NONE
+    LED
+    BUTTON
+    BUZZER
+    TIMER
+    UART
+    I2C
+    SPI
+    ADC
+    PWM
+    STORAGE
+    DISPLAY
+    RNG)
+set(ROLE_NAMES
+    NONE
+    STATUS
+    USER
+    POWER
+    CONSOLE
+    DEBUG)
+
+# Resolve NAME (or a number below 256) to its value and C++ spelling
+function(resolve_name NAME NAMES PREFIX OUT_VALUE OUT_CODE)
+  list(FIND ${NAMES} "${NAME}" VALUE)
+  if(VALUE GREATER_EQUAL 0)
+    set(CODE "${PREFIX}${NAME}")
+  elseif(NAME MATCHES "^(0x[0-9A-Fa-f]+|[0-9]+)$")
+    math(EXPR VALUE "${NAME}")
+    set(CODE "${VALUE}")
+  else()
+    message(FATAL_ERROR "${INPUT_FILE}: unknown name '${NAME}'")
+  endif()
+  if(VALUE GREATER 255)
+    message(FATAL_ERROR "${INPUT_FILE}: '${NAME}' does not fit in 8 bits")
+  endif()
+  set(${OUT_VALUE}
+      ${VALUE}
+      PARENT_SCOPE)
+  set(${OUT_CODE}
+      "${CODE}"
+      PARENT_SCOPE)
+endfunction()
+
+file(READ "${INPUT_FILE}" DEF_CONTENT)
+string(REPLACE "\n" ";" DEF_LINES "${DEF_CONTENT}")
+
+set(NUMBER "(0x[0-9A-Fa-f]+|[0-9]+)")
+set(DEVICE_ROWS "")
+set(KEYS "")
+set(SORT_ENTRIES "")
+set(COUNT 0)
+
+foreach(LINE ${DEF_LINES})
+  if(LINE MATCHES "^[ \t]*//" OR LINE MATCHES "^[ \t]*$")
+    continue()
+  elseif(
+    LINE MATCHES
+    "^[ \t]*V4DEV_DEF\\([ \t]*([A-Z0-9_a-fx]+),[ \t]*([A-Z0-9_a-fx]+),[ \t]*${NUMBER},[ \t]*([A-Z0-9_|a-fx]+),[ \t]*${NUMBER}[ \t]*\\)"
+  )
+    set(DEV_KIND "${CMAKE_MATCH_1}")
+    set(DEV_ROLE "${CMAKE_MATCH_2}")
+    set(DEV_INDEX "${CMAKE_MATCH_3}")
+    set(DEV_FLAGS "${CMAKE_MATCH_4}")
+    set(DEV_HANDLE "${CMAKE_MATCH_5}")
+  else()
+    message(FATAL_ERROR "${INPUT_FILE}: malformed entry: ${LINE}")
+  endif()
+
+  resolve_name("${DEV_KIND}" KIND_NAMES "V4DEV_" KIND_VALUE KIND_CODE)
+  resolve_name("${DEV_ROLE}" ROLE_NAMES "V4ROLE_" ROLE_VALUE ROLE_CODE)
+  math(EXPR INDEX_VALUE "${DEV_INDEX}")
+  math(EXPR HANDLE_VALUE "${DEV_HANDLE}")
+  if(INDEX_VALUE GREATER 255 OR HANDLE_VALUE GREATER 4294967295)
+    message(FATAL_ERROR "${INPUT_FILE}: index or handle out of range: ${LINE}")
+  endif()
+  if(COMPACT AND (ROLE_VALUE GREATER 15 OR HANDLE_VALUE GREATER 255))
+    message(FATAL_ERROR "${INPUT_FILE}: role or handle too large for the "
+                        "compact layout: ${LINE}")
+  endif()
+
+  if(DEV_FLAGS MATCHES "^${NUMBER}$")
+    math(EXPR FLAGS_CODE "${DEV_FLAGS}")
+    if(COMPACT AND FLAGS_CODE GREATER 15)
+      message(FATAL_ERROR "${INPUT_FILE}: flags too large for the compact "
+                          "layout: ${LINE}")
+    endif()
+  else()
+    string(REPLACE "|" " | V4DEV_FLAG_" FLAGS_CODE "V4DEV_FLAG_${DEV_FLAGS}")
+  endif()
+
+  # Keys must be unique: a generated table has no "first entry wins"
+  math(EXPR KEY "(${KIND_VALUE} << 16) | (${ROLE_VALUE} << 8) | ${INDEX_VALUE}")
+  list(FIND KEYS ${KEY} DUPLICATE)
+  if(DUPLICATE GREATER_EQUAL 0)
+    message(
+      FATAL_ERROR
+        "${INPUT_FILE}: duplicate device ${DEV_KIND} ${DEV_ROLE} ${DEV_INDEX}")
+  endif()
+  list(APPEND KEYS ${KEY})
+
+  string(APPEND DEVICE_ROWS "    {${KIND_CODE}, ${ROLE_CODE}, ${INDEX_VALUE}, "
+         "${FLAGS_CODE}, ${HANDLE_VALUE}u},\n")
+
+  # Zero-padded so that a string sort is a numeric sort
+  string(LENGTH "${KEY}" KEY_LEN)
+  set(SORT_KEY "${KEY}")
+  while(KEY_LEN LESS 8)
+    set(SORT_KEY "0${SORT_KEY}")
+    math(EXPR KEY_LEN "${KEY_LEN} + 1")
+  endwhile()
+  list(APPEND SORT_ENTRIES "${SORT_KEY}|${COUNT}")
+
+  math(EXPR COUNT "${COUNT} + 1")
+endforeach()
+
+if(COUNT EQUAL 0)
+  message(FATAL_ERROR "${INPUT_FILE}: no V4DEV_DEF entries")
+endif()
+if(COUNT GREATER 65534)
+  message(FATAL_ERROR "${INPUT_FILE}: more than 65534 devices")
+endif()
+
+# ============================================================================
+# Perfect hash
+# ============================================================================
+
+# Smallest power-of-two table (at least 2 slots) that holds every key, then
+# a multiplier under which no two keys share a slot; double the table if
+# none of the candidates works
+set(BITS 1)
+math(EXPR TABLE_SIZE "1 << ${BITS}")
+while(TABLE_SIZE LESS COUNT)
+  math(EXPR BITS "${BITS} + 1")
+  math(EXPR TABLE_SIZE "1 << ${BITS}")
+endwhile()
+
+set(FOUND FALSE)
+while(NOT FOUND)
+  if(BITS GREATER 20)
+    message(FATAL_ERROR "${INPUT_FILE}: no perfect hash found")
+  endif()
+  math(EXPR SHIFT "32 - ${BITS}")
+
+  foreach(ATTEMPT RANGE 255)
+    # Odd multipliers spread over the 32-bit range
+    math(EXPR MULTIPLIER
+         "((0x9E3779B1 + ${ATTEMPT} * 0x2C1B3C6E) & 0xFFFFFFFF) | 1")
+    set(USED "")
+    set(COLLISION FALSE)
+    foreach(KEY ${KEYS})
+      math(EXPR SLOT "((${KEY} * ${MULTIPLIER}) & 0xFFFFFFFF) >> ${SHIFT}")
+      list(FIND USED ${SLOT} TAKEN)
+      if(TAKEN GREATER_EQUAL 0)
+        set(COLLISION TRUE)
+        break()
+      endif()
+      list(APPEND USED ${SLOT})
+    endforeach()
+
+    if(NOT COLLISION)
+      set(FOUND TRUE)
+      break()
+    endif()
+  endforeach()
+
+  if(NOT FOUND)
+    math(EXPR BITS "${BITS} + 1")
+    math(EXPR TABLE_SIZE "1 << ${BITS}")
+  endif()
+endwhile()
+
+# USED[i] is the slot of device i
+set(SLOT_ROWS "")
+math(EXPR LAST_SLOT "${TABLE_SIZE} - 1")
+foreach(SLOT RANGE ${LAST_SLOT})
+  list(FIND USED ${SLOT} POSITION)
+  if(POSITION GREATER_EQUAL 0)
+    string(APPEND SLOT_ROWS "    ${POSITION},\n")
+  else()
+    string(APPEND SLOT_ROWS "    kDdtEmptySlot,\n")
+  endif()
+endforeach()
+
+list(SORT SORT_ENTRIES)
+set(SORTED_ROWS "")
+foreach(ENTRY ${SORT_ENTRIES})
+  string(REGEX REPLACE "^[0-9]+\\|" "" POSITION "${ENTRY}")
+  string(APPEND SORTED_ROWS "    ${POSITION},\n")
+endforeach()
+
+math(EXPR MULTIPLIER_HEX "${MULTIPLIER}" OUTPUT_FORMAT HEXADECIMAL)
+get_filename_component(INPUT_NAME "${INPUT_FILE}" NAME)
+string(TOUPPER "${BOARD}" BOARD_UPPER)
+
+# ============================================================================
+# Header
+# ============================================================================
+
+file(
+  WRITE "${OUTPUT_FILE}"
+  "/**
+ * @file ${BOARD}_ddt.hpp
+ * @brief Device table for board ${BOARD} (auto-generated)
+ *
+ * THIS FILE IS AUTO-GENERATED FROM ${INPUT_NAME}
+ * DO NOT EDIT MANUALLY!
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_BOARD_${BOARD_UPPER}_DDT_HPP
+#define V4STD_BOARD_${BOARD_UPPER}_DDT_HPP
+
+#include \"v4std/static_ddt.hpp\"
+
+namespace v4std::boards::${BOARD} {
+
+/** @brief Devices, in board_devices.def order */
+inline constexpr DeviceDesc devices[] = {
+${DEVICE_ROWS}};
+
+/** @brief Device position per hash slot */
+inline constexpr uint16_t hash_slots[] = {
+${SLOT_ROWS}};
+
+/** @brief Device positions in (kind, role, index) order */
+inline constexpr uint16_t sorted_positions[] = {
+${SORTED_ROWS}};
+
+inline constexpr DdtPerfectHash hash{${MULTIPLIER_HEX}u, ${SHIFT}};
+
+static_assert(check_perfect_hash(devices, hash_slots, hash),
+              \"${INPUT_NAME}: generated hash table is inconsistent\");
+
+/** @brief Provider serving this board's table */
+class Provider final : public StaticDdtProvider {
+public:
+  Provider()
+      : StaticDdtProvider(span<const DeviceDesc>{devices},
+                          span<const uint16_t>{hash_slots},
+                          span<const uint16_t>{sorted_positions}, hash) {}
+};
+
+} // namespace v4std::boards::${BOARD}
+
+#endif // V4STD_BOARD_${BOARD_UPPER}_DDT_HPP
+")
+
+message(
+  STATUS
+    "Generated ${OUTPUT_FILE} from ${INPUT_FILE} (${COUNT} devices, ${TABLE_SIZE} slots)"
+)
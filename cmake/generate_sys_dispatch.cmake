@@ -0,0 +1,131 @@
+#!/usr/bin/env cmake -P
+# @file generate_sys_dispatch.cmake
+# @brief Generate the ROM SYS dispatch table from a handler manifest
+#
+# Usage: cmake -DINPUT_FILE=<manifest> -DIDS_FILE=<v4sys_ids.def>
+# -DOUTPUT_FILE=<h> -P generate_sys_dispatch.cmake
+#
+# Each V4SYS_HANDLER(NAME, FUNCTION, FLAGS) or V4SYS_CELL_HANDLER(NAME,
+# FUNCTION, FLAGS) line becomes one SysHandlerEntry of a constexpr table
+# sorted by SYS ID (see v4sys_handlers.def), for builds with
+# V4STD_ROM_DISPATCH.
+
+if(NOT INPUT_FILE
+   OR NOT IDS_FILE
+   OR NOT OUTPUT_FILE)
+  message(
+    FATAL_ERROR
+      "Usage: cmake -DINPUT_FILE=<manifest> -DIDS_FILE=<def> -DOUTPUT_FILE=<h> -P generate_sys_dispatch.cmake"
+  )
+endif()
+
+# SYS ID values by name, from v4sys_ids.def
+file(STRINGS "${IDS_FILE}" ID_LINES REGEX "^[ \t]*V4SYS_DEF\\(")
+foreach(LINE ${ID_LINES})
+  if(LINE MATCHES "V4SYS_DEF\\(([A-Z0-9_]+),[ \t]*0x([0-9A-Fa-f]+),")
+    set(ID_${CMAKE_MATCH_1} "${CMAKE_MATCH_2}")
+  endif()
+endforeach()
+
+file(READ "${INPUT_FILE}" MANIFEST_CONTENT)
+string(REPLACE "\n" ";" MANIFEST_LINES "${MANIFEST_CONTENT}")
+
+set(INCLUDES "")
+set(ENTRIES "")
+set(COUNT 0)
+
+foreach(LINE ${MANIFEST_LINES})
+  if(LINE MATCHES "^[ \t]*V4SYS_HANDLER_HEADER\\([ \t]*\"([^\"]+)\"[ \t]*\\)")
+    string(APPEND INCLUDES "#include \"${CMAKE_MATCH_1}\"\n")
+  elseif(
+    LINE MATCHES
+    "^[ \t]*V4SYS_(CELL_)?HANDLER\\([ \t]*([A-Z0-9_]+),[ \t]*([A-Za-z_][A-Za-z0-9_]*),[ \t]*([A-Z0-9_|]+)[ \t]*\\)"
+  )
+    set(CELL "${CMAKE_MATCH_1}")
+    set(SYS_NAME "${CMAKE_MATCH_2}")
+    set(FUNCTION "${CMAKE_MATCH_3}")
+    set(FLAGS "${CMAKE_MATCH_4}")
+
+    if(NOT DEFINED ID_${SYS_NAME})
+      message(FATAL_ERROR "${INPUT_FILE}: unknown SYS call '${SYS_NAME}'")
+    endif()
+    if(DEFINED SEEN_${SYS_NAME})
+      message(FATAL_ERROR "${INPUT_FILE}: duplicate handler for '${SYS_NAME}'")
+    endif()
+    set(SEEN_${SYS_NAME} TRUE)
+
+    if(FLAGS STREQUAL "0")
+      set(FLAGS_CODE "0")
+    else()
+      string(REPLACE "|" " | V4SYS_HANDLER_" FLAGS_CODE
+                     "V4SYS_HANDLER_${FLAGS}")
+    endif()
+    if(CELL)
+      set(HANDLERS_CODE "nullptr, ${FUNCTION}")
+    else()
+      set(HANDLERS_CODE "${FUNCTION}")
+    endif()
+    set(ROW_${SYS_NAME}
+        "{V4SYS_${SYS_NAME}, ${FLAGS_CODE}, ${HANDLERS_CODE}}")
+
+    # Zero-padded upper-case hex so that a string sort is a numeric sort
+    string(TOUPPER "${ID_${SYS_NAME}}" SORT_KEY)
+    string(LENGTH "${SORT_KEY}" SORT_KEY_LEN)
+    while(SORT_KEY_LEN LESS 4)
+      set(SORT_KEY "0${SORT_KEY}")
+      math(EXPR SORT_KEY_LEN "${SORT_KEY_LEN} + 1")
+    endwhile()
+    list(APPEND ENTRIES "${SORT_KEY}|${SYS_NAME}")
+    math(EXPR COUNT "${COUNT} + 1")
+  elseif(LINE MATCHES "^[ \t]*V4SYS_(CELL_)?HANDLER")
+    message(FATAL_ERROR "${INPUT_FILE}: malformed entry: ${LINE}")
+  endif()
+endforeach()
+
+if(COUNT EQUAL 0)
+  message(FATAL_ERROR "${INPUT_FILE}: no V4SYS_HANDLER entries")
+endif()
+
+list(SORT ENTRIES)
+set(ROWS "")
+foreach(ENTRY ${ENTRIES})
+  string(REGEX REPLACE "^[0-9A-F]+\\|" "" SYS_NAME "${ENTRY}")
+  string(APPEND ROWS "    ${ROW_${SYS_NAME}},\n")
+endforeach()
+
+get_filename_component(INPUT_NAME "${INPUT_FILE}" NAME)
+
+file(
+  WRITE "${OUTPUT_FILE}"
+  "/**
+ * @file sys_dispatch_table.h
+ * @brief ROM SYS dispatch table (auto-generated)
+ *
+ * THIS FILE IS AUTO-GENERATED FROM ${INPUT_NAME}
+ * DO NOT EDIT MANUALLY!
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_SYS_DISPATCH_TABLE_H
+#define V4STD_SYS_DISPATCH_TABLE_H
+
+#include \"v4std/sys_handlers.hpp\"
+#include \"v4std/sys_ids.h\"
+${INCLUDES}
+namespace v4std {
+
+/** @brief Handlers in ascending SYS ID order */
+inline constexpr SysHandlerEntry kRomSysHandlers[] = {
+${ROWS}};
+
+inline constexpr size_t kRomSysHandlerCount =
+    sizeof(kRomSysHandlers) / sizeof(kRomSysHandlers[0]);
+
+} // namespace v4std
+
+#endif // V4STD_SYS_DISPATCH_TABLE_H
+")
+
+message(STATUS "Generated ${OUTPUT_FILE} from ${INPUT_FILE} (${COUNT} handlers)")
@@ -1,8 +1,13 @@
 #!/usr/bin/env cmake -P
 # @file generate_sys_ids.cmake
-# @brief Generate sys_ids.h from v4sys_ids.def
+# @brief Generate sys_ids.h, sys_meta_table.h and a Forth word library from
+# v4sys_ids.def
 #
-# Usage: cmake -DINPUT_FILE=... -DOUTPUT_FILE=... -P generate_sys_ids.cmake
+# Usage: cmake -DINPUT_FILE=... -DOUTPUT_FILE=... [-DMETA_OUTPUT_FILE=...]
+# [-DFTH_OUTPUT_FILE=...] -P generate_sys_ids.cmake
+#
+# Each V4SYS_DEF entry takes its stack effect from the nearest preceding "//
+# Stack: ( ... -- ... )" comment, which must agree with its IN/OUT arity.
 
 if(NOT INPUT_FILE OR NOT OUTPUT_FILE)
   message(
@@ -38,6 +43,13 @@ extern \"C\" {
 
 ")
 
+# Entries for sys_meta_table.h, as "HEXVALUE|NAME" sort keys
+set(SYS_ENTRIES "")
+
+# Forth word definitions, in v4sys_ids.def order
+set(FTH_WORDS "")
+set(STACK_EFFECT "")
+
 # Process each line
 string(REPLACE "\n" ";" DEF_LINES "${DEF_CONTENT}")
 
@@ -46,6 +58,13 @@ foreach(LINE ${DEF_LINES})
   if(LINE MATCHES "^[ \t]*//")
     # Keep comment lines
     string(APPEND OUTPUT_CONTENT "${LINE}\n")
+
+    if(LINE MATCHES "^[ \t]*//[ \t]*Stack:[ \t]*(\\(.*\\))[ \t]*$")
+      set(STACK_EFFECT "${CMAKE_MATCH_1}")
+    elseif(LINE MATCHES "=====")
+      # Stack effects do not carry across sections
+      set(STACK_EFFECT "")
+    endif()
   elseif(LINE MATCHES "^[ \t]*\\*")
     # Skip file header comments
   elseif(LINE MATCHES "^[ \t]*$")
@@ -53,15 +72,68 @@ foreach(LINE ${DEF_LINES})
     string(APPEND OUTPUT_CONTENT "\n")
   elseif(
     LINE MATCHES
-    "V4SYS_DEF\\(([A-Z0-9_]+),[ \t]*0x([0-9A-Fa-f]+),[ \t]*\"([^\"]+)\"\\)")
-    # Extract: NAME, HEX_VALUE, DESCRIPTION
+    "V4SYS_DEF\\(([A-Z0-9_]+),[ \t]*0x([0-9A-Fa-f]+),[ \t]*([0-9]+),[ \t]*([0-9]+),[ \t]*([A-Z0-9_]+),[ \t]*([A-Z0-9_|]+),[ \t]*\"([^\"]+)\"\\)"
+  )
+    # Extract: NAME, HEX_VALUE, IN, OUT, KIND, FLAGS, DESCRIPTION
     set(SYS_NAME ${CMAKE_MATCH_1})
     set(SYS_VALUE ${CMAKE_MATCH_2})
-    set(SYS_DESC ${CMAKE_MATCH_3})
+    set(SYS_IN ${CMAKE_MATCH_3})
+    set(SYS_OUT ${CMAKE_MATCH_4})
+    set(SYS_KIND ${CMAKE_MATCH_5})
+    set(SYS_FLAGS ${CMAKE_MATCH_6})
+    set(SYS_DESC ${CMAKE_MATCH_7})
 
     # Generate C/C++ constant definition
     string(APPEND OUTPUT_CONTENT
            "#define V4SYS_${SYS_NAME} 0x${SYS_VALUE}  /**< ${SYS_DESC} */\n")
+
+    # Stack effect must match the declared arity
+    if(NOT STACK_EFFECT MATCHES "^\\((.*)--(.*)\\)$")
+      message(FATAL_ERROR "V4SYS_${SYS_NAME}: missing '// Stack:' comment")
+    endif()
+    set(EFFECT_IN "${CMAKE_MATCH_1}")
+    set(EFFECT_OUT "${CMAKE_MATCH_2}")
+    string(REGEX MATCHALL "[^ \t]+" EFFECT_IN "${EFFECT_IN}")
+    string(REGEX MATCHALL "[^ \t]+" EFFECT_OUT "${EFFECT_OUT}")
+    list(LENGTH EFFECT_IN EFFECT_IN_LEN)
+    list(LENGTH EFFECT_OUT EFFECT_OUT_LEN)
+    if(NOT EFFECT_IN_LEN EQUAL SYS_IN OR NOT EFFECT_OUT_LEN EQUAL SYS_OUT)
+      message(
+        FATAL_ERROR
+          "V4SYS_${SYS_NAME}: arity ${SYS_IN} -> ${SYS_OUT} does not match "
+          "stack effect ${STACK_EFFECT}")
+    endif()
+
+    # Forth word: LED_ON -> led-on, compiled as an inline literal SYS call
+    string(TOLOWER "${SYS_NAME}" FTH_NAME)
+    string(REPLACE "_" "-" FTH_NAME "${FTH_NAME}")
+    math(EXPR SYS_DEC "0x${SYS_VALUE}")
+    string(APPEND FTH_WORDS "\\ V4SYS_${SYS_NAME} (0x${SYS_VALUE}): ${SYS_DESC}\n"
+           ": ${FTH_NAME} ${STACK_EFFECT} ${SYS_DEC} sys ;\n\n")
+
+    # FLAGS: 0 or a '|'-separated list of V4SYS_FLAG_* suffixes
+    if(SYS_FLAGS STREQUAL "0")
+      set(META_FLAGS "0")
+    else()
+      string(REPLACE "|" " | V4SYS_FLAG_" META_FLAGS "V4SYS_FLAG_${SYS_FLAGS}")
+    endif()
+
+    set(META_ROW_${SYS_NAME}
+        "{V4SYS_${SYS_NAME}, ${SYS_IN}, ${SYS_OUT}, V4DEV_${SYS_KIND}, ${META_FLAGS}}"
+    )
+    set(META_KIND_${SYS_NAME} ${SYS_KIND})
+    set(META_DESC_${SYS_NAME} "${SYS_DESC}")
+
+    # Zero-padded upper-case hex so that a string sort is a numeric sort
+    string(TOUPPER "${SYS_VALUE}" SORT_KEY)
+    string(LENGTH "${SORT_KEY}" SORT_KEY_LEN)
+    while(SORT_KEY_LEN LESS 4)
+      set(SORT_KEY "0${SORT_KEY}")
+      math(EXPR SORT_KEY_LEN "${SORT_KEY_LEN} + 1")
+    endwhile()
+    list(APPEND SYS_ENTRIES "${SORT_KEY}|${SYS_NAME}")
+  elseif(LINE MATCHES "V4SYS_DEF\\(")
+    message(FATAL_ERROR "Malformed V4SYS_DEF entry: ${LINE}")
   elseif(LINE MATCHES "=====")
     # Keep separator lines for readability
     string(APPEND OUTPUT_CONTENT "${LINE}\n")
@@ -84,3 +156,166 @@ string(
 file(WRITE "${OUTPUT_FILE}" "${OUTPUT_CONTENT}")
 
 message(STATUS "Generated ${OUTPUT_FILE} from ${INPUT_FILE}")
+
+# ============================================================================
+# Metadata table
+# ============================================================================
+
+if(META_OUTPUT_FILE)
+  list(SORT SYS_ENTRIES)
+
+  set(META_ROWS "")
+  set(SORTED_IDS "")
+  set(ORDINALS "")
+  set(UNIQUE_ASSERTS "")
+  set(RANGE_ASSERTS "")
+  set(NAME_POOL "")
+  set(NAME_OFFSETS "")
+  set(NAME_OFFSET 0)
+  set(DESC_POOL "")
+  set(DESC_OFFSETS "")
+  set(DESC_OFFSET 0)
+  set(ORDINAL 0)
+  set(PREV_NAME "")
+
+  foreach(ENTRY ${SYS_ENTRIES})
+    string(REPLACE "|" ";" ENTRY_PARTS "${ENTRY}")
+    list(GET ENTRY_PARTS 0 SYS_VALUE)
+    list(GET ENTRY_PARTS 1 SYS_NAME)
+    set(SYS_KIND ${META_KIND_${SYS_NAME}})
+
+    string(APPEND META_ROWS "    ${META_ROW_${SYS_NAME}},\n")
+    string(APPEND SORTED_IDS "    V4SYS_${SYS_NAME},\n")
+    string(APPEND ORDINALS "  V4SYS_ORD_${SYS_NAME} = ${ORDINAL},\n")
+    string(
+      APPEND
+      RANGE_ASSERTS
+      "static_assert(sys_range_kind(V4SYS_${SYS_NAME}) == V4DEV_${SYS_KIND},
+              \"V4SYS_${SYS_NAME} (0x${SYS_VALUE}) is outside the ${SYS_KIND} range\");\n"
+    )
+    if(PREV_NAME)
+      string(
+        APPEND
+        UNIQUE_ASSERTS
+        "static_assert(V4SYS_${PREV_NAME} < V4SYS_${SYS_NAME},
+              \"V4SYS_${PREV_NAME} and V4SYS_${SYS_NAME} share an ID\");\n"
+      )
+    endif()
+
+    # Name/description string pools: NUL-separated, indexed by offset
+    set(SYS_DESC "${META_DESC_${SYS_NAME}}")
+    string(APPEND NAME_POOL "    \"${SYS_NAME}\\0\"\n")
+    string(APPEND NAME_OFFSETS "    ${NAME_OFFSET},\n")
+    string(LENGTH "${SYS_NAME}" STR_LEN)
+    math(EXPR NAME_OFFSET "${NAME_OFFSET} + ${STR_LEN} + 1")
+    string(APPEND DESC_POOL "    \"${SYS_DESC}\\0\"\n")
+    string(APPEND DESC_OFFSETS "    ${DESC_OFFSET},\n")
+    string(LENGTH "${SYS_DESC}" STR_LEN)
+    math(EXPR DESC_OFFSET "${DESC_OFFSET} + ${STR_LEN} + 1")
+
+    set(PREV_NAME ${SYS_NAME})
+    math(EXPR ORDINAL "${ORDINAL} + 1")
+  endforeach()
+
+  set(META_CONTENT
+      "/**
+ * @file sys_meta_table.h
+ * @brief V4-std SYS call metadata table (auto-generated)
+ *
+ * THIS FILE IS AUTO-GENERATED FROM v4sys_ids.def
+ * DO NOT EDIT MANUALLY! Include v4std/sys_meta.hpp instead.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_SYS_META_TABLE_H
+#define V4STD_SYS_META_TABLE_H
+
+#include \"v4std/ddt_types.h\"
+#include \"v4std/sys_ids.h\"
+
+namespace v4std {
+
+/** @brief All SYS IDs in ascending order */
+inline constexpr uint16_t sys_ids_sorted[] = {
+${SORTED_IDS}};
+
+/** @brief Number of defined SYS IDs */
+inline constexpr size_t sys_id_count =
+    sizeof(sys_ids_sorted) / sizeof(sys_ids_sorted[0]);
+
+/**
+ * @brief Dense ordinal of each SYS ID (0 .. sys_id_count - 1)
+ *
+ * Ordinals follow ascending ID order and index sys_meta_table directly.
+ */
+enum SysOrdinal : uint16_t {
+${ORDINALS}};
+
+/** @brief Metadata for every SYS call, indexed by SysOrdinal */
+inline constexpr SysMeta sys_meta_table[] = {
+${META_ROWS}};
+
+/** @brief Number of entries in sys_meta_table */
+inline constexpr size_t sys_meta_count =
+    sizeof(sys_meta_table) / sizeof(sys_meta_table[0]);
+
+// Uniqueness: sorted IDs must be strictly ascending
+${UNIQUE_ASSERTS}
+// Range ownership: each ID must lie in its device kind's range
+${RANGE_ASSERTS}
+#if V4STD_SYS_NAMES
+
+/** @brief NUL-separated SYS names, in ordinal order */
+inline constexpr char sys_name_pool[] =
+${NAME_POOL}    \"\";
+
+/** @brief Offset of each name in sys_name_pool, indexed by SysOrdinal */
+inline constexpr uint16_t sys_name_offsets[] = {
+${NAME_OFFSETS}};
+
+/** @brief NUL-separated SYS descriptions, in ordinal order */
+inline constexpr char sys_description_pool[] =
+${DESC_POOL}    \"\";
+
+/** @brief Offset of each description, indexed by SysOrdinal */
+inline constexpr uint16_t sys_description_offsets[] = {
+${DESC_OFFSETS}};
+
+#endif // V4STD_SYS_NAMES
+
+} // namespace v4std
+
+#endif // V4STD_SYS_META_TABLE_H
+")
+
+  file(WRITE "${META_OUTPUT_FILE}" "${META_CONTENT}")
+
+  message(STATUS "Generated ${META_OUTPUT_FILE} from ${INPUT_FILE}")
+endif()
+
+# ============================================================================
+# Forth word library
+# ============================================================================
+
+if(FTH_OUTPUT_FILE)
+  set(FTH_CONTENT
+      "\\ v4std_sys.fth - V4-std SYS call words (auto-generated)
+\\
+\\ THIS FILE IS AUTO-GENERATED FROM v4sys_ids.def
+\\ DO NOT EDIT MANUALLY!
+\\
+\\ One word per SYS call. Each word pushes its SYS ID as a literal, so the
+\\ compiler emits a direct SYS opcode with no runtime name resolution.
+\\
+\\ Copyright 2025 V4 Project
+\\ Dual-licensed under MIT or Apache-2.0
+
+${FTH_WORDS}")
+  string(REGEX REPLACE "\n\n$" "\n" FTH_CONTENT "${FTH_CONTENT}")
+
+  file(WRITE "${FTH_OUTPUT_FILE}" "${FTH_CONTENT}")
+
+  message(STATUS "Generated ${FTH_OUTPUT_FILE} from ${INPUT_FILE}")
+endif()
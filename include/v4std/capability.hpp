@@ -0,0 +1,73 @@
+/**
+ * @file capability.hpp
+ * @brief Capability SYS call implementations
+ *
+ * Lets VM code discover the devices described by the DDT: count them by
+ * kind, probe a (kind, role, index) key, read its flags and handle, and
+ * enumerate a kind/role group into VM memory.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_CAPABILITY_HPP
+#define V4STD_CAPABILITY_HPP
+
+#include "v4std/span.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace v4std {
+
+/**
+ * @brief Set the VM memory V4SYS_CAP_ENUM writes into
+ *
+ * Addresses passed to V4SYS_CAP_ENUM are byte offsets into this region.
+ * The memory must remain valid while the handlers are registered.
+ *
+ * @param memory VM data memory (empty to disable CAP_ENUM)
+ */
+void set_cap_memory(span<uint8_t> memory);
+
+/**
+ * @brief Register capability SYS call handlers
+ *
+ * Registers handlers for:
+ * - V4SYS_CAP_COUNT:  ( kind -- count )
+ * - V4SYS_CAP_EXISTS: ( kind role index -- exists )
+ * - V4SYS_CAP_FLAGS:  ( kind role index -- flags ), -1 if not found
+ * - V4SYS_CAP_HANDLE: ( kind role index -- handle ), -1 if not found
+ * - V4SYS_CAP_ENUM:   ( kind role max addr -- count )
+ *
+ * Kinds, roles and indices outside 0..255 match no device.
+ *
+ * CAP_ENUM copies the descriptors of Ddt::devices_of(kind, role), or of
+ * Ddt::devices_of(kind) if role is -1, to addr in the memory set with
+ * set_cap_memory(): at most max descriptors of sizeof(v4dev_desc_t)
+ * bytes each, in host byte order, sorted by (role, index). It returns
+ * the size of the whole group, which may exceed max, or -1 if no memory
+ * is set, the copy would not fit in it, or the installed table cannot be
+ * grouped (see Ddt::devices_of()). CAP_ENUM is a stack-cell
+ * handler; through invoke_sys_handler(), max and addr arrive packed into
+ * arg2 and are limited to 16 bits.
+ *
+ * Must be called after Ddt::set_provider().
+ */
+void register_cap_sys_handlers();
+
+// Handlers installed by register_cap_sys_handlers(), which the ROM dispatch
+// table (v4sys_handlers.def) refers to directly
+int32_t sys_cap_count(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                      int32_t arg2);
+int32_t sys_cap_exists(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                       int32_t arg2);
+int32_t sys_cap_flags(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                      int32_t arg2);
+int32_t sys_cap_handle(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                       int32_t arg2);
+void sys_cap_enum(uint16_t sys_id, const int32_t *in, size_t in_count,
+                  int32_t *out, size_t out_count);
+
+} // namespace v4std
+
+#endif // V4STD_CAPABILITY_HPP
@@ -0,0 +1,65 @@
+/**
+ * @file config.hpp
+ * @brief Build configuration macros
+ *
+ * Defaults for library-wide build modes. CMake sets these through
+ * target_compile_definitions(); other build systems can define them on
+ * the command line.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_CONFIG_HPP
+#define V4STD_CONFIG_HPP
+
+/**
+ * @brief Allocation-free mode
+ *
+ * When 1, every v4std container is fixed-capacity and no v4std API
+ * allocates after initialization. Capacities are set per subsystem
+ * (e.g., V4STD_MAX_SYS_HANDLERS).
+ */
+#ifndef V4STD_NO_HEAP
+#define V4STD_NO_HEAP 0
+#endif
+
+/**
+ * @brief Spin-wait step
+ *
+ * Called in every busy wait: for DDT readers and writers, device locks
+ * and device owners. On hosted systems it yields to the scheduler, since
+ * waiting threads may share a core with the one they wait for; elsewhere
+ * it is the CPU's spin-wait hint (pause on x86, yield on Arm), or
+ * nothing. RTOS builds can define it as the kernel's yield (e.g.,
+ * `taskYIELD()`).
+ */
+#ifndef V4STD_CPU_RELAX
+#if defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#define V4STD_CPU_RELAX() sched_yield()
+#elif defined(_WIN32)
+#include <thread>
+#define V4STD_CPU_RELAX() std::this_thread::yield()
+#elif defined(__x86_64__) || defined(__i386__)
+#define V4STD_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+#define V4STD_CPU_RELAX() __asm__ volatile("yield")
+#else
+#define V4STD_CPU_RELAX() ((void)0)
+#endif
+#endif
+
+/**
+ * @brief Storage class of per-thread state
+ *
+ * The DDT keeps each thread's read guard depth and reader slot, and
+ * DeviceOwner its bound owner, in variables of this storage class.
+ * Targets without thread-local storage may define it empty if a single
+ * thread makes SYS calls and queries the DDT.
+ */
+#ifndef V4STD_THREAD_LOCAL
+#define V4STD_THREAD_LOCAL thread_local
+#endif
+
+#endif // V4STD_CONFIG_HPP
@@ -15,9 +15,202 @@
 #include "v4std/ddt_types.h"
 #include "v4std/span.hpp"
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Capacity of the merged device index and the SoA mirror
+ *
+ * Bounds the total number of descriptors across installed providers when
+ * more than one is installed (a single larger provider is served from
+ * its own order or a 16-bit position index in the same memory, and
+ * searched linearly if neither fits). Set with the CMake cache variable
+ * of the same name.
+ */
+#ifndef V4STD_DDT_MAX_DEVICES
+#define V4STD_DDT_MAX_DEVICES 256
+#endif
+
+/**
+ * @brief Build a merged index over all installed providers
+ *
+ * When 0, the index and its build scratch (two pointers and a rank per
+ * V4STD_DDT_MAX_DEVICES slot) are compiled out. Only one provider can
+ * then be installed; it is searched with its own lookup() if it has one,
+ * otherwise linearly. Set with the CMake option of the same name.
+ */
+#ifndef V4STD_DDT_MERGED_INDEX
+#define V4STD_DDT_MERGED_INDEX 1
+#endif
+
+/**
+ * @brief Maximum number of providers installed at once
+ *
+ * Set with the CMake cache variable of the same name.
+ */
+#ifndef V4STD_DDT_MAX_PROVIDERS
+#define V4STD_DDT_MAX_PROVIDERS 4
+#endif
+
+/**
+ * @brief Number of concurrent DDT readers tracked individually
+ *
+ * Each thread inside a Ddt::ReadGuard occupies one slot. Readers beyond
+ * this share a single overflow counter, which set_provider() must see
+ * drain to zero. Set with the CMake cache variable of the same name.
+ */
+#ifndef V4STD_DDT_READER_SLOTS
+#define V4STD_DDT_READER_SLOTS 16
+#endif
+
+/**
+ * @brief Keep a structure-of-arrays mirror of the installed devices
+ *
+ * When 1, every provider change also copies the devices into separate
+ * cache-line aligned kind, role, index, flags and handle arrays, which
+ * Ddt::count_matching() and Ddt::select_matching() scan instead of whole
+ * descriptors (vectorized by the compiler). Costs 16 bytes per
+ * V4STD_DDT_MAX_DEVICES slot. Set with the CMake option of the same name.
+ */
+#ifndef V4STD_DDT_SOA
+#define V4STD_DDT_SOA 0
+#endif
+
+/**
+ * @brief Use the 4-byte descriptor layout
+ *
+ * When 1, providers serve and Ddt returns v4dev_desc_compact_t instead
+ * of v4dev_desc_t (see DeviceDesc), halving descriptor tables; handles
+ * are then limited to 8 bits, roles and flags to 4. Set with the CMake
+ * option of the same name.
+ */
+#ifndef V4STD_DDT_COMPACT
+#define V4STD_DDT_COMPACT 0
+#endif
 
 namespace v4std {
 
+// ============================================================================
+// Descriptor Layout
+// ============================================================================
+
+/**
+ * @brief Field limits of a descriptor layout
+ */
+template <typename Desc> struct DeviceDescTraits;
+
+template <> struct DeviceDescTraits<v4dev_desc_t> {
+  static constexpr uint32_t max_role = 0xFF;
+  static constexpr uint32_t max_flags = 0xFF;
+  static constexpr uint32_t max_handle = 0xFFFFFFFFu;
+};
+
+template <> struct DeviceDescTraits<v4dev_desc_compact_t> {
+  static constexpr uint32_t max_role = 0x0F;
+  static constexpr uint32_t max_flags = 0x0F;
+  static constexpr uint32_t max_handle = 0xFF;
+};
+
+namespace detail {
+
+// Not constexpr: reaching it during constant evaluation is a compile error
+inline void compact_field_out_of_range() {}
+
+template <typename Field>
+constexpr Field checked_compact_field(Field value, uint32_t max) {
+  return value <= max ? value : (compact_field_out_of_range(), value);
+}
+
+} // namespace detail
+
+/**
+ * @brief v4dev_desc_compact_t built from the fields of v4dev_desc_t
+ *
+ * Adds only a constructor, so tables read {kind, role, index, flags,
+ * handle} in either layout; size and layout are those of the C struct.
+ * A constexpr table with a role, flags or handle past the compact limits
+ * fails to compile; at run time the fields are truncated, so check
+ * desc_fits() first.
+ */
+struct CompactDeviceDesc : v4dev_desc_compact_t {
+  CompactDeviceDesc() = default;
+  constexpr CompactDeviceDesc(uint8_t kind, uint8_t role, uint8_t index = 0,
+                              uint8_t flags = 0, uint32_t handle = 0)
+      : v4dev_desc_compact_t{
+            kind,
+            V4DEV_COMPACT_ROLE_FLAGS(
+                detail::checked_compact_field(role, 0x0F),
+                detail::checked_compact_field(flags, 0x0F)),
+            index,
+            static_cast<uint8_t>(
+                detail::checked_compact_field(handle, 0xFF))} {}
+};
+
+static_assert(sizeof(CompactDeviceDesc) == sizeof(v4dev_desc_compact_t) &&
+                  std::is_trivially_copyable_v<CompactDeviceDesc>,
+              "CompactDeviceDesc must keep the C layout");
+
+template <>
+struct DeviceDescTraits<CompactDeviceDesc>
+    : DeviceDescTraits<v4dev_desc_compact_t> {};
+
+/**
+ * @brief Descriptor layout of this build (see V4STD_DDT_COMPACT)
+ *
+ * Providers, DeviceList and every Ddt query use this type. Code that
+ * reads kind, index and handle as fields, and role and flags through
+ * desc_role() and desc_flags(), works with either layout.
+ */
+#if V4STD_DDT_COMPACT
+using DeviceDesc = CompactDeviceDesc;
+#else
+using DeviceDesc = v4dev_desc_t;
+#endif
+
+/** @brief Role of a descriptor of either layout */
+constexpr uint8_t desc_role(const v4dev_desc_t &desc) { return desc.role; }
+constexpr uint8_t desc_role(const v4dev_desc_compact_t &desc) {
+  return V4DEV_COMPACT_ROLE(desc);
+}
+
+/** @brief Flags of a descriptor of either layout */
+constexpr uint8_t desc_flags(const v4dev_desc_t &desc) { return desc.flags; }
+constexpr uint8_t desc_flags(const v4dev_desc_compact_t &desc) {
+  return V4DEV_COMPACT_FLAGS(desc);
+}
+
+/**
+ * @brief true if a descriptor's fields fit layout Desc
+ */
+template <typename Desc = DeviceDesc>
+constexpr bool desc_fits(const v4dev_desc_t &desc) {
+  using Traits = DeviceDescTraits<Desc>;
+  return desc.role <= Traits::max_role && desc.flags <= Traits::max_flags &&
+         desc.handle <= Traits::max_handle;
+}
+
+/**
+ * @brief Convert a descriptor to layout Desc (truncates unless
+ *        desc_fits<Desc>(desc))
+ */
+template <typename Desc = DeviceDesc>
+constexpr Desc make_desc(const v4dev_desc_t &desc) {
+  if constexpr (std::is_same_v<Desc, v4dev_desc_t>) {
+    return desc;
+  } else {
+    return Desc{CompactDeviceDesc{desc.kind, desc.role, desc.index,
+                                  desc.flags, desc.handle}};
+  }
+}
+
+/**
+ * @brief C ABI form of a descriptor of either layout
+ */
+template <typename Desc> constexpr v4dev_desc_t to_c_desc(const Desc &desc) {
+  return v4dev_desc_t{desc.kind, desc_role(desc), desc.index,
+                      desc_flags(desc), desc.handle};
+}
+
 /**
  * @brief DDT provider interface
  *
@@ -28,9 +221,9 @@ namespace v4std {
  * @code
  * class Esp32c6DdtProvider : public DdtProvider {
  * public:
- *   std::span<const v4dev_desc_t> get_devices() const override {
- *     static constexpr v4dev_desc_t devices[] = { ... };
- *     return std::span{devices};
+ *   span<const DeviceDesc> get_devices() const override {
+ *     static constexpr DeviceDesc devices[] = { ... };
+ *     return span{devices};
  *   }
  * };
  * @endcode
@@ -43,39 +236,337 @@ public:
    * @brief Get device table
    * @return Span of device descriptors
    */
-  virtual span<const v4dev_desc_t> get_devices() const = 0;
+  virtual span<const DeviceDesc> get_devices() const = 0;
+
+  /**
+   * @brief true if the provider answers lookups itself
+   *
+   * Providers that ship a prebuilt index (e.g., MappedDdtProvider)
+   * return true. When such a provider is installed alone, Ddt calls
+   * lookup() instead of building its own index.
+   */
+  virtual bool has_lookup() const { return false; }
+
+  /**
+   * @brief Provider-side lookup (used only if has_lookup())
+   *
+   * @return Descriptor from get_devices(), or nullptr if not found
+   */
+  virtual const DeviceDesc *lookup(v4dev_kind_t kind, v4dev_role_t role,
+                                   uint8_t index) const {
+    (void)kind;
+    (void)role;
+    (void)index;
+    return nullptr;
+  }
+
+  /**
+   * @brief Provider-side index (used only if has_lookup())
+   *
+   * Positions in get_devices() sorted by (kind, role, index), one per
+   * key, as found by lookup(). Lets Ddt::devices_of() return a group
+   * without building an index of its own. May be empty, in which case
+   * Ddt groups the table as it would for a provider without lookup().
+   */
+  virtual span<const uint16_t> sorted_index() const { return {}; }
+
+  /**
+   * @brief Extended attributes (optional)
+   *
+   * Slot i describes get_devices()[i]; the table may be shorter than the
+   * device table, and records with kind V4DEV_NONE mean "no attributes".
+   * See ddt_attr.hpp.
+   */
+  virtual span<const v4dev_attr_t> get_attributes() const { return {}; }
+};
+
+/**
+ * @brief Read-only view of the installed device descriptors
+ *
+ * Iterates the provider's own table when a single provider is installed,
+ * or the merged index when several are; descriptors are never copied.
+ * Groups from Ddt::devices_of() are a contiguous run of an index, either
+ * the merged one or the provider's own (positions into its table).
+ * Valid under the same conditions as other Ddt query results.
+ */
+class DeviceList {
+public:
+  class iterator {
+  public:
+    iterator(const DeviceList *list, size_t pos) : list_(list), pos_(pos) {}
+
+    const DeviceDesc &operator*() const { return (*list_)[pos_]; }
+    const DeviceDesc *operator->() const { return &(*list_)[pos_]; }
+    iterator &operator++() {
+      ++pos_;
+      return *this;
+    }
+    bool operator==(const iterator &other) const { return pos_ == other.pos_; }
+    bool operator!=(const iterator &other) const { return pos_ != other.pos_; }
+
+  private:
+    const DeviceList *list_;
+    size_t pos_;
+  };
+
+  DeviceList() = default;
+  explicit DeviceList(span<const DeviceDesc> table)
+      : table_(table.data()), size_(table.size()) {}
+  DeviceList(const DeviceDesc *const *index, size_t size)
+      : index_(index), size_(size) {}
+  DeviceList(const DeviceDesc *table, const uint16_t *positions, size_t size)
+      : table_(table), positions_(positions), size_(size) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const DeviceDesc &operator[](size_t pos) const {
+    if (positions_) {
+      return table_[positions_[pos]];
+    }
+    return table_ ? table_[pos] : *index_[pos];
+  }
+
+  iterator begin() const { return iterator{this, 0}; }
+  iterator end() const { return iterator{this, size_}; }
+
+  /**
+   * @brief Contiguous part of this list
+   *
+   * @param offset First position (at most size())
+   * @param count Number of entries (at most size() - offset)
+   */
+  DeviceList sublist(size_t offset, size_t count) const {
+    DeviceList list = *this;
+    if (positions_) {
+      list.positions_ += offset;
+    } else if (table_) {
+      list.table_ += offset;
+    } else {
+      list.index_ += offset;
+    }
+    list.size_ = count;
+    return list;
+  }
+
+  /**
+   * @brief Position of a descriptor in this list
+   *
+   * @param desc Descriptor from a Ddt query
+   * @param position Receives its position
+   * @return false if desc is not in the list
+   */
+  bool position_of(const DeviceDesc *desc, size_t &position) const;
+
+private:
+  const DeviceDesc *table_ = nullptr;
+  const DeviceDesc *const *index_ = nullptr;
+  const uint16_t *positions_ = nullptr;
+  size_t size_ = 0;
+};
+
+/**
+ * @brief Cached device lookup that can detect a stale table
+ *
+ * Obtained from Ddt::find_token() and checked with Ddt::resolve(). A
+ * token stays valid until the provider is replaced.
+ */
+struct DeviceToken {
+  const DeviceDesc *desc = nullptr;
+  uint32_t generation = 0;
+};
+
+/**
+ * @brief Field predicate for bulk device queries
+ *
+ * A device matches if every field equals the query's value in the bits
+ * of its mask; fields with a zero mask are ignored, so a default query
+ * matches everything.
+ *
+ * Example:
+ * @code
+ * auto query = DeviceQuery{}.with_kind(V4DEV_LED).with_flags(
+ *     V4DEV_FLAG_ACTIVE_LOW, V4DEV_FLAG_ACTIVE_LOW);
+ * size_t active_low_leds = Ddt::count_matching(query);
+ * @endcode
+ */
+struct DeviceQuery {
+  uint8_t kind = 0;
+  uint8_t kind_mask = 0;
+  uint8_t role = 0;
+  uint8_t role_mask = 0;
+  uint8_t index = 0;
+  uint8_t index_mask = 0;
+  uint8_t flags = 0;
+  uint8_t flags_mask = 0;
+  uint32_t handle = 0;
+  uint32_t handle_mask = 0;
+
+  DeviceQuery &with_kind(v4dev_kind_t value) {
+    kind = static_cast<uint8_t>(value);
+    kind_mask = 0xFF;
+    return *this;
+  }
+
+  DeviceQuery &with_role(v4dev_role_t value) {
+    role = static_cast<uint8_t>(value);
+    role_mask = 0xFF;
+    return *this;
+  }
+
+  DeviceQuery &with_index(uint8_t value) {
+    index = value;
+    index_mask = 0xFF;
+    return *this;
+  }
+
+  /** @brief Match flags whose bits in mask equal value */
+  DeviceQuery &with_flags(uint8_t mask, uint8_t value) {
+    flags = value;
+    flags_mask = mask;
+    return *this;
+  }
+
+  DeviceQuery &with_handle(uint32_t value) {
+    handle = value;
+    handle_mask = 0xFFFFFFFFu;
+    return *this;
+  }
+
+  /** @brief true if desc matches */
+  bool matches(const DeviceDesc &desc) const {
+    return ((desc.kind ^ kind) & kind_mask) == 0 &&
+           ((desc_role(desc) ^ role) & role_mask) == 0 &&
+           ((desc.index ^ index) & index_mask) == 0 &&
+           ((desc_flags(desc) ^ flags) & flags_mask) == 0 &&
+           ((desc.handle ^ handle) & handle_mask) == 0;
+  }
 };
 
 /**
  * @brief DDT search and management
  *
  * Static class providing device search and enumeration.
- * Thread-safe for const operations after set_provider().
+ *
+ * Several providers can be installed at once (e.g., a static on-chip
+ * table plus discovered expansion modules). Their tables are merged into
+ * one index sorted by (kind, role, index) whenever a provider is added or
+ * removed; lookups are binary searches. When two providers describe the
+ * same (kind, role, index), the one with the higher priority wins, then
+ * the one added first. Within one table the first entry wins.
+ *
+ * The provider can be replaced at runtime (e.g., on USB hot-plug) while
+ * other threads query the table. Publication is RCU-style: set_provider()
+ * atomically swaps in a new snapshot, then waits for a grace period in
+ * which every reader that could still see the old provider has left its
+ * Ddt::ReadGuard (epoch-based reclamation). Readers never block or retry.
+ *
+ * Descriptors and spans returned by queries point into the provider's
+ * table. Hold a ReadGuard while using them if the provider may be
+ * replaced concurrently; SYS dispatch already runs handlers under one.
  */
 class Ddt {
 public:
   /**
-   * @brief Set DDT provider
+   * @brief RAII read-side critical section
+   *
+   * While a guard is alive on the calling thread, the provider that was
+   * current when it was entered (and any later one) stays valid. Entering
+   * and leaving are wait-free, and guards nest.
+   */
+  class ReadGuard {
+  public:
+    ReadGuard() { Ddt::read_lock(); }
+    ~ReadGuard() { Ddt::read_unlock(); }
+
+    ReadGuard(const ReadGuard &) = delete;
+    ReadGuard &operator=(const ReadGuard &) = delete;
+  };
+
+  /** @brief true if the calling thread holds a ReadGuard */
+  static bool in_read_section();
+
+  /**
+   * @brief Set or replace the DDT provider
+   *
+   * Replaces all installed providers with this one. Publishes the new
+   * table atomically, bumps generation(), and returns once no reader can
+   * still be using the previous providers, so the caller may then destroy
+   * them. Provider changes are serialized. None of the provider-changing
+   * calls may be made while the calling thread holds a ReadGuard.
    *
-   * Must be called once during initialization before any queries.
-   * The provider pointer must remain valid for the lifetime of the program.
+   * The provider's table must not change while it is installed.
    *
-   * @param provider Pointer to platform-specific provider (must not be null)
+   * @param provider Pointer to platform-specific provider (nullptr to
+   *                 remove the table)
    */
   static void set_provider(DdtProvider *provider);
 
+  /**
+   * @brief Install an additional provider
+   *
+   * Rebuilds the merged index; publication and reclamation work as for
+   * set_provider().
+   *
+   * @param provider Provider to add (must not be null or installed)
+   * @param priority Higher values win duplicate (kind, role, index) keys
+   * @return false if the provider is null or already installed, if
+   *         V4STD_DDT_MAX_PROVIDERS or V4STD_DDT_MAX_DEVICES would be
+   *         exceeded, or if it would be a second provider without
+   *         V4STD_DDT_MERGED_INDEX
+   */
+  static bool add_provider(DdtProvider *provider, int priority = 0);
+
+  /**
+   * @brief Uninstall a provider
+   *
+   * Returns once no reader can still be using its table.
+   *
+   * @return false if the provider is not installed
+   */
+  static bool remove_provider(DdtProvider *provider);
+
+  /** @brief Number of installed providers */
+  static size_t provider_count();
+
+  /**
+   * @brief Provider generation
+   *
+   * Starts at 0 and increments on every provider change.
+   */
+  static uint32_t generation();
+
+  /**
+   * @brief Find a device and remember the table generation
+   *
+   * @return Token whose desc is nullptr if the device was not found
+   */
+  static DeviceToken find_token(v4dev_kind_t kind, v4dev_role_t role,
+                                uint8_t index);
+
+  /**
+   * @brief Check a cached token against the current table
+   *
+   * @return token.desc, or nullptr if the provider has been replaced since
+   *         the token was created (look the device up again)
+   */
+  static const DeviceDesc *resolve(const DeviceToken &token);
+
   /**
    * @brief Find device by kind, role, and index
    *
-   * Searches for a device matching all three criteria.
+   * Searches for a device matching all three criteria. Each published
+   * snapshot records which (kind, role) groups have devices and their
+   * highest index, so probing for an absent device returns without a
+   * search.
    *
    * @param kind Device kind (e.g., V4DEV_LED)
    * @param role Device role (e.g., V4ROLE_STATUS)
    * @param index Index within kind/role combination (0-based)
    * @return Pointer to descriptor if found, nullptr otherwise
    */
-  static const v4dev_desc_t *find_device(v4dev_kind_t kind, v4dev_role_t role,
-                                         uint8_t index);
+  static const DeviceDesc *find_device(v4dev_kind_t kind, v4dev_role_t role,
+                                       uint8_t index);
 
   /**
    * @brief Find default device (index 0)
@@ -86,26 +577,110 @@ public:
    * @param role Device role
    * @return Pointer to descriptor if found, nullptr otherwise
    */
-  static const v4dev_desc_t *find_default_device(v4dev_kind_t kind,
-                                                 v4dev_role_t role);
+  static const DeviceDesc *find_default_device(v4dev_kind_t kind,
+                                               v4dev_role_t role);
 
   /**
    * @brief Count devices of a given kind
    *
+   * Entries of that kind in get_all_devices(), so repeated keys in one
+   * provider's table all count. O(log n) unless the table cannot be
+   * grouped (see devices_of()); then a linear scan.
+   *
    * @param kind Device kind to count
    * @return Number of devices of that kind
    */
   static size_t count_devices(v4dev_kind_t kind);
 
+  /**
+   * @brief All devices of a kind
+   *
+   * The entries of that kind in get_all_devices(), sorted by (role,
+   * index); a binary search for each end of the group, nothing is copied
+   * or scanned. Its size is count_devices(kind).
+   *
+   * A lone provider is grouped through its sorted_index(), its own table
+   * if that is in key order, or an index built when it is installed. Only
+   * an unsorted table too large for that index (more than
+   * V4STD_DDT_MAX_DEVICES pointers' worth of 16-bit positions, or any
+   * unsorted table without V4STD_DDT_MERGED_INDEX) cannot be grouped;
+   * devices_of() is then empty and try_devices_of() returns false.
+   *
+   * @param kind Device kind
+   * @return Contiguous view of the group
+   */
+  static DeviceList devices_of(v4dev_kind_t kind);
+
+  /**
+   * @brief All devices of a kind and role
+   *
+   * As devices_of(kind), restricted to one role and sorted by index.
+   */
+  static DeviceList devices_of(v4dev_kind_t kind, v4dev_role_t role);
+
+  /**
+   * @brief devices_of(), telling an empty group from one that cannot be
+   *        produced
+   *
+   * @param kind Device kind
+   * @param group Receives the group (empty on failure)
+   * @return false if the installed table cannot be grouped
+   */
+  static bool try_devices_of(v4dev_kind_t kind, DeviceList &group);
+
+  /** @brief devices_of(kind, role), as try_devices_of(kind, group) */
+  static bool try_devices_of(v4dev_kind_t kind, v4dev_role_t role,
+                             DeviceList &group);
+
+  /**
+   * @brief Count devices matching a query
+   *
+   * Scans every device; with V4STD_DDT_SOA the scan reads only the
+   * mirrored fields the query masks (tables larger than
+   * V4STD_DDT_MAX_DEVICES are scanned as descriptors).
+   *
+   * @param query Field predicate
+   * @return Number of matches in get_all_devices()
+   */
+  static size_t count_matching(const DeviceQuery &query);
+
+  /**
+   * @brief Find devices matching a query
+   *
+   * @param query Field predicate
+   * @param positions Receives positions in get_all_devices() of the first
+   *                  matches, in ascending order
+   * @return Total number of matches (may exceed positions.size())
+   */
+  static size_t select_matching(const DeviceQuery &query,
+                                span<uint32_t> positions);
+
+  /**
+   * @brief Extended attributes of a device
+   *
+   * Finds the provider whose table holds desc and returns the record in
+   * the same slot of its attribute table: no search over descriptors.
+   *
+   * @param desc Descriptor from a Ddt query (may be null)
+   * @return Attribute record, or nullptr if the device has none
+   */
+  static const v4dev_attr_t *find_attributes(const DeviceDesc *desc);
+
   /**
    * @brief Get all devices
    *
-   * @return Span of all device descriptors
+   * With one provider this is its table as-is. With several it is the
+   * merged index, sorted by (kind, role, index): a key that several
+   * providers define keeps only the entries of the highest-priority one.
+   * Counts and range queries see exactly these devices.
+   *
+   * @return View of all device descriptors
    */
-  static span<const v4dev_desc_t> get_all_devices();
+  static DeviceList get_all_devices();
 
 private:
-  static DdtProvider *provider_;
+  static void read_lock();
+  static void read_unlock();
 };
 
 } // namespace v4std
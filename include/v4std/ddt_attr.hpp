@@ -0,0 +1,186 @@
+/**
+ * @file ddt_attr.hpp
+ * @brief Typed access to extended device attributes
+ *
+ * Descriptors stay small (8 bytes, 4 with V4STD_DDT_COMPACT) so tables
+ * remain cache-dense; configuration such as I2C addresses, baud rates,
+ * ADC calibration and display geometry lives in a v4dev_attr_t side
+ * table with the same slots as the descriptor table.
+ * Ddt::find_attributes() maps a descriptor to its record in O(1); the
+ * helpers here pack and unpack the payload.
+ *
+ * Example:
+ * @code
+ * static constexpr DeviceDesc devices[] = {
+ *     {V4DEV_I2C, V4ROLE_USER, 0, 0, 0},
+ *     {V4DEV_UART, V4ROLE_CONSOLE, 0, 0, 0},
+ * };
+ * static constexpr v4dev_attr_t attributes[] = {
+ *     make_attr(I2cAttr{0x3C, 400000}),
+ *     make_attr(UartAttr{115200, 8, 0, 1}),
+ * };
+ *
+ * // In the provider:
+ * span<const v4dev_attr_t> get_attributes() const override {
+ *   return span{attributes};
+ * }
+ *
+ * // In a driver:
+ * I2cAttr i2c;
+ * if (get_device_attr(Ddt::find_device(V4DEV_I2C, V4ROLE_USER, 0), i2c)) {
+ *   bus.set_speed(i2c.speed_hz);
+ * }
+ * @endcode
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_DDT_ATTR_HPP
+#define V4STD_DDT_ATTR_HPP
+
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_types.h"
+#include <cstdint>
+
+namespace v4std {
+
+/** @brief I2C device attributes */
+struct I2cAttr {
+  uint16_t address;  /**< 7- or 10-bit target address */
+  uint32_t speed_hz; /**< Bus speed */
+};
+
+/** @brief UART attributes */
+struct UartAttr {
+  uint32_t baud;
+  uint8_t data_bits;
+  uint8_t parity; /**< 0 = none, 1 = odd, 2 = even */
+  uint8_t stop_bits;
+};
+
+/** @brief ADC calibration */
+struct AdcAttr {
+  int16_t offset;          /**< Added to raw counts */
+  uint16_t gain_q12;       /**< Gain in Q4.12 (4096 = 1.0) */
+  uint16_t vref_mv;        /**< Reference voltage */
+  uint8_t resolution_bits; /**< Converter resolution */
+
+  /** @brief Calibrated counts: (raw + offset) * gain */
+  constexpr int32_t apply(int32_t raw) const {
+    return static_cast<int32_t>(
+        (static_cast<int64_t>(raw + offset) * gain_q12) / 4096);
+  }
+};
+
+/** @brief Display geometry */
+struct DisplayAttr {
+  uint16_t width;
+  uint16_t height;
+  uint8_t bpp;      /**< Bits per pixel */
+  uint8_t rotation; /**< Quarter turns clockwise (0-3) */
+};
+
+// ============================================================================
+// Packing
+// ============================================================================
+
+constexpr v4dev_attr_t make_attr(const I2cAttr &attr) {
+  return v4dev_attr_t{V4DEV_I2C, {0, 0, 0}, {attr.address, attr.speed_hz}};
+}
+
+constexpr v4dev_attr_t make_attr(const UartAttr &attr) {
+  return v4dev_attr_t{
+      V4DEV_UART,
+      {0, 0, 0},
+      {attr.baud, static_cast<uint32_t>(attr.data_bits) |
+                      (static_cast<uint32_t>(attr.parity) << 8) |
+                      (static_cast<uint32_t>(attr.stop_bits) << 16)}};
+}
+
+constexpr v4dev_attr_t make_attr(const AdcAttr &attr) {
+  return v4dev_attr_t{
+      V4DEV_ADC,
+      {0, 0, 0},
+      {static_cast<uint16_t>(attr.offset) |
+           (static_cast<uint32_t>(attr.gain_q12) << 16),
+       attr.vref_mv | (static_cast<uint32_t>(attr.resolution_bits) << 16)}};
+}
+
+constexpr v4dev_attr_t make_attr(const DisplayAttr &attr) {
+  return v4dev_attr_t{
+      V4DEV_DISPLAY,
+      {0, 0, 0},
+      {attr.width | (static_cast<uint32_t>(attr.height) << 16),
+       attr.bpp | (static_cast<uint32_t>(attr.rotation) << 8)}};
+}
+
+// ============================================================================
+// Unpacking
+// ============================================================================
+
+/**
+ * @brief Decode a record
+ *
+ * Overloaded for each attribute type.
+ *
+ * @return false if the record was not packed for that type
+ */
+constexpr bool decode_attr(const v4dev_attr_t &attr, I2cAttr &out) {
+  if (attr.kind != V4DEV_I2C) {
+    return false;
+  }
+  out.address = static_cast<uint16_t>(attr.data[0]);
+  out.speed_hz = attr.data[1];
+  return true;
+}
+
+constexpr bool decode_attr(const v4dev_attr_t &attr, UartAttr &out) {
+  if (attr.kind != V4DEV_UART) {
+    return false;
+  }
+  out.baud = attr.data[0];
+  out.data_bits = static_cast<uint8_t>(attr.data[1]);
+  out.parity = static_cast<uint8_t>(attr.data[1] >> 8);
+  out.stop_bits = static_cast<uint8_t>(attr.data[1] >> 16);
+  return true;
+}
+
+constexpr bool decode_attr(const v4dev_attr_t &attr, AdcAttr &out) {
+  if (attr.kind != V4DEV_ADC) {
+    return false;
+  }
+  out.offset = static_cast<int16_t>(static_cast<uint16_t>(attr.data[0]));
+  out.gain_q12 = static_cast<uint16_t>(attr.data[0] >> 16);
+  out.vref_mv = static_cast<uint16_t>(attr.data[1]);
+  out.resolution_bits = static_cast<uint8_t>(attr.data[1] >> 16);
+  return true;
+}
+
+constexpr bool decode_attr(const v4dev_attr_t &attr, DisplayAttr &out) {
+  if (attr.kind != V4DEV_DISPLAY) {
+    return false;
+  }
+  out.width = static_cast<uint16_t>(attr.data[0]);
+  out.height = static_cast<uint16_t>(attr.data[0] >> 16);
+  out.bpp = static_cast<uint8_t>(attr.data[1]);
+  out.rotation = static_cast<uint8_t>(attr.data[1] >> 8);
+  return true;
+}
+
+/**
+ * @brief Typed attributes of an installed device
+ *
+ * @param desc Descriptor from a Ddt query (may be null)
+ * @param out Receives the decoded attributes
+ * @return false if the device has no attributes of this type
+ */
+template <typename Attr>
+bool get_device_attr(const DeviceDesc *desc, Attr &out) {
+  const v4dev_attr_t *attr = Ddt::find_attributes(desc);
+  return attr && decode_attr(*attr, out);
+}
+
+} // namespace v4std
+
+#endif // V4STD_DDT_ATTR_HPP
@@ -0,0 +1,147 @@
+/**
+ * @file ddt_image.hpp
+ * @brief Binary DDT image format and a zero-copy provider for it
+ *
+ * A DDT image is a device table compiled ahead of time (see the
+ * v4ddt_compile host tool), so boards do not build tables in code at
+ * boot. Layout, in target byte order (little-endian on every supported
+ * target), all offsets from the start of the image:
+ *
+ * | Offset          | Size        | Content                            |
+ * |-----------------|-------------|------------------------------------|
+ * | 0               | 32          | DdtImageHeader                     |
+ * | devices_offset  | 8 or 4 each | DeviceDesc[device_count]           |
+ * | index_offset    | 2 * entries | uint16_t positions, sorted by key  |
+ *
+ * Keys (kind, role, index) are distinct. The index lists every
+ * descriptor once, in ascending key order. A checksum (FNV-1a) covers
+ * everything after the header.
+ *
+ * Descriptors use the build's layout: version 1 images hold 8-byte
+ * v4dev_desc_t records, version 2 images 4-byte v4dev_desc_compact_t
+ * records (V4STD_DDT_COMPACT): kind, role | flags << 4, index and handle
+ * bytes. A build writes and accepts only its own version, so
+ * v4ddt_compile must be built with the target's setting.
+ *
+ * MappedDdtProvider validates an image once and then serves it in place:
+ * from a flash address on MCUs, or from a file mapped with MappedDdtFile
+ * (linux/ddt_image_file.hpp) on Linux.
+ *
+ * Example:
+ * @code
+ * extern const uint8_t board_ddt[];      // Linked-in image
+ * extern const size_t board_ddt_size;
+ *
+ * static MappedDdtProvider provider;
+ * if (provider.attach(span<const uint8_t>{board_ddt, board_ddt_size})) {
+ *   Ddt::set_provider(&provider);
+ * }
+ * @endcode
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_DDT_IMAGE_HPP
+#define V4STD_DDT_IMAGE_HPP
+
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_types.h"
+#include "v4std/span.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace v4std {
+
+/** @brief Image format version written and accepted (see above) */
+static constexpr uint16_t kDdtImageVersion = V4STD_DDT_COMPACT ? 2 : 1;
+
+/** @brief Maximum descriptors in one image (index entries are 16-bit) */
+static constexpr size_t kDdtImageMaxDevices = 65535;
+
+/** @brief Alignment of an image and of its descriptor table */
+static constexpr size_t kDdtImageAlign = 4;
+
+/**
+ * @brief DDT image header (32 bytes)
+ */
+struct DdtImageHeader {
+  char magic[4];           /**< "V4DT" */
+  uint16_t version;        /**< kDdtImageVersion */
+  uint16_t header_size;    /**< sizeof(DdtImageHeader) */
+  uint32_t image_size;     /**< Total image size in bytes */
+  uint32_t device_count;   /**< Descriptors in the table */
+  uint32_t devices_offset; /**< Table offset (4-byte aligned) */
+  uint32_t index_count;    /**< Index entries (= device_count) */
+  uint32_t index_offset;   /**< Index offset (2-byte aligned) */
+  uint32_t checksum;       /**< FNV-1a of bytes [header_size, image_size) */
+};
+
+static_assert(sizeof(DdtImageHeader) == 32, "DDT image header is 32 bytes");
+static_assert(sizeof(DeviceDesc) == (V4STD_DDT_COMPACT ? 4 : 8),
+              "DDT image entries are 8 bytes, or 4 in compact builds");
+
+/**
+ * @brief Bytes needed for an image of a device table
+ */
+size_t ddt_image_size(span<const DeviceDesc> devices);
+
+/**
+ * @brief Compile a device table into an image
+ *
+ * @param devices Device table (order is kept)
+ * @param out Destination; must hold ddt_image_size(devices) bytes and be
+ *            2-byte aligned (4-byte aligned to be attached in place)
+ * @return Bytes written, or 0 if out is too small or misaligned, the
+ *         table too large, or a key repeated
+ */
+size_t build_ddt_image(span<const DeviceDesc> devices, span<uint8_t> out);
+
+/**
+ * @brief DdtProvider serving a validated image in place
+ *
+ * Lookups use the image's prebuilt index (binary search); nothing is
+ * copied. The image memory must stay valid and unchanged while attached.
+ */
+class MappedDdtProvider : public DdtProvider {
+public:
+  MappedDdtProvider() = default;
+
+  /**
+   * @brief Validate an image and serve it
+   *
+   * Checks the magic, version, sizes, offsets and alignment, that the
+   * index has one entry per descriptor, each in range and strictly
+   * ascending, and the checksum.
+   *
+   * @param image Image bytes (4-byte aligned)
+   * @return false if the image is invalid (the provider is then empty)
+   */
+  bool attach(span<const uint8_t> image);
+
+  /** @brief Stop serving the image */
+  void detach();
+
+  /** @brief true if an image is attached */
+  bool is_attached() const { return devices_.data() != nullptr; }
+
+  span<const DeviceDesc> get_devices() const override { return devices_; }
+
+  bool has_lookup() const override { return true; }
+
+  const DeviceDesc *lookup(v4dev_kind_t kind, v4dev_role_t role,
+                           uint8_t index) const override;
+
+  span<const uint16_t> sorted_index() const override {
+    return span<const uint16_t>{index_, index_count_};
+  }
+
+private:
+  span<const DeviceDesc> devices_;
+  const uint16_t *index_ = nullptr;
+  size_t index_count_ = 0;
+};
+
+} // namespace v4std
+
+#endif // V4STD_DDT_IMAGE_HPP
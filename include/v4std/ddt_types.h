@@ -75,6 +75,60 @@ typedef struct {
   uint32_t handle; /**< Platform-specific handle (GPIO pin, pointer, etc.) */
 } v4dev_desc_t;
 
+/**
+ * @brief Compact device descriptor (4 bytes, POD type)
+ *
+ * The fields of v4dev_desc_t narrowed for parts where descriptor memory
+ * matters: roles and flags below 16, handles below 256 (a GPIO number,
+ * or a slot in a board's own handle table). Used instead of v4dev_desc_t
+ * by builds with V4STD_DDT_COMPACT.
+ *
+ * Every field is a whole byte, so the layout is the same with every
+ * compiler. Role and flags share one byte; build and read it with the
+ * V4DEV_COMPACT_* macros below.
+ */
+typedef struct {
+  uint8_t kind;       /**< Device type (v4dev_kind_t) */
+  uint8_t role_flags; /**< Role in bits 0-3, flags in bits 4-7 */
+  uint8_t index;      /**< Index within kind/role combination (0-based) */
+  uint8_t handle;     /**< Platform-specific handle */
+} v4dev_desc_compact_t;
+
+/** @brief role_flags byte of a compact descriptor */
+#define V4DEV_COMPACT_ROLE_FLAGS(role, flags)                                  \
+  ((uint8_t)(((role) & 0x0F) | (((flags) & 0x0F) << 4)))
+
+/** @brief Role of a compact descriptor */
+#define V4DEV_COMPACT_ROLE(desc) ((uint8_t)((desc).role_flags & 0x0F))
+
+/** @brief Flags of a compact descriptor */
+#define V4DEV_COMPACT_FLAGS(desc) ((uint8_t)((desc).role_flags >> 4))
+
+/**
+ * @brief Extended device attributes (12 bytes, POD type)
+ *
+ * Configuration that does not fit the hot descriptor. Providers may
+ * return a table of these parallel to their descriptor table (same slot,
+ * see DdtProvider::get_attributes()), so static tables stay in read-only
+ * data. The payload layout depends on kind:
+ *
+ * - V4DEV_I2C:     data[0] = address, data[1] = bus speed in Hz
+ * - V4DEV_UART:    data[0] = baud rate,
+ *                  data[1] = data bits | parity << 8 | stop bits << 16
+ *                  (parity: 0 = none, 1 = odd, 2 = even)
+ * - V4DEV_ADC:     data[0] = (uint16_t)offset | gain << 16 (Q4.12),
+ *                  data[1] = reference mV | resolution bits << 16
+ * - V4DEV_DISPLAY: data[0] = width | height << 16,
+ *                  data[1] = bits per pixel | rotation << 8 (degrees / 90)
+ *
+ * C++ code should build and read them through ddt_attr.hpp.
+ */
+typedef struct {
+  uint8_t kind;        /**< Payload layout (v4dev_kind_t); NONE = unset */
+  uint8_t reserved[3]; /**< Zero */
+  uint32_t data[2];    /**< Kind-specific payload */
+} v4dev_attr_t;
+
 #ifdef __cplusplus
 }
 #endif
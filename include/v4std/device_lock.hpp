@@ -0,0 +1,109 @@
+/**
+ * @file device_lock.hpp
+ * @brief Per-device spinlocks for concurrent VM threads
+ *
+ * Each device, identified by its (kind, role, index) key, maps to one of
+ * V4STD_DDT_LOCK_SLOTS spinlocks kept in a side array, so SYS calls on
+ * different devices run in parallel while calls on the same device are
+ * serialized. The slot does not depend on where the device sits in the
+ * DDT, so threads still reading an older DDT during a provider hot-swap
+ * take the same lock as threads on the new one. With more devices than
+ * lock slots, keys share slots (lock striping).
+ *
+ * Handlers opt in at registration with V4SYS_HANDLER_DEVICE_LOCK; the
+ * dispatcher then resolves the call's device and holds its lock for the
+ * duration of the handler.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_DEVICE_LOCK_HPP
+#define V4STD_DEVICE_LOCK_HPP
+
+#include "v4std/ddt.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Number of device lock slots
+ *
+ * Set with the CMake cache variable of the same name. Each slot occupies
+ * one V4STD_CACHE_LINE_SIZE block.
+ */
+#ifndef V4STD_DDT_LOCK_SLOTS
+#define V4STD_DDT_LOCK_SLOTS 32
+#endif
+
+/**
+ * @brief Cache line size used to pad lock and DDT reader slots
+ *
+ * Parts without a data cache can set it to 8 (the smallest that keeps
+ * the slots' atomics aligned). Set with the CMake cache variable of the
+ * same name.
+ */
+#ifndef V4STD_CACHE_LINE_SIZE
+#define V4STD_CACHE_LINE_SIZE 64
+#endif
+
+namespace v4std {
+
+/**
+ * @brief Spinlocks indexed by device key
+ *
+ * Spinlocks are test-and-test-and-set and not reentrant: a handler that
+ * holds a device lock must not make a nested SYS call on a device that
+ * maps to the same slot.
+ */
+class DeviceLocks {
+public:
+  /** @brief Key of a device, the same in every DDT snapshot */
+  static constexpr uint32_t key_of(v4dev_kind_t kind, v4dev_role_t role,
+                                   uint8_t index) {
+    return (static_cast<uint32_t>(kind) << 16) |
+           (static_cast<uint32_t>(role) << 8) | index;
+  }
+
+  /**
+   * @brief Lock slot used by a device key
+   *
+   * Folding the kind and role into the index keeps consecutive indices of
+   * one kind/role in different slots.
+   */
+  static constexpr size_t slot_of(uint32_t key) {
+    return (key ^ (key >> 8) ^ (key >> 16)) % V4STD_DDT_LOCK_SLOTS;
+  }
+
+  /** @brief Number of lock slots */
+  static constexpr size_t slot_count() { return V4STD_DDT_LOCK_SLOTS; }
+
+  /** @brief Spin until the device's slot is acquired */
+  static void lock(uint32_t key);
+
+  /** @brief Acquire the device's slot if it is free */
+  static bool try_lock(uint32_t key);
+
+  /** @brief Release the device's slot */
+  static void unlock(uint32_t key);
+};
+
+/**
+ * @brief RAII guard for one device lock
+ */
+class DeviceLockGuard {
+public:
+  explicit DeviceLockGuard(uint32_t key) : key_(key) {
+    DeviceLocks::lock(key_);
+  }
+  ~DeviceLockGuard() { DeviceLocks::unlock(key_); }
+
+  DeviceLockGuard(const DeviceLockGuard &) = delete;
+  DeviceLockGuard &operator=(const DeviceLockGuard &) = delete;
+
+private:
+  uint32_t key_;
+};
+
+} // namespace v4std
+
+#endif // V4STD_DEVICE_LOCK_HPP
@@ -0,0 +1,201 @@
+/**
+ * @file device_owner.hpp
+ * @brief Device ownership: pin hot devices to one owner thread
+ *
+ * A device, named by kind, role and index, can be pinned to a DeviceOwner.
+ * SYS calls on that device from any other thread are forwarded through
+ * the owner's bounded lock-free MPSC command queue and executed by the
+ * owner thread, which drains the queue in batches. Contended HAL access
+ * (console UART, status LED) becomes single-writer access that stays in
+ * one core's cache.
+ *
+ * Pins name the device rather than its DDT slot, so they stay with it
+ * when a provider change moves it to another slot.
+ *
+ * Ownership applies to handlers registered with V4SYS_HANDLER_DEVICE_LOCK
+ * (the flag marks handlers that address a kind/role/index device).
+ * Forwarding is synchronous: the calling thread waits for the result.
+ * The dispatcher leaves its Ddt::ReadGuard before waiting, so an owner
+ * thread may replace the DDT provider while calls to it are pending.
+ *
+ * Example:
+ * @code
+ * static DeviceOwner console_owner;
+ *
+ * // Owner thread
+ * console_owner.bind_current_thread();
+ * set_device_owner(V4DEV_UART, V4ROLE_CONSOLE, 0, &console_owner);
+ * for (;;) {
+ *   console_owner.drain();
+ *   run_vm_slice();
+ * }
+ * @endcode
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_DEVICE_OWNER_HPP
+#define V4STD_DEVICE_OWNER_HPP
+
+#include "v4std/ddt.hpp"
+#include "v4std/device_lock.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Command queue capacity per owner (power of two)
+ */
+#ifndef V4STD_OWNER_QUEUE_SIZE
+#define V4STD_OWNER_QUEUE_SIZE 64
+#endif
+
+/**
+ * @brief Devices that can be pinned to owners at once
+ *
+ * 0 compiles the owner table out: set_device_owner() then only accepts
+ * nullptr and no call is forwarded. Set with the CMake cache variable of
+ * the same name.
+ */
+#ifndef V4STD_MAX_DEVICE_OWNERS
+#define V4STD_MAX_DEVICE_OWNERS 16
+#endif
+
+namespace v4std {
+
+/**
+ * @brief Call executed by an owner thread
+ *
+ * @param context Caller's state, valid until forward() returns
+ * @return Result handed back to the forwarding thread
+ */
+using OwnerTask = int32_t (*)(void *context);
+
+/**
+ * @brief Owner thread for a set of devices
+ *
+ * The queue is a bounded MPSC ring (Vyukov): producers claim a cell with
+ * one CAS, the owner consumes without atomics read-modify-write.
+ * Requests live on the forwarding thread's stack until they complete.
+ */
+class DeviceOwner {
+public:
+  static constexpr size_t kQueueSize = V4STD_OWNER_QUEUE_SIZE;
+  static_assert((kQueueSize & (kQueueSize - 1)) == 0 && kQueueSize >= 2,
+                "V4STD_OWNER_QUEUE_SIZE must be a power of two");
+
+  DeviceOwner();
+
+  DeviceOwner(const DeviceOwner &) = delete;
+  DeviceOwner &operator=(const DeviceOwner &) = delete;
+
+  /**
+   * @brief Make the calling thread this owner's thread
+   *
+   * Calls on owned devices from this thread run directly.
+   */
+  void bind_current_thread();
+
+  /** @brief Detach the calling thread from its owner */
+  static void unbind_current_thread();
+
+  /** @brief Owner bound to the calling thread, or nullptr */
+  static DeviceOwner *current();
+
+  /**
+   * @brief Execute queued requests (owner thread only)
+   *
+   * Tasks run under a Ddt::ReadGuard, so a forwarded handler must not make
+   * SYS calls on devices pinned to other owners.
+   *
+   * @param max_batch Maximum number of requests to run
+   * @return Number of requests executed
+   */
+  size_t drain(size_t max_batch = kQueueSize);
+
+  /**
+   * @brief Run a call on the owner thread and wait for its result
+   *
+   * Called by the dispatcher for calls from non-owner threads. The owner
+   * runs the task under a Ddt::ReadGuard and the device's lock. While
+   * waiting, a caller that is itself an owner keeps draining its own
+   * queue, so owners forwarding to each other cannot deadlock.
+   *
+   * Must not be called while holding a Ddt::ReadGuard (asserted): an
+   * owner thread that replaces the provider would wait for the guard
+   * forever. This rules out nested SYS calls from any handler, forwarded
+   * or not, on devices pinned to another owner.
+   */
+  int32_t forward(OwnerTask task, void *context, v4dev_kind_t kind,
+                  v4dev_role_t role, uint8_t index);
+
+  /** @brief Requests executed on behalf of other threads */
+  uint64_t forwarded() const {
+    return forwarded_.load(std::memory_order_relaxed);
+  }
+
+  /** @brief Largest batch executed by one drain() */
+  size_t max_batch() const {
+    return max_batch_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Request {
+    OwnerTask task;
+    void *context;
+    v4dev_kind_t kind;
+    v4dev_role_t role;
+    uint8_t index;
+    int32_t result;
+    std::atomic<bool> done;
+  };
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    Request *request;
+  };
+
+  bool try_push(Request *request);
+  Request *try_pop();
+
+  alignas(V4STD_CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+  alignas(V4STD_CACHE_LINE_SIZE) size_t dequeue_pos_ = 0;
+  Cell cells_[kQueueSize];
+  std::atomic<uint64_t> forwarded_{0};
+  std::atomic<size_t> max_batch_{0};
+};
+
+/**
+ * @brief Pin a device to an owner
+ *
+ * The device need not be present yet; calls are forwarded whenever it is.
+ * Up to V4STD_MAX_DEVICE_OWNERS devices can be pinned at once.
+ *
+ * @param kind Device kind
+ * @param role Device role
+ * @param index Index within kind/role
+ * @param owner Owner, or nullptr to unpin
+ * @return false if the pin table is full
+ */
+bool set_device_owner(v4dev_kind_t kind, v4dev_role_t role, uint8_t index,
+                      DeviceOwner *owner);
+
+/**
+ * @brief Owner of a device
+ *
+ * @return Owner, or nullptr if the device is not pinned
+ */
+DeviceOwner *get_device_owner(v4dev_kind_t kind, v4dev_role_t role,
+                              uint8_t index);
+
+/**
+ * @brief Unpin every device
+ *
+ * Not safe against concurrent set_device_owner() calls.
+ */
+void clear_device_owners();
+
+} // namespace v4std
+
+#endif // V4STD_DEVICE_OWNER_HPP
@@ -0,0 +1,74 @@
+/**
+ * @file ddt_image_file.hpp
+ * @brief Serve a DDT image file through mmap
+ *
+ * Maps a file produced by v4ddt_compile read-only and attaches a
+ * MappedDdtProvider to the mapping, so the table is paged in on demand
+ * and shared between processes instead of being parsed at startup.
+ *
+ * The file must not be modified while mapped; install new images by
+ * writing a new file and rename()-ing it over the old one.
+ *
+ * Part of the Linux-only v4std_linux library (CMake: V4STD_BUILD_LINUX).
+ *
+ * Example:
+ * @code
+ * static MappedDdtFile board;
+ * if (board.open("/etc/v4/board.ddt")) {
+ *   Ddt::set_provider(&board.provider());
+ * }
+ * @endcode
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_LINUX_DDT_IMAGE_FILE_HPP
+#define V4STD_LINUX_DDT_IMAGE_FILE_HPP
+
+#include "v4std/ddt_image.hpp"
+#include <cstddef>
+
+namespace v4std {
+
+/**
+ * @brief Read-only mapping of a DDT image file
+ */
+class MappedDdtFile {
+public:
+  MappedDdtFile() = default;
+  ~MappedDdtFile();
+
+  MappedDdtFile(const MappedDdtFile &) = delete;
+  MappedDdtFile &operator=(const MappedDdtFile &) = delete;
+
+  /**
+   * @brief Map an image file and validate it
+   *
+   * @param path Image file path
+   * @return false if the file cannot be mapped or is not a valid image
+   */
+  bool open(const char *path);
+
+  /**
+   * @brief Unmap the file
+   *
+   * Remove the provider from Ddt first.
+   */
+  void close();
+
+  /** @brief Provider serving the mapped image */
+  MappedDdtProvider &provider() { return provider_; }
+
+  /** @brief Mapped size in bytes (0 if not open) */
+  size_t size() const { return size_; }
+
+private:
+  MappedDdtProvider provider_;
+  void *mapping_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace v4std
+
+#endif // V4STD_LINUX_DDT_IMAGE_FILE_HPP
@@ -0,0 +1,224 @@
+/**
+ * @file gpio_chardev.hpp
+ * @brief LED and button HALs on the Linux GPIO character device
+ *
+ * GpioLedHal drives LEDs through the GPIO v2 uAPI (/dev/gpiochipN). All
+ * LED lines of a chip share one line request, so every update is a single
+ * GPIO_V2_LINE_SET_VALUES ioctl on one fd; between begin_batch() and
+ * end_batch(), set_led() calls are collected into one bits/mask pair and
+ * applied together by end_batch().
+ *
+ * GpioButtonHal requests the button lines of a chip for both edges and
+ * reads edge events as gpio_v2_line_event records from an epoll set, so
+ * a waiting thread sleeps in the kernel instead of polling line values.
+ *
+ * Handles are line offsets on the chip. Both HALs reach the kernel only
+ * through a GpioIo, which tests replace with an in-process fake.
+ *
+ * Part of the Linux-only v4std_linux library (CMake: V4STD_BUILD_LINUX).
+ *
+ * Example:
+ * @code
+ * static GpioLedHal leds;
+ * static const uint32_t offsets[] = {17, 27};
+ * if (leds.open("/dev/gpiochip0", span<const uint32_t>{offsets})) {
+ *   set_led_hal(&leds);
+ * }
+ *
+ * leds.begin_batch();
+ * leds.set_led(17, true, false);
+ * leds.set_led(27, false, false);
+ * leds.end_batch(); // One ioctl for both lines
+ * @endcode
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_LINUX_GPIO_CHARDEV_HPP
+#define V4STD_LINUX_GPIO_CHARDEV_HPP
+
+#include "v4std/span.hpp"
+#include "v4std/sys_led.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <sys/types.h>
+
+namespace v4std {
+
+/**
+ * @brief System calls used by the GPIO HALs
+ *
+ * The default implementation (system_gpio_io()) forwards to the C library.
+ * Line request fds returned through GPIO_V2_GET_LINE_IOCTL must be real
+ * descriptors, since GpioButtonHal adds them to an epoll set.
+ */
+class GpioIo {
+public:
+  virtual ~GpioIo() = default;
+
+  virtual int open(const char *path, int flags) = 0;
+  virtual int close(int fd) = 0;
+  virtual int ioctl(int fd, unsigned long request, void *arg) = 0;
+  virtual ssize_t read(int fd, void *buf, size_t size) = 0;
+};
+
+/**
+ * @brief GpioIo backed by the real system calls
+ */
+GpioIo &system_gpio_io();
+
+/**
+ * @brief LedHal over one GPIO v2 line request
+ */
+class GpioLedHal : public LedHal {
+public:
+  /** @brief Most lines in one request (GPIO_V2_LINES_MAX) */
+  static constexpr size_t kMaxLines = 64;
+
+  explicit GpioLedHal(GpioIo &io = system_gpio_io()) : io_(io) {}
+  ~GpioLedHal() override;
+
+  GpioLedHal(const GpioLedHal &) = delete;
+  GpioLedHal &operator=(const GpioLedHal &) = delete;
+
+  /**
+   * @brief Request LED lines as outputs, all off
+   *
+   * The kernel drives the initial levels as part of the request, so
+   * active-low LEDs never flash on: their lines start high, the others
+   * low.
+   *
+   * @param chip Chip device path (e.g., "/dev/gpiochip0")
+   * @param offsets Line offsets on the chip, at most kMaxLines
+   * @param active_low Bit i set if the LED on offsets[i] is active-low
+   * @param consumer Consumer label shown by gpioinfo
+   * @return false if the chip cannot be opened or the lines are busy
+   */
+  bool open(const char *chip, span<const uint32_t> offsets,
+            uint64_t active_low = 0, const char *consumer = "v4std-led");
+
+  /**
+   * @brief Release the lines
+   *
+   * Remove the HAL with set_led_hal() first.
+   */
+  void close();
+
+  bool set_led(uint32_t handle, bool state, bool active_low) override;
+  bool get_led(uint32_t handle, bool active_low) override;
+
+  /**
+   * @brief Collect set_led() calls instead of applying them
+   *
+   * Batches nest; the outermost end_batch() applies them. set_led() calls
+   * from other threads during a batch join it.
+   */
+  void begin_batch();
+
+  /**
+   * @brief Apply the collected set_led() calls with one ioctl
+   *
+   * @return false if the ioctl failed (the batch is dropped)
+   */
+  bool end_batch();
+
+  /** @brief Line request fd (-1 if not open) */
+  int fd() const { return fd_; }
+
+private:
+  int line_of(uint32_t handle) const;
+  bool apply(uint64_t bits, uint64_t mask);
+
+  GpioIo &io_;
+  int fd_ = -1;
+  uint32_t offsets_[kMaxLines] = {};
+  size_t num_lines_ = 0;
+
+  std::mutex mutex_;
+  uint32_t batch_depth_ = 0;
+  uint64_t pending_bits_ = 0;
+  uint64_t pending_mask_ = 0;
+};
+
+/**
+ * @brief One button edge
+ */
+struct GpioButtonEvent {
+  uint32_t handle;       ///< Line offset
+  bool rising;           ///< Physical level went high
+  uint64_t timestamp_ns; ///< Kernel timestamp (CLOCK_MONOTONIC)
+};
+
+/**
+ * @brief Button HAL over one GPIO v2 edge-event line request
+ */
+class GpioButtonHal {
+public:
+  static constexpr size_t kMaxLines = 64;
+
+  /** @brief Event records fetched per read() */
+  static constexpr size_t kEventBuffer = 16;
+
+  explicit GpioButtonHal(GpioIo &io = system_gpio_io()) : io_(io) {}
+  ~GpioButtonHal();
+
+  GpioButtonHal(const GpioButtonHal &) = delete;
+  GpioButtonHal &operator=(const GpioButtonHal &) = delete;
+
+  /**
+   * @brief Request button lines as inputs with edge detection
+   *
+   * @param chip Chip device path
+   * @param offsets Line offsets on the chip, at most kMaxLines
+   * @param debounce_us Kernel debounce period (0 = none)
+   * @param consumer Consumer label shown by gpioinfo
+   * @return false if the chip cannot be opened or the lines are busy
+   */
+  bool open(const char *chip, span<const uint32_t> offsets,
+            uint32_t debounce_us = 0, const char *consumer = "v4std-button");
+
+  /** @brief Release the lines */
+  void close();
+
+  /**
+   * @brief Read a button's current state
+   *
+   * @param handle Line offset
+   * @param active_low true if the button pulls the line low
+   * @param pressed Receives the state
+   * @return false if the handle is not requested or the ioctl failed
+   */
+  bool get_button(uint32_t handle, bool active_low, bool &pressed);
+
+  /**
+   * @brief Take the next edge, waiting up to timeout_ms
+   *
+   * @param event Receives the edge
+   * @param timeout_ms Wait limit (-1 = forever, 0 = poll)
+   * @return false on timeout or error
+   */
+  bool wait_event(GpioButtonEvent &event, int timeout_ms);
+
+  /** @brief epoll fd, readable while edges are queued (-1 if not open) */
+  int epoll_fd() const { return epoll_fd_; }
+
+private:
+  int line_of(uint32_t handle) const;
+  bool fill(int timeout_ms);
+
+  GpioIo &io_;
+  int fd_ = -1;
+  int epoll_fd_ = -1;
+  uint32_t offsets_[kMaxLines] = {};
+  size_t num_lines_ = 0;
+
+  GpioButtonEvent events_[kEventBuffer] = {};
+  size_t event_head_ = 0;
+  size_t event_count_ = 0;
+};
+
+} // namespace v4std
+
+#endif // V4STD_LINUX_GPIO_CHARDEV_HPP
@@ -0,0 +1,183 @@
+/**
+ * @file sys_bridge.hpp
+ * @brief Shared-memory SYS call bridge between a VM and a HAL process
+ *
+ * Lets a sandboxed VM process forward invoke_sys_handler() calls to a
+ * privileged HAL process that owns the GPIO/I2C/SPI file descriptors,
+ * without a socket round-trip per call. The two processes share one
+ * sealed memfd region holding a pair of single-producer/single-consumer
+ * rings (requests and responses). A waiting side spins briefly, then
+ * parks on a futex; the spin budget adapts to how often spinning pays
+ * off. Batched calls publish many requests with one index store and at
+ * most one wakeup.
+ *
+ * Each bridge connects one VM thread to one HAL thread; use one bridge
+ * per VM thread. The HAL side never trusts the shared region: requests
+ * are copied out before use and ring indices are range-checked.
+ *
+ * Part of the Linux-only v4std_linux library (CMake: V4STD_BUILD_LINUX).
+ *
+ * Example:
+ * @code
+ * SysBridge bridge;
+ * bridge.create();
+ * if (fork() == 0) {
+ *   // HAL process: register handlers, then serve until shutdown
+ *   register_led_sys_handlers();
+ *   bridge.run();
+ *   _exit(0);
+ * }
+ *
+ * int32_t result;
+ * bridge.call(V4SYS_LED_ON, V4DEV_LED, V4ROLE_STATUS, 0, result);
+ * bridge.shutdown();
+ * @endcode
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_LINUX_SYS_BRIDGE_HPP
+#define V4STD_LINUX_SYS_BRIDGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Slots per bridge ring (power of two)
+ */
+#ifndef V4STD_BRIDGE_RING_SIZE
+#define V4STD_BRIDGE_RING_SIZE 256
+#endif
+
+namespace v4std {
+
+/**
+ * @brief One SYS call for SysBridge::call_batch()
+ */
+struct SysBridgeCall {
+  uint16_t sys_id;
+  int32_t args[3];
+};
+
+struct SysBridgeShared;
+
+/**
+ * @brief One end of a shared-memory SYS call bridge
+ *
+ * The VM side uses call()/call_batch(); the HAL side uses serve()/run().
+ * Calls are answered in order by invoke_sys_handler() in the HAL process.
+ */
+class SysBridge {
+public:
+  static constexpr uint32_t kRingSize = V4STD_BRIDGE_RING_SIZE;
+  static_assert((kRingSize & (kRingSize - 1)) == 0 && kRingSize >= 2,
+                "V4STD_BRIDGE_RING_SIZE must be a power of two");
+
+  SysBridge() = default;
+  ~SysBridge();
+
+  SysBridge(const SysBridge &) = delete;
+  SysBridge &operator=(const SysBridge &) = delete;
+
+  /**
+   * @brief Create and map a new shared region
+   *
+   * The region is a close-on-exec memfd sealed against resizing. Share it
+   * with the peer through fork() or by passing fd() over a Unix socket.
+   *
+   * @return false if the memfd could not be created or mapped
+   */
+  bool create();
+
+  /**
+   * @brief Map a region created by the peer
+   *
+   * @param fd memfd from the peer (the bridge takes ownership)
+   * @return false if fd is not a compatible bridge region
+   */
+  bool attach(int fd);
+
+  /** @brief Unmap the region and close the fd */
+  void close();
+
+  /** @brief Region file descriptor, or -1 */
+  int fd() const { return fd_; }
+
+  /** @brief true once the region is mapped */
+  bool is_open() const { return shared_ != nullptr; }
+
+  /**
+   * @brief Forward one call and wait for its result (VM side)
+   *
+   * @param result Receives the handler's return value
+   * @return false if the bridge is shut down, closed, or corrupt
+   */
+  bool call(uint16_t sys_id, int32_t arg0, int32_t arg1, int32_t arg2,
+            int32_t &result);
+
+  /**
+   * @brief Forward many calls, waking the HAL side once per ring-full
+   *
+   * @param calls Calls to forward, run in order
+   * @param results Receives one result per call
+   * @param count Number of calls
+   * @return Number of calls completed (count unless the bridge failed)
+   */
+  size_t call_batch(const SysBridgeCall *calls, int32_t *results,
+                    size_t count);
+
+  /**
+   * @brief Answer pending requests without waiting (HAL side)
+   *
+   * @param max_batch Maximum number of requests to answer
+   * @return Number of requests answered
+   */
+  size_t serve(size_t max_batch = kRingSize);
+
+  /**
+   * @brief Serve requests until shutdown() (HAL side)
+   */
+  void run();
+
+  /**
+   * @brief Ask both sides to stop
+   *
+   * run() returns and pending call()s fail. Either side may call this.
+   */
+  void shutdown();
+
+  /** @brief true after shutdown() on either side */
+  bool is_shutdown() const;
+
+  /** @brief true if the peer left the ring indices inconsistent */
+  bool corrupt() const { return corrupt_; }
+
+  /** @brief Times this side parked on a futex */
+  uint64_t futex_waits() const { return futex_waits_; }
+
+  /** @brief Current spin budget before parking, in iterations */
+  uint32_t spin_budget() const { return spin_budget_; }
+
+private:
+  uint32_t wait_for_data(bool responses);
+
+  SysBridgeShared *shared_ = nullptr;
+  int fd_ = -1;
+
+  // Cursors owned by this side (VM: req_head_, resp_tail_;
+  // HAL: req_tail_, resp_head_)
+  uint32_t req_head_ = 0;
+  uint32_t req_tail_ = 0;
+  uint32_t resp_head_ = 0;
+  uint32_t resp_tail_ = 0;
+  uint32_t next_seq_ = 0;
+
+  uint32_t spin_budget_ = 0;
+  uint64_t futex_waits_ = 0;
+  bool corrupt_ = false;
+};
+
+} // namespace v4std
+
+#endif // V4STD_LINUX_SYS_BRIDGE_HPP
@@ -0,0 +1,357 @@
+/**
+ * @file pool.hpp
+ * @brief Lock-free fixed-block pool allocator
+ *
+ * Typed node storage for subsystems that must not touch the heap (timers,
+ * async requests, events, storage pages). Blocks live in a caller-provided
+ * PoolStorage array, so memory use is fixed at link time. The shared free
+ * list is a lock-free stack; each thread additionally keeps a small cache
+ * of free blocks so the hot allocate/free path rarely touches shared
+ * state.
+ *
+ * Example:
+ * @code
+ * static PoolStorage<TimerNode, 32> timer_storage;
+ * static StaticPool<TimerNode, 32> timer_pool{timer_storage};
+ *
+ * TimerNode *node = timer_pool.create(deadline, callback);
+ * if (!node) { ... } // exhausted; see timer_pool.exhausted_count()
+ * timer_pool.destroy(node);
+ * @endcode
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_POOL_HPP
+#define V4STD_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+/**
+ * @brief Free blocks cached per thread and pool type (0 disables caching)
+ *
+ * Set with the CMake cache variable of the same name. Targets without
+ * thread_local support should set it to 0.
+ */
+#ifndef V4STD_POOL_CACHE_SIZE
+#define V4STD_POOL_CACHE_SIZE 8
+#endif
+
+namespace v4std {
+
+/**
+ * @brief Backing storage for StaticPool<T, N>
+ *
+ * Uninitialized, suitably aligned space for N objects of type T. Define
+ * it with static storage duration (or place it in a dedicated linker
+ * section) and hand it to a StaticPool.
+ */
+template <typename T, size_t N> struct PoolStorage {
+  struct alignas(T) Block {
+    unsigned char bytes[sizeof(T)];
+  };
+
+  Block blocks[N];
+};
+
+/**
+ * @brief Lock-free fixed-block pool over caller-provided storage
+ *
+ * allocate()/deallocate() hand out raw blocks; create()/destroy() also
+ * run T's constructor and destructor. All operations are lock-free and
+ * never allocate.
+ *
+ * The shared free list is a Treiber stack whose head packs a 16-bit block
+ * index with a 16-bit ABA tag into one 32-bit word, so it stays lock-free
+ * on 32-bit MCUs without 64-bit CAS. Index 0xFFFF marks the empty list,
+ * which limits N to 65535 blocks.
+ * Never-used blocks are handed out from a bump index, so construction is
+ * constexpr and needs no initialization pass.
+ *
+ * With V4STD_POOL_CACHE_SIZE > 0 each thread caches up to that many free
+ * blocks per pool type. A thread's cache belongs to the pool it last
+ * used and is flushed back when the thread switches pools or exits, or
+ * on flush_thread_cache(). Cached blocks are not visible to other
+ * threads, so size N with (threads * cache size) of slack.
+ *
+ * A pool must outlive every thread that used it, or each such thread must
+ * call flush_thread_cache() before the pool is destroyed: a cache still
+ * naming a dead pool flushes into it at thread exit, and a new pool at
+ * the same address would inherit its indices. Pools are trivially
+ * destructible, so static pools register no exit-time destructor.
+ *
+ * @tparam T Object type
+ * @tparam N Number of blocks
+ */
+template <typename T, size_t N> class StaticPool {
+  static_assert(N > 0, "StaticPool needs at least one block");
+  static_assert(N <= 0xFFFF, "StaticPool supports at most 65535 blocks");
+
+public:
+  using Storage = PoolStorage<T, N>;
+
+  constexpr explicit StaticPool(Storage &storage) noexcept
+      : storage_(storage) {}
+
+  StaticPool(const StaticPool &) = delete;
+  StaticPool &operator=(const StaticPool &) = delete;
+
+  /**
+   * @brief Take one uninitialized block
+   *
+   * @return Block pointer, or nullptr if the pool is exhausted
+   */
+  void *allocate() noexcept {
+    uint16_t index = take_cached();
+    if (index == kNone) {
+      index = pop_shared();
+    }
+    if (index == kNone) {
+      index = take_fresh();
+    }
+    if (index == kNone) {
+      exhausted_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    note_in_use();
+    return storage_.blocks[index].bytes;
+  }
+
+  /**
+   * @brief Return a block obtained from allocate()
+   *
+   * @param ptr Block pointer (nullptr is ignored)
+   */
+  void deallocate(void *ptr) noexcept {
+    if (!ptr) {
+      return;
+    }
+
+    uint16_t index = index_of(ptr);
+    in_use_.fetch_sub(1, std::memory_order_relaxed);
+    if (!put_cached(index)) {
+      push_shared(index);
+    }
+  }
+
+  /**
+   * @brief Allocate a block and construct a T in it
+   *
+   * @return Constructed object, or nullptr if the pool is exhausted
+   */
+  template <typename... Args> T *create(Args &&...args) noexcept {
+    void *block = allocate();
+    if (!block) {
+      return nullptr;
+    }
+    return ::new (block) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Destroy an object from create() and return its block
+   */
+  void destroy(T *obj) noexcept {
+    if (!obj) {
+      return;
+    }
+    obj->~T();
+    deallocate(obj);
+  }
+
+  /** @brief true if ptr points at a block of this pool */
+  bool owns(const void *ptr) const noexcept {
+    auto *p = static_cast<const unsigned char *>(ptr);
+    auto *first = storage_.blocks[0].bytes;
+    return p >= first && p < first + sizeof(storage_.blocks) &&
+           (p - first) % sizeof(typename Storage::Block) == 0;
+  }
+
+  /**
+   * @brief Return this thread's cached blocks to the shared free list
+   *
+   * Only flushes the cache if this pool owns it.
+   */
+  void flush_thread_cache() noexcept {
+#if V4STD_POOL_CACHE_SIZE > 0
+    ThreadCache &cache = thread_cache();
+    if (cache.owner == this) {
+      cache.flush();
+    }
+#endif
+  }
+
+  /** @brief Total number of blocks */
+  static constexpr size_t capacity() noexcept { return N; }
+
+  /** @brief Blocks currently handed out */
+  size_t in_use() const noexcept {
+    return in_use_.load(std::memory_order_relaxed);
+  }
+
+  /** @brief Highest in_use() observed */
+  size_t high_water() const noexcept {
+    return high_water_.load(std::memory_order_relaxed);
+  }
+
+  /** @brief Number of allocations that failed because the pool was empty */
+  size_t exhausted_count() const noexcept {
+    return exhausted_.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr uint16_t kNone = 0xFFFF;
+
+  static constexpr uint32_t pack(uint16_t index, uint16_t tag) noexcept {
+    return (static_cast<uint32_t>(tag) << 16) | index;
+  }
+  static constexpr uint16_t index_part(uint32_t head) noexcept {
+    return static_cast<uint16_t>(head & 0xFFFF);
+  }
+  static constexpr uint16_t tag_part(uint32_t head) noexcept {
+    return static_cast<uint16_t>(head >> 16);
+  }
+
+  uint16_t index_of(const void *ptr) const noexcept {
+    auto *p = static_cast<const unsigned char *>(ptr);
+    return static_cast<uint16_t>((p - storage_.blocks[0].bytes) /
+                                 sizeof(typename Storage::Block));
+  }
+
+  uint16_t pop_shared() noexcept {
+    uint32_t head = head_.load(std::memory_order_acquire);
+    for (;;) {
+      uint16_t index = index_part(head);
+      if (index == kNone) {
+        return kNone;
+      }
+      uint16_t next = next_[index].load(std::memory_order_relaxed);
+      uint32_t desired = pack(next, static_cast<uint16_t>(tag_part(head) + 1));
+      if (head_.compare_exchange_weak(head, desired,
+                                      std::memory_order_acquire,
+                                      std::memory_order_acquire)) {
+        return index;
+      }
+    }
+  }
+
+  void push_shared(uint16_t index) noexcept {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      next_[index].store(index_part(head), std::memory_order_relaxed);
+      uint32_t desired = pack(index, static_cast<uint16_t>(tag_part(head) + 1));
+      if (head_.compare_exchange_weak(head, desired,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  uint16_t take_fresh() noexcept {
+    uint16_t fresh = fresh_.load(std::memory_order_relaxed);
+    while (fresh < N) {
+      if (fresh_.compare_exchange_weak(fresh, static_cast<uint16_t>(fresh + 1),
+                                       std::memory_order_relaxed)) {
+        return fresh;
+      }
+    }
+    return kNone;
+  }
+
+  void note_in_use() noexcept {
+    size_t used = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t peak = high_water_.load(std::memory_order_relaxed);
+    while (used > peak && !high_water_.compare_exchange_weak(
+                              peak, used, std::memory_order_relaxed)) {
+    }
+  }
+
+#if V4STD_POOL_CACHE_SIZE > 0
+  // Per-thread cache, shared by all pools of this type; owned by the
+  // pool that used it last
+  struct ThreadCache {
+    StaticPool *owner = nullptr;
+    size_t count = 0;
+    uint16_t slots[V4STD_POOL_CACHE_SIZE];
+
+    void flush() noexcept {
+      while (count > 0) {
+        owner->push_shared(slots[--count]);
+      }
+    }
+
+    ~ThreadCache() {
+      if (owner) {
+        flush();
+      }
+    }
+  };
+
+  static ThreadCache &thread_cache() noexcept {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+
+  ThreadCache &claim_thread_cache() noexcept {
+    ThreadCache &cache = thread_cache();
+    if (cache.owner != this) {
+      if (cache.owner) {
+        cache.flush();
+      }
+      cache.owner = this;
+    }
+    return cache;
+  }
+
+  uint16_t take_cached() noexcept {
+    ThreadCache &cache = thread_cache();
+    if (cache.owner != this || cache.count == 0) {
+      return kNone;
+    }
+    return cache.slots[--cache.count];
+  }
+
+  bool put_cached(uint16_t index) noexcept {
+    ThreadCache &cache = claim_thread_cache();
+    if (cache.count == V4STD_POOL_CACHE_SIZE) {
+      return false;
+    }
+    cache.slots[cache.count++] = index;
+    return true;
+  }
+#else
+  uint16_t take_cached() noexcept { return kNone; }
+  bool put_cached(uint16_t) noexcept { return false; }
+#endif
+
+  Storage &storage_;
+  std::atomic<uint32_t> head_{pack(kNone, 0)};
+  std::atomic<uint16_t> fresh_{0};
+  std::atomic<uint16_t> next_[N] = {};
+  std::atomic<size_t> in_use_{0};
+  std::atomic<size_t> high_water_{0};
+  std::atomic<size_t> exhausted_{0};
+};
+
+/**
+ * @brief StaticPool with its storage embedded
+ *
+ * Convenience for pools defined as a single static object.
+ */
+template <typename T, size_t N>
+class InlinePool : private PoolStorage<T, N>, public StaticPool<T, N> {
+public:
+  constexpr InlinePool() noexcept
+      : PoolStorage<T, N>(), StaticPool<T, N>(
+                                 static_cast<PoolStorage<T, N> &>(*this)) {}
+};
+
+} // namespace v4std
+
+#endif // V4STD_POOL_HPP
@@ -0,0 +1,87 @@
+/**
+ * @file sys_replay.hpp
+ * @brief Replay recorded SYS call logs against the handler registry
+ *
+ * Drives invoke_sys_cells() from a SysTraceRecorder log, either as fast
+ * as possible or at the recorded pacing, and reports throughput, a
+ * latency histogram, and how many results diverged from the recording.
+ * Typically run against a VirtualBoard so HAL changes can be compared on
+ * the same production-shaped workload.
+ *
+ * Part of the host-only v4std_sim library (CMake: V4STD_BUILD_SIM).
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_SIM_SYS_REPLAY_HPP
+#define V4STD_SIM_SYS_REPLAY_HPP
+
+#include "v4std/span.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace v4std {
+
+/**
+ * @brief Replay settings
+ */
+struct SysReplayOptions {
+  /** Wait out recorded inter-arrival times instead of running flat out */
+  bool paced = false;
+
+  /** Pacing speed-up factor (2.0 = twice as fast); paced mode only */
+  double speed = 1.0;
+};
+
+/**
+ * @brief Replay results
+ *
+ * Latencies are per invoke_sys_cells() call. Bucket i of
+ * latency_histogram counts calls that took [2^i, 2^(i+1)) ns; bucket 0
+ * also holds calls under 1 ns.
+ */
+struct SysReplayStats {
+  static constexpr size_t kBuckets = 32;
+
+  uint64_t calls = 0;          /**< Records replayed */
+  uint64_t divergences = 0;    /**< Results that differ from the log */
+  uint64_t total_ns = 0;       /**< Sum of per-call latencies */
+  uint64_t elapsed_ns = 0;     /**< Wall time of the whole replay */
+  bool malformed = false;      /**< Log header or a record was invalid */
+  uint64_t latency_histogram[kBuckets] = {};
+
+  /** @brief Calls per second of wall time */
+  double throughput() const {
+    return elapsed_ns ? calls * 1e9 / static_cast<double>(elapsed_ns) : 0.0;
+  }
+
+  /** @brief Mean per-call latency in nanoseconds */
+  double mean_latency_ns() const {
+    return calls ? static_cast<double>(total_ns) / calls : 0.0;
+  }
+
+  /**
+   * @brief Upper bound of the bucket holding the given percentile
+   *
+   * @param percentile In [0, 100]
+   * @return Latency bound in nanoseconds (2^(bucket + 1))
+   */
+  uint64_t latency_percentile_ns(double percentile) const;
+};
+
+/**
+ * @brief Replay a trace log through invoke_sys_cells()
+ *
+ * Handlers, the DDT provider, and HALs must be set up by the caller.
+ *
+ * @param log Log produced by SysTraceRecorder
+ * @param options Pacing settings
+ * @return Replay statistics (malformed is set if decoding failed)
+ */
+SysReplayStats replay_sys_trace(span<const uint8_t> log,
+                                const SysReplayOptions &options = {});
+
+} // namespace v4std
+
+#endif // V4STD_SIM_SYS_REPLAY_HPP
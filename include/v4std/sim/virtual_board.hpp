@@ -0,0 +1,243 @@
+/**
+ * @file virtual_board.hpp
+ * @brief Host virtual board: simulated DDT and HALs for load testing
+ *
+ * VirtualBoard is a DdtProvider that can be populated at startup with
+ * up to 256 devices per kind/role (the range of DeviceDesc::index),
+ * plus simulated HALs that keep per-device state, count calls, and can
+ * spin for a configurable latency per call. It lets tests and benchmarks
+ * drive millions of SYS calls across thousands of devices on a plain
+ * host.
+ *
+ * Part of the host-only v4std_sim library (CMake: V4STD_BUILD_SIM). It
+ * allocates while being configured and is not subject to V4STD_NO_HEAP.
+ *
+ * Example:
+ * @code
+ * VirtualBoard board;
+ * board.add_devices(V4DEV_LED, V4ROLE_USER, 200);
+ * board.hal(V4DEV_LED).set_latency_ns(500);
+ *
+ * Ddt::set_provider(&board);
+ * set_led_hal(&board.led_hal());
+ * register_led_sys_handlers();
+ * @endcode
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_SIM_VIRTUAL_BOARD_HPP
+#define V4STD_SIM_VIRTUAL_BOARD_HPP
+
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_types.h"
+#include "v4std/sys_led.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace v4std {
+
+class VirtualBoard;
+
+/**
+ * @brief Simulated HAL for one device kind
+ *
+ * Devices are addressed by the handle from their descriptor. Each device
+ * holds one int32_t value: output level for LEDs/PWM, input level for
+ * buttons, last byte for UARTs, and so on. Kinds without a HAL interface
+ * in v4std yet are driven through read()/write() directly.
+ */
+class VirtualHal {
+public:
+  /**
+   * @brief Read a device value
+   *
+   * @param handle Device handle
+   * @param value Receives the value
+   * @return false if handle is not a device of this kind
+   */
+  bool read(uint32_t handle, int32_t &value);
+
+  /**
+   * @brief Write a device value
+   *
+   * @param handle Device handle
+   * @param value New value
+   * @return false if handle is not a device of this kind
+   */
+  bool write(uint32_t handle, int32_t value);
+
+  /**
+   * @brief Simulated cost of each read()/write() (busy wait)
+   *
+   * @param ns Latency in nanoseconds (0 = none)
+   */
+  void set_latency_ns(uint32_t ns) {
+    latency_ns_.store(ns, std::memory_order_relaxed);
+  }
+
+  /** @brief Simulated latency in nanoseconds */
+  uint32_t latency_ns() const {
+    return latency_ns_.load(std::memory_order_relaxed);
+  }
+
+  /** @brief read() calls since the last reset */
+  uint64_t reads() const { return reads_.load(std::memory_order_relaxed); }
+
+  /** @brief write() calls since the last reset */
+  uint64_t writes() const { return writes_.load(std::memory_order_relaxed); }
+
+  /** @brief Calls rejected for an unknown or foreign handle */
+  uint64_t errors() const { return errors_.load(std::memory_order_relaxed); }
+
+  /** @brief All calls (reads + writes + errors) */
+  uint64_t calls() const { return reads() + writes() + errors(); }
+
+  /** @brief Zero the call counters */
+  void reset_counters();
+
+private:
+  friend class VirtualBoard;
+
+  bool accept(uint32_t handle);
+  void simulate_latency() const;
+
+  VirtualBoard *board_ = nullptr;
+  uint8_t kind_ = V4DEV_NONE;
+  std::atomic<uint32_t> latency_ns_{0};
+  std::atomic<uint64_t> reads_{0};
+  std::atomic<uint64_t> writes_{0};
+  std::atomic<uint64_t> errors_{0};
+};
+
+/**
+ * @brief LedHal backed by the board's LED VirtualHal
+ *
+ * Stores the physical pin level (active-low inverted), so value(handle)
+ * shows what a logic analyzer would see.
+ */
+class VirtualLedHal : public LedHal {
+public:
+  explicit VirtualLedHal(VirtualHal &hal) : hal_(hal) {}
+
+  bool set_led(uint32_t handle, bool state, bool active_low) override;
+  bool get_led(uint32_t handle, bool active_low) override;
+
+private:
+  VirtualHal &hal_;
+};
+
+/**
+ * @brief Configurable host board with simulated devices
+ *
+ * Descriptors are laid out in the order they are added, with handles
+ * equal to their position in the table. Configure the board completely
+ * before installing it with Ddt::set_provider(); adding devices
+ * afterwards invalidates spans already handed out.
+ *
+ * HAL calls are thread-safe (device state and counters are atomic);
+ * configuration is not.
+ */
+class VirtualBoard : public DdtProvider {
+public:
+  /** @brief Number of v4dev_kind_t values (V4DEV_NONE..V4DEV_RNG) */
+  static constexpr size_t kKindCount = V4DEV_RNG + 1;
+
+  /** @brief Number of v4dev_role_t values (V4ROLE_NONE..V4ROLE_DEBUG) */
+  static constexpr size_t kRoleCount = V4ROLE_DEBUG + 1;
+
+  /** @brief Devices per kind/role (DeviceDesc::index is 8-bit) */
+  static constexpr size_t kMaxPerRole = 256;
+
+  VirtualBoard();
+
+  VirtualBoard(const VirtualBoard &) = delete;
+  VirtualBoard &operator=(const VirtualBoard &) = delete;
+
+  /**
+   * @brief Add count devices of one kind/role
+   *
+   * New devices continue the index sequence of that kind/role.
+   *
+   * @param kind Device kind (not V4DEV_NONE)
+   * @param role Device role (not V4ROLE_NONE)
+   * @param count Number of devices to add
+   * @param flags Descriptor flags for the new devices
+   * @return false if kind/role is invalid, indices would exceed 255, or
+   *         handles would not fit the descriptor layout
+   */
+  bool add_devices(v4dev_kind_t kind, v4dev_role_t role, size_t count,
+                   uint8_t flags = 0);
+
+  /**
+   * @brief Add count devices for every kind/role combination
+   *
+   * @param count Devices per kind/role (at most kMaxPerRole)
+   * @return false if any combination would exceed kMaxPerRole
+   */
+  bool add_all(size_t count);
+
+  /** @brief Remove all devices and reset HAL counters */
+  void clear();
+
+  span<const DeviceDesc> get_devices() const override;
+
+  /** @brief Number of devices on the board */
+  size_t device_count() const { return devices_.size(); }
+
+  /** @brief Simulated HAL for a device kind */
+  VirtualHal &hal(v4dev_kind_t kind) { return hals_[kind]; }
+  const VirtualHal &hal(v4dev_kind_t kind) const { return hals_[kind]; }
+
+  /** @brief LedHal for set_led_hal() */
+  VirtualLedHal &led_hal() { return led_hal_; }
+
+  /**
+   * @brief Current value of a device
+   *
+   * @param handle Device handle
+   * @return Device value, or 0 if handle is unknown
+   */
+  int32_t value(uint32_t handle) const;
+
+  /**
+   * @brief Set a device value without going through the HAL
+   *
+   * Used to inject inputs (button presses, ADC samples). Not counted.
+   */
+  void set_value(uint32_t handle, int32_t value);
+
+  /** @brief HAL calls that reached one device */
+  uint64_t device_calls(uint32_t handle) const;
+
+  /** @brief HAL calls across all kinds */
+  uint64_t total_calls() const;
+
+  /** @brief Zero all HAL and per-device counters */
+  void reset_counters();
+
+private:
+  friend class VirtualHal;
+
+  struct DeviceState {
+    std::atomic<int32_t> value{0};
+    std::atomic<uint64_t> calls{0};
+  };
+
+  const DeviceDesc *device(uint32_t handle) const;
+  DeviceState &state(uint32_t handle) { return states_[handle]; }
+
+  std::vector<DeviceDesc> devices_;
+  std::deque<DeviceState> states_; // Stable addresses; atomics never move
+  uint16_t next_index_[kKindCount][kRoleCount] = {};
+  VirtualHal hals_[kKindCount];
+  VirtualLedHal led_hal_;
+};
+
+} // namespace v4std
+
+#endif // V4STD_SIM_VIRTUAL_BOARD_HPP
@@ -2,7 +2,7 @@
  * @file span.hpp
  * @brief Lightweight span implementation for C++17
  *
- * Provides a minimal std::span-like class for C++17 compatibility.
+ * Provides a std::span-like class for C++17 compatibility.
  * This is a non-owning view over a contiguous sequence of elements.
  *
  * @copyright Copyright 2025 V4 Project
@@ -12,21 +12,90 @@
 #ifndef V4STD_SPAN_HPP
 #define V4STD_SPAN_HPP
 
+#include <array>
+#include <cassert>
 #include <cstddef>
+#include <type_traits>
+#include <utility>
 
 namespace v4std {
 
+/** @brief Extent value for spans whose size is only known at runtime */
+inline constexpr size_t dynamic_extent = static_cast<size_t>(-1);
+
+template <typename T, size_t Extent = dynamic_extent> class span;
+
+namespace detail {
+
+// Storage: static extent keeps only the pointer
+template <typename T, size_t Extent> struct span_storage {
+  constexpr span_storage(T *ptr, size_t) noexcept : data(ptr) {}
+  T *data;
+  static constexpr size_t size = Extent;
+};
+
+template <typename T> struct span_storage<T, dynamic_extent> {
+  constexpr span_storage(T *ptr, size_t count) noexcept
+      : data(ptr), size(count) {}
+  T *data;
+  size_t size;
+};
+
+template <typename T> struct is_span : std::false_type {};
+template <typename T, size_t N>
+struct is_span<span<T, N>> : std::true_type {};
+
+template <typename T> struct is_std_array : std::false_type {};
+template <typename T, size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type {};
+
+// Qualification conversion only (e.g., T -> const T), never derived-to-base
+template <typename From, typename To>
+using is_array_convertible = std::is_convertible<From (*)[], To (*)[]>;
+
+// Contiguous container with data() and size()
+template <typename C, typename T, typename = void>
+struct is_compatible_container : std::false_type {};
+
+template <typename C, typename T>
+struct is_compatible_container<
+    C, T,
+    std::void_t<decltype(std::declval<C &>().data()),
+                decltype(std::declval<C &>().size())>>
+    : std::bool_constant<
+          !is_span<std::remove_cv_t<C>>::value &&
+          !is_std_array<std::remove_cv_t<C>>::value &&
+          !std::is_array<C>::value &&
+          is_array_convertible<
+              std::remove_pointer_t<decltype(std::declval<C &>().data())>,
+              T>::value> {};
+
+template <typename T, size_t N>
+inline constexpr size_t byte_extent =
+    N == dynamic_extent ? dynamic_extent : N * sizeof(T);
+
+template <size_t Extent, size_t Offset, size_t Count> struct subspan_extent {
+  static constexpr size_t value =
+      Count != dynamic_extent
+          ? Count
+          : (Extent != dynamic_extent ? Extent - Offset : dynamic_extent);
+};
+
+} // namespace detail
+
 /**
  * @brief Lightweight non-owning view over a contiguous sequence
  *
- * Minimal std::span-like implementation for C++17.
- * Provides begin(), end(), size(), empty(), and operator[].
+ * std::span-like implementation for C++17. With a static Extent the size
+ * is a compile-time constant, the span holds only a pointer, and
+ * first/last/subspan bounds are checked at compile time.
  */
-template <typename T> class span {
+template <typename T, size_t Extent> class span {
 public:
   using element_type = T;
-  using value_type = T;
+  using value_type = std::remove_cv_t<T>;
   using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
   using pointer = T *;
   using const_pointer = const T *;
   using reference = T &;
@@ -34,41 +103,174 @@ public:
   using iterator = T *;
   using const_iterator = const T *;
 
-  // Default constructor (empty span)
-  constexpr span() noexcept : data_(nullptr), size_(0) {}
+  static constexpr size_type extent = Extent;
+
+  // Default constructor (empty span; dynamic or zero extent only)
+  template <size_t E = Extent,
+            std::enable_if_t<E == 0 || E == dynamic_extent, int> = 0>
+  constexpr span() noexcept : storage_(nullptr, 0) {}
 
   // Constructor from pointer and size
+  template <size_t E = Extent,
+            std::enable_if_t<E == dynamic_extent, int> = 0>
   constexpr span(pointer ptr, size_type count) noexcept
-      : data_(ptr), size_(count) {}
+      : storage_(ptr, count) {}
+
+  // Explicit with a static extent, like std::span; count must equal Extent
+  template <size_t E = Extent,
+            std::enable_if_t<E != dynamic_extent, int> = 0>
+  constexpr explicit span(pointer ptr, size_type count) noexcept
+      : storage_(ptr, count) {
+    assert(count == Extent && "span: count does not match static extent");
+  }
 
   // Constructor from C-array
-  template <size_t N>
-  constexpr span(element_type (&arr)[N]) noexcept : data_(arr), size_(N) {}
+  template <typename U, size_t N,
+            std::enable_if_t<(Extent == dynamic_extent || Extent == N) &&
+                                 detail::is_array_convertible<U, T>::value,
+                             int> = 0>
+  constexpr span(U (&arr)[N]) noexcept : storage_(arr, N) {}
+
+  // Constructor from std::array
+  template <typename U, size_t N,
+            std::enable_if_t<(Extent == dynamic_extent || Extent == N) &&
+                                 detail::is_array_convertible<U, T>::value,
+                             int> = 0>
+  constexpr span(std::array<U, N> &arr) noexcept : storage_(arr.data(), N) {}
+
+  template <
+      typename U, size_t N,
+      std::enable_if_t<(Extent == dynamic_extent || Extent == N) &&
+                           detail::is_array_convertible<const U, T>::value,
+                       int> = 0>
+  constexpr span(const std::array<U, N> &arr) noexcept
+      : storage_(arr.data(), N) {}
+
+  // Constructor from contiguous containers with data()/size()
+  template <typename C,
+            std::enable_if_t<Extent == dynamic_extent &&
+                                 detail::is_compatible_container<C, T>::value,
+                             int> = 0>
+  constexpr span(C &container) noexcept
+      : storage_(container.data(), container.size()) {}
+
+  template <
+      typename C,
+      std::enable_if_t<Extent == dynamic_extent &&
+                           detail::is_compatible_container<const C, T>::value,
+                       int> = 0>
+  constexpr span(const C &container) noexcept
+      : storage_(container.data(), container.size()) {}
+
+  // Converting constructor (e.g., span<T, N> -> span<const T>)
+  template <typename U, size_t N,
+            std::enable_if_t<(Extent == dynamic_extent || Extent == N) &&
+                                 detail::is_array_convertible<U, T>::value,
+                             int> = 0>
+  constexpr span(const span<U, N> &other) noexcept
+      : storage_(other.data(), other.size()) {}
+
+  constexpr span(const span &other) noexcept = default;
+  constexpr span &operator=(const span &other) noexcept = default;
 
   // Iterators
-  constexpr iterator begin() const noexcept { return data_; }
-  constexpr iterator end() const noexcept { return data_ + size_; }
-  constexpr const_iterator cbegin() const noexcept { return data_; }
-  constexpr const_iterator cend() const noexcept { return data_ + size_; }
+  constexpr iterator begin() const noexcept { return data(); }
+  constexpr iterator end() const noexcept { return data() + size(); }
+  constexpr const_iterator cbegin() const noexcept { return data(); }
+  constexpr const_iterator cend() const noexcept { return data() + size(); }
 
   // Element access
   constexpr reference operator[](size_type idx) const noexcept {
-    return data_[idx];
+    return data()[idx];
   }
 
-  constexpr reference front() const noexcept { return data_[0]; }
-  constexpr reference back() const noexcept { return data_[size_ - 1]; }
-  constexpr pointer data() const noexcept { return data_; }
+  constexpr reference front() const noexcept { return data()[0]; }
+  constexpr reference back() const noexcept { return data()[size() - 1]; }
+  constexpr pointer data() const noexcept { return storage_.data; }
 
   // Capacity
-  constexpr size_type size() const noexcept { return size_; }
-  constexpr bool empty() const noexcept { return size_ == 0; }
+  constexpr size_type size() const noexcept { return storage_.size; }
+  constexpr size_type size_bytes() const noexcept {
+    return size() * sizeof(element_type);
+  }
+  constexpr bool empty() const noexcept { return size() == 0; }
+
+  // Subviews (compile-time counts)
+  template <size_t Count> constexpr span<T, Count> first() const noexcept {
+    static_assert(Extent == dynamic_extent || Count <= Extent,
+                  "first<Count>() exceeds span extent");
+    return span<T, Count>{data(), Count};
+  }
+
+  template <size_t Count> constexpr span<T, Count> last() const noexcept {
+    static_assert(Extent == dynamic_extent || Count <= Extent,
+                  "last<Count>() exceeds span extent");
+    return span<T, Count>{data() + (size() - Count), Count};
+  }
+
+  template <size_t Offset, size_t Count = dynamic_extent>
+  constexpr span<T, detail::subspan_extent<Extent, Offset, Count>::value>
+  subspan() const noexcept {
+    static_assert(Extent == dynamic_extent || Offset <= Extent,
+                  "subspan<Offset>() exceeds span extent");
+    static_assert(Extent == dynamic_extent || Count == dynamic_extent ||
+                      Count <= Extent - Offset,
+                  "subspan<Offset, Count>() exceeds span extent");
+    return span<T, detail::subspan_extent<Extent, Offset, Count>::value>{
+        data() + Offset, Count != dynamic_extent ? Count : size() - Offset};
+  }
+
+  // Subviews (runtime counts; caller guarantees bounds)
+  constexpr span<T> first(size_type count) const noexcept {
+    return span<T>{data(), count};
+  }
+
+  constexpr span<T> last(size_type count) const noexcept {
+    return span<T>{data() + (size() - count), count};
+  }
+
+  constexpr span<T> subspan(size_type offset,
+                            size_type count = dynamic_extent) const noexcept {
+    return span<T>{data() + offset,
+                   count != dynamic_extent ? count : size() - offset};
+  }
 
 private:
-  pointer data_;
-  size_type size_;
+  detail::span_storage<T, Extent> storage_;
 };
 
+// Deduction guides
+template <typename T, size_t N> span(T (&)[N]) -> span<T, N>;
+template <typename T, size_t N> span(std::array<T, N> &) -> span<T, N>;
+template <typename T, size_t N>
+span(const std::array<T, N> &) -> span<const T, N>;
+template <typename C>
+span(C &) -> span<std::remove_pointer_t<decltype(std::declval<C &>().data())>>;
+template <typename C>
+span(const C &)
+    -> span<std::remove_pointer_t<decltype(std::declval<const C &>().data())>>;
+
+/**
+ * @brief View a span's object representation as read-only bytes
+ */
+template <typename T, size_t N>
+span<const std::byte, detail::byte_extent<T, N>>
+as_bytes(span<T, N> s) noexcept {
+  return span<const std::byte, detail::byte_extent<T, N>>{
+      reinterpret_cast<const std::byte *>(s.data()), s.size_bytes()};
+}
+
+/**
+ * @brief View a span's object representation as writable bytes
+ */
+template <typename T, size_t N,
+          std::enable_if_t<!std::is_const<T>::value, int> = 0>
+span<std::byte, detail::byte_extent<T, N>>
+as_writable_bytes(span<T, N> s) noexcept {
+  return span<std::byte, detail::byte_extent<T, N>>{
+      reinterpret_cast<std::byte *>(s.data()), s.size_bytes()};
+}
+
 } // namespace v4std
 
 #endif // V4STD_SPAN_HPP
@@ -0,0 +1,283 @@
+/**
+ * @file span2d.hpp
+ * @brief Strided 2D view and row kernels (fill, blit, scroll)
+ *
+ * Provides an mdspan-like non-owning view over row-major 2D data with a
+ * row stride, for display frame buffers, LED matrices, and multi-channel
+ * sample blocks. Subviews never copy; kernels operate row by row on
+ * contiguous spans so the compiler can vectorize the inner loops.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_SPAN2D_HPP
+#define V4STD_SPAN2D_HPP
+
+#include "v4std/span.hpp"
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define V4STD_RESTRICT __restrict
+#else
+#define V4STD_RESTRICT
+#endif
+
+namespace v4std {
+
+/**
+ * @brief Non-owning row-major 2D view with a row stride
+ *
+ * Element (r, c) lives at data()[r * stride() + c]. stride() >= cols(),
+ * so a view can address a window inside a larger buffer.
+ *
+ * Example:
+ * @code
+ * uint16_t fb[240][320];
+ * span2d<uint16_t> screen{&fb[0][0], 240, 320};
+ * fill(screen.subview(10, 10, 32, 64), uint16_t{0xFFFF});
+ * @endcode
+ */
+template <typename T> class span2d {
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = size_t;
+  using pointer = T *;
+  using reference = T &;
+
+  /**
+   * @brief Forward iterator over rows, yielding span<T>
+   *
+   * Tracks the row number rather than a row pointer: stepping a pointer
+   * past the last row of a window would leave the underlying buffer.
+   */
+  class row_iterator {
+  public:
+    constexpr row_iterator(pointer data, size_type row, size_type cols,
+                           size_type stride) noexcept
+        : data_(data), row_(row), cols_(cols), stride_(stride) {}
+
+    constexpr span<T> operator*() const noexcept {
+      return span<T>{data_ + row_ * stride_, cols_};
+    }
+    constexpr row_iterator &operator++() noexcept {
+      ++row_;
+      return *this;
+    }
+    constexpr bool operator==(const row_iterator &other) const noexcept {
+      return row_ == other.row_;
+    }
+    constexpr bool operator!=(const row_iterator &other) const noexcept {
+      return row_ != other.row_;
+    }
+
+  private:
+    pointer data_;
+    size_type row_;
+    size_type cols_;
+    size_type stride_;
+  };
+
+  // Default constructor (empty view)
+  constexpr span2d() noexcept
+      : data_(nullptr), rows_(0), cols_(0), stride_(0) {}
+
+  // Constructor from pointer, extents, and row stride (in elements)
+  constexpr span2d(pointer data, size_type rows, size_type cols,
+                   size_type stride) noexcept
+      : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+
+  // Constructor for densely packed data (stride == cols)
+  constexpr span2d(pointer data, size_type rows, size_type cols) noexcept
+      : data_(data), rows_(rows), cols_(cols), stride_(cols) {}
+
+  // Converting constructor (e.g., span2d<T> -> span2d<const T>)
+  template <typename U,
+            std::enable_if_t<detail::is_array_convertible<U, T>::value,
+                             int> = 0>
+  constexpr span2d(const span2d<U> &other) noexcept
+      : data_(other.data()), rows_(other.rows()), cols_(other.cols()),
+        stride_(other.stride()) {}
+
+  // Extents
+  constexpr size_type rows() const noexcept { return rows_; }
+  constexpr size_type cols() const noexcept { return cols_; }
+  constexpr size_type stride() const noexcept { return stride_; }
+  constexpr size_type size() const noexcept { return rows_ * cols_; }
+  constexpr bool empty() const noexcept { return rows_ == 0 || cols_ == 0; }
+  constexpr pointer data() const noexcept { return data_; }
+
+  /** @brief true if rows are packed back to back (no padding) */
+  constexpr bool contiguous() const noexcept {
+    return stride_ == cols_ || rows_ <= 1;
+  }
+
+  // Element access
+  constexpr reference operator()(size_type r, size_type c) const noexcept {
+    return data_[r * stride_ + c];
+  }
+
+  /** @brief Row r as a contiguous span */
+  constexpr span<T> row(size_type r) const noexcept {
+    return span<T>{data_ + r * stride_, cols_};
+  }
+
+  /** @brief Rectangular window starting at (r, c) */
+  constexpr span2d subview(size_type r, size_type c, size_type nrows,
+                           size_type ncols) const noexcept {
+    return span2d{data_ + r * stride_ + c, nrows, ncols, stride_};
+  }
+
+  /** @brief Rows [r, r + nrows) */
+  constexpr span2d row_range(size_type r, size_type nrows) const noexcept {
+    return subview(r, 0, nrows, cols_);
+  }
+
+  /** @brief Columns [c, c + ncols) */
+  constexpr span2d col_range(size_type c, size_type ncols) const noexcept {
+    return subview(0, c, rows_, ncols);
+  }
+
+  /** @brief Column c as a rows() x 1 view */
+  constexpr span2d column(size_type c) const noexcept {
+    return col_range(c, 1);
+  }
+
+  /** @brief Whole view as one span (only valid if contiguous()) */
+  constexpr span<T> flat() const noexcept { return span<T>{data_, size()}; }
+
+  // Row iteration
+  constexpr row_iterator begin() const noexcept {
+    return row_iterator{data_, 0, cols_, stride_};
+  }
+  constexpr row_iterator end() const noexcept {
+    return row_iterator{data_, rows_, cols_, stride_};
+  }
+
+private:
+  pointer data_;
+  size_type rows_;
+  size_type cols_;
+  size_type stride_;
+};
+
+namespace detail {
+
+template <typename T>
+inline void fill_row(T *V4STD_RESTRICT dst, size_t n, T value) noexcept {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = value;
+  }
+}
+
+template <typename T>
+inline void copy_row(T *V4STD_RESTRICT dst, const T *V4STD_RESTRICT src,
+                     size_t n) noexcept {
+  if constexpr (std::is_trivially_copyable<T>::value) {
+    std::memcpy(dst, src, n * sizeof(T));
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = src[i];
+    }
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Set every element of a view to value
+ */
+template <typename T>
+void fill(span2d<T> dst, const std::remove_cv_t<T> &value) noexcept {
+  if (dst.empty()) {
+    return;
+  }
+
+  if (dst.contiguous()) {
+    detail::fill_row(dst.data(), dst.size(), value);
+    return;
+  }
+
+  for (span<T> r : dst) {
+    detail::fill_row(r.data(), r.size(), value);
+  }
+}
+
+/**
+ * @brief Copy src into the top-left corner of dst
+ *
+ * Copies min(rows) x min(cols) elements. src and dst must not overlap;
+ * use scroll_up()/scroll_down() to move data within one buffer.
+ */
+template <typename T, typename U>
+void blit(span2d<T> dst, span2d<U> src) noexcept {
+  static_assert(std::is_same<std::remove_cv_t<T>, std::remove_cv_t<U>>::value,
+                "blit requires matching element types");
+
+  size_t rows = dst.rows() < src.rows() ? dst.rows() : src.rows();
+  size_t cols = dst.cols() < src.cols() ? dst.cols() : src.cols();
+  if (rows == 0 || cols == 0) {
+    return;
+  }
+
+  if (dst.contiguous() && src.contiguous() && cols == dst.cols() &&
+      cols == src.cols()) {
+    detail::copy_row(dst.data(), src.data(), rows * cols);
+    return;
+  }
+
+  for (size_t r = 0; r < rows; ++r) {
+    detail::copy_row(dst.row(r).data(), src.row(r).data(), cols);
+  }
+}
+
+/**
+ * @brief Scroll a view up by n rows, filling the vacated bottom rows
+ */
+template <typename T>
+void scroll_up(span2d<T> view, size_t n,
+               const std::remove_cv_t<T> &value) noexcept {
+  if (n == 0) {
+    return; // copy_row() must not be given overlapping rows
+  }
+  if (n >= view.rows()) {
+    fill(view, value);
+    return;
+  }
+
+  // Top to bottom: each source row is read before it is overwritten
+  for (size_t r = 0; r + n < view.rows(); ++r) {
+    detail::copy_row(view.row(r).data(), view.row(r + n).data(),
+                     view.cols());
+  }
+  fill(view.row_range(view.rows() - n, n), value);
+}
+
+/**
+ * @brief Scroll a view down by n rows, filling the vacated top rows
+ */
+template <typename T>
+void scroll_down(span2d<T> view, size_t n,
+                 const std::remove_cv_t<T> &value) noexcept {
+  if (n == 0) {
+    return;
+  }
+  if (n >= view.rows()) {
+    fill(view, value);
+    return;
+  }
+
+  // Bottom to top: each source row is read before it is overwritten
+  for (size_t r = view.rows(); r-- > n;) {
+    detail::copy_row(view.row(r).data(), view.row(r - n).data(),
+                     view.cols());
+  }
+  fill(view.row_range(0, n), value);
+}
+
+} // namespace v4std
+
+#endif // V4STD_SPAN2D_HPP
@@ -0,0 +1,136 @@
+/**
+ * @file static_ddt.hpp
+ * @brief DdtProvider for build-time generated device tables
+ *
+ * A board's devices are listed in a board_devices.def file:
+ *
+ * @code
+ * // kind     role     index  flags       handle
+ * V4DEV_DEF(LED,    STATUS,  0,     0,          7)
+ * V4DEV_DEF(LED,    USER,    1,     ACTIVE_LOW, 10)
+ * @endcode
+ *
+ * The CMake function v4std_add_board_ddt() turns it into a header with a
+ * constexpr descriptor table, a collision-free hash table over the
+ * (kind, role, index) keys, the table positions in key order, and a
+ * ready Provider class, all in namespace v4std::boards::<board>:
+ *
+ * @code
+ * #include "boards/devkit_ddt.hpp"
+ *
+ * static v4std::boards::devkit::Provider board;
+ * Ddt::set_provider(&board);
+ * @endcode
+ *
+ * Installed alone, the provider answers Ddt::find_device() with one hash
+ * and one compare, and Ddt::devices_of() from the generated key order;
+ * nothing is indexed at runtime.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_STATIC_DDT_HPP
+#define V4STD_STATIC_DDT_HPP
+
+#include "v4std/ddt.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace v4std {
+
+/**
+ * @brief Multiplicative hash of a (kind, role, index) key
+ *
+ * The generator picks a multiplier that maps every key of the board to a
+ * distinct slot of a 2^(32 - shift) entry table.
+ */
+struct DdtPerfectHash {
+  uint32_t multiplier;
+  uint8_t shift; /**< 32 - log2(table size), at most 31 */
+
+  static constexpr uint32_t key(uint32_t kind, uint32_t role,
+                                uint32_t index) {
+    return (kind << 16) | (role << 8) | index;
+  }
+
+  constexpr uint32_t operator()(uint32_t key) const {
+    return static_cast<uint32_t>(key * multiplier) >> shift;
+  }
+};
+
+/** @brief Hash table entry with no device */
+inline constexpr uint16_t kDdtEmptySlot = 0xFFFF;
+
+/**
+ * @brief Check a generated table at compile time
+ *
+ * @return true if every device is found through its own slot and every
+ *         other slot is empty or holds a device that hashes there
+ */
+template <size_t N, size_t M>
+constexpr bool check_perfect_hash(const DeviceDesc (&devices)[N],
+                                  const uint16_t (&slots)[M],
+                                  DdtPerfectHash hash) {
+  if ((static_cast<uint64_t>(1) << (32 - hash.shift)) != M) {
+    return false;
+  }
+  for (size_t i = 0; i < N; ++i) {
+    uint32_t key = DdtPerfectHash::key(devices[i].kind, desc_role(devices[i]),
+                                       devices[i].index);
+    if (slots[hash(key)] != i) {
+      return false;
+    }
+  }
+  for (size_t slot = 0; slot < M; ++slot) {
+    if (slots[slot] == kDdtEmptySlot) {
+      continue;
+    }
+    if (slots[slot] >= N) {
+      return false;
+    }
+    const DeviceDesc &dev = devices[slots[slot]];
+    uint32_t key = DdtPerfectHash::key(dev.kind, desc_role(dev), dev.index);
+    if (hash(key) != slot) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Provider over a generated table
+ *
+ * Usually instantiated through the generated Provider class.
+ */
+class StaticDdtProvider : public DdtProvider {
+public:
+  /**
+   * @param devices Descriptor table
+   * @param slots Hash table: device position or kDdtEmptySlot
+   * @param sorted Device positions in (kind, role, index) order
+   * @param hash Hash mapping keys to slots
+   */
+  StaticDdtProvider(span<const DeviceDesc> devices, span<const uint16_t> slots,
+                    span<const uint16_t> sorted, DdtPerfectHash hash)
+      : devices_(devices), slots_(slots), sorted_(sorted), hash_(hash) {}
+
+  span<const DeviceDesc> get_devices() const override { return devices_; }
+
+  bool has_lookup() const override { return true; }
+
+  const DeviceDesc *lookup(v4dev_kind_t kind, v4dev_role_t role,
+                           uint8_t index) const override;
+
+  span<const uint16_t> sorted_index() const override { return sorted_; }
+
+private:
+  span<const DeviceDesc> devices_;
+  span<const uint16_t> slots_;
+  span<const uint16_t> sorted_;
+  DdtPerfectHash hash_;
+};
+
+} // namespace v4std
+
+#endif // V4STD_STATIC_DDT_HPP
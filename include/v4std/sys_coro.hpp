@@ -0,0 +1,313 @@
+/**
+ * @file sys_coro.hpp
+ * @brief Coroutine-based SYS call handlers (C++20)
+ *
+ * Blocking SYS calls such as V4SYS_BUTTON_WAIT or UART reads can be written
+ * as C++20 coroutines that co_await device events or timers. Suspended
+ * handlers are resumed by CoroScheduler::poll(), and coroutine frames are
+ * taken from a fixed-size pool so no heap is used.
+ *
+ * Only available when compiled as C++20 (V4STD_HAS_COROUTINES == 1).
+ * C++17 builds keep using the plain SysHandler path.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_SYS_CORO_HPP
+#define V4STD_SYS_CORO_HPP
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define V4STD_HAS_COROUTINES 1
+#else
+#define V4STD_HAS_COROUTINES 0
+#endif
+
+#if V4STD_HAS_COROUTINES
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+/** Size of one coroutine frame block in bytes */
+#ifndef V4STD_CORO_FRAME_SIZE
+#define V4STD_CORO_FRAME_SIZE 256
+#endif
+
+/** Maximum number of live coroutine handlers (frame pool capacity) */
+#ifndef V4STD_CORO_MAX_FRAMES
+#define V4STD_CORO_MAX_FRAMES 8
+#endif
+
+/** Maximum number of registered coroutine handlers */
+#ifndef V4STD_CORO_MAX_HANDLERS
+#define V4STD_CORO_MAX_HANDLERS 16
+#endif
+
+namespace v4std {
+
+/**
+ * @brief Fixed-size pool for coroutine frames
+ *
+ * Holds V4STD_CORO_MAX_FRAMES blocks of V4STD_CORO_FRAME_SIZE bytes.
+ * allocate() returns nullptr when the frame does not fit or the pool is
+ * exhausted; the coroutine call then yields an invalid SysTask.
+ */
+class CoroFramePool {
+public:
+  static void *allocate(size_t size) noexcept;
+  static void deallocate(void *ptr) noexcept;
+
+  /** @brief Number of frames currently in use */
+  static size_t in_use() noexcept;
+
+  /** @brief Total number of frames */
+  static constexpr size_t capacity() noexcept { return V4STD_CORO_MAX_FRAMES; }
+};
+
+/**
+ * @brief Coroutine handler return object
+ *
+ * Owns the coroutine frame. The handler starts running immediately and
+ * runs until its first suspension point, so handlers that never block
+ * complete inside the invoking call.
+ *
+ * Destroying a suspended task cancels any pending wait and returns the
+ * frame to the pool.
+ */
+class SysTask {
+public:
+  struct promise_type {
+    int32_t result = 0;
+
+    static void *operator new(size_t size) noexcept {
+      return CoroFramePool::allocate(size);
+    }
+    static void operator delete(void *ptr) noexcept {
+      CoroFramePool::deallocate(ptr);
+    }
+    static SysTask get_return_object_on_allocation_failure() noexcept {
+      return SysTask{};
+    }
+
+    SysTask get_return_object() noexcept {
+      return SysTask{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_value(int32_t value) noexcept { result = value; }
+    void unhandled_exception() noexcept { std::abort(); }
+  };
+
+  using handle_type = std::coroutine_handle<promise_type>;
+
+  SysTask() noexcept = default;
+  explicit SysTask(handle_type handle) noexcept : handle_(handle) {}
+  SysTask(SysTask &&other) noexcept : handle_(other.handle_) {
+    other.handle_ = nullptr;
+  }
+  SysTask &operator=(SysTask &&other) noexcept {
+    if (this != &other) {
+      reset();
+      handle_ = other.handle_;
+      other.handle_ = nullptr;
+    }
+    return *this;
+  }
+  SysTask(const SysTask &) = delete;
+  SysTask &operator=(const SysTask &) = delete;
+  ~SysTask() { reset(); }
+
+  /** @brief true if the task owns a coroutine frame */
+  bool valid() const noexcept { return static_cast<bool>(handle_); }
+
+  /** @brief true once the handler has executed co_return */
+  bool done() const noexcept { return handle_ && handle_.done(); }
+
+  /** @brief Handler result (only meaningful when done()) */
+  int32_t result() const noexcept {
+    return handle_ ? handle_.promise().result : -1;
+  }
+
+  /** @brief Cancel the handler (if suspended) and release its frame */
+  void reset() noexcept;
+
+private:
+  handle_type handle_;
+};
+
+/**
+ * @brief Device event a coroutine handler can co_await
+ *
+ * A platform signals the event (e.g., from a GPIO edge callback) with a
+ * value; the waiting handler is queued and resumed on the next
+ * CoroScheduler::poll(). A signal with no waiter is latched and consumed
+ * by the next co_await. Only one handler may wait on an event at a time.
+ *
+ * Thread safety: signal() must run in the scheduler's context (or with
+ * interrupts masked on MCUs).
+ */
+class CoroEvent {
+public:
+  struct Awaiter {
+    CoroEvent &event;
+    int32_t value = 0;
+
+    bool await_ready() noexcept {
+      if (!event.pending_)
+        return false;
+      event.pending_ = false; // Consume the latched signal
+      value = event.latched_;
+      return true;
+    }
+    bool await_suspend(std::coroutine_handle<> handle) noexcept;
+    int32_t await_resume() const noexcept { return value; }
+  };
+
+  /** @brief Signal the event, waking the waiting handler */
+  void signal(int32_t value) noexcept;
+
+  /** @brief true if a signal is latched and not yet consumed */
+  bool pending() const noexcept { return pending_; }
+
+  Awaiter operator co_await() noexcept { return Awaiter{*this}; }
+
+private:
+  friend class CoroScheduler;
+
+  bool pending_ = false;
+  int32_t latched_ = 0; // Value of a signal nobody was waiting for
+  int16_t waiter_ = -1; // Scheduler wait slot, -1 if none
+};
+
+/**
+ * @brief Awaitable that suspends a handler for a number of milliseconds
+ *
+ * co_await yields false if no scheduler wait slot was free; the handler
+ * then resumes at once without having slept. SysTask handlers always get
+ * a slot (there is one per pool frame), but other coroutines awaiting
+ * sleep_ms() compete for the same slots.
+ *
+ * Example:
+ * @code
+ * bool slept = co_await v4std::sleep_ms(10);
+ * if (!slept) {
+ *   co_return -1;
+ * }
+ * @endcode
+ */
+struct SleepAwaiter {
+  uint32_t ms;
+  bool slept = true;
+
+  bool await_ready() const noexcept { return ms == 0; }
+  bool await_suspend(std::coroutine_handle<> handle) noexcept;
+  bool await_resume() const noexcept { return slept; }
+};
+
+inline SleepAwaiter sleep_ms(uint32_t ms) noexcept {
+  return SleepAwaiter{ms};
+}
+
+/**
+ * @brief Scheduler that resumes suspended coroutine handlers
+ *
+ * The platform calls poll() from its main loop (or VM idle hook) with a
+ * monotonic millisecond clock. Expired timers and signaled events are
+ * resumed in slot order.
+ *
+ * Thread safety: Not thread-safe. All coroutine handlers, events, and
+ * poll() calls must share one execution context.
+ */
+class CoroScheduler {
+public:
+  /**
+   * @brief Advance the clock and resume every ready handler
+   *
+   * @param now_ms Current time in milliseconds (wraps modulo 2^32)
+   * @return Number of handlers resumed
+   */
+  static size_t poll(uint32_t now_ms) noexcept;
+
+  /** @brief Current scheduler time (value of the last poll()) */
+  static uint32_t now() noexcept;
+
+  /** @brief Number of handlers currently suspended */
+  static size_t pending() noexcept;
+
+private:
+  friend class SysTask;
+  friend class CoroEvent;
+  friend struct CoroEvent::Awaiter;
+  friend struct SleepAwaiter;
+
+  static bool add_timer(std::coroutine_handle<> handle, uint32_t ms) noexcept;
+  static bool add_event_waiter(std::coroutine_handle<> handle, CoroEvent &event,
+                               int32_t *value_out) noexcept;
+  static void make_ready(int16_t slot, int32_t value) noexcept;
+  static void cancel(std::coroutine_handle<> handle) noexcept;
+};
+
+/**
+ * @brief Coroutine SYS call handler signature
+ *
+ * Same arguments as SysHandler; the result is delivered via co_return.
+ */
+using SysCoroHandler = SysTask (*)(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                                   int32_t arg2);
+
+/**
+ * @brief Register a coroutine SYS call handler
+ *
+ * If a handler is already registered for this ID, it will be replaced.
+ *
+ * @param sys_id SYS call ID (e.g., V4SYS_BUTTON_WAIT)
+ * @param handler Handler function pointer (must not be null)
+ * @return true on success, false if handler is null or the table is full
+ */
+bool register_sys_coro_handler(uint16_t sys_id, SysCoroHandler handler);
+
+/**
+ * @brief Unregister a coroutine SYS call handler
+ *
+ * @param sys_id SYS call ID
+ */
+void unregister_sys_coro_handler(uint16_t sys_id);
+
+/**
+ * @brief Get registered coroutine handler for a SYS ID
+ *
+ * @param sys_id SYS call ID
+ * @return Handler function pointer, or nullptr if not registered
+ */
+SysCoroHandler get_sys_coro_handler(uint16_t sys_id);
+
+/**
+ * @brief Start a coroutine SYS call handler
+ *
+ * Runs the handler until it completes or first suspends. The caller
+ * polls task.done() (while driving CoroScheduler::poll()) and then
+ * reads task.result().
+ *
+ * @param sys_id SYS call ID
+ * @param arg0 First argument
+ * @param arg1 Second argument
+ * @param arg2 Third argument
+ * @return Task owning the handler, or an invalid task if no handler is
+ *         registered or the frame pool is exhausted
+ */
+SysTask invoke_sys_coro_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                                int32_t arg2);
+
+/**
+ * @brief Clear all registered coroutine handlers
+ */
+void clear_sys_coro_handlers();
+
+} // namespace v4std
+
+#endif // V4STD_HAS_COROUTINES
+
+#endif // V4STD_SYS_CORO_HPP
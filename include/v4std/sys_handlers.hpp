@@ -13,9 +13,48 @@
 #ifndef V4STD_SYS_HANDLERS_HPP
 #define V4STD_SYS_HANDLERS_HPP
 
+#include "v4std/config.hpp"
 #include <cstddef>
 #include <cstdint>
 
+/**
+ * @brief Handler registry capacity in V4STD_NO_HEAP builds
+ *
+ * Set with the CMake cache variable of the same name.
+ */
+#ifndef V4STD_MAX_SYS_HANDLERS
+#define V4STD_MAX_SYS_HANDLERS 64
+#endif
+
+/**
+ * @brief Dispatch from a table generated at build time
+ *
+ * When 1, the handlers listed in the handler manifest (see
+ * v4sys_handlers.def) form a constexpr table in read-only memory, and
+ * registering one of them with its manifest flags stores nothing.
+ * Other registrations go to a RAM overlay of V4STD_SYS_OVERLAY_HANDLERS
+ * entries, which takes precedence over the table. Set with the CMake
+ * option of the same name.
+ */
+#ifndef V4STD_ROM_DISPATCH
+#define V4STD_ROM_DISPATCH 0
+#endif
+
+/**
+ * @brief RAM overlay capacity in V4STD_ROM_DISPATCH builds
+ *
+ * Set with the CMake cache variable of the same name.
+ */
+#ifndef V4STD_SYS_OVERLAY_HANDLERS
+#define V4STD_SYS_OVERLAY_HANDLERS 8
+#endif
+
+/**
+ * @brief Handler registration flags
+ */
+#define V4SYS_HANDLER_DEVICE_LOCK                                              \
+  (1 << 0) /**< Hold the target device's lock (see device_lock.hpp) */
+
 namespace v4std {
 
 /**
@@ -34,6 +73,41 @@ namespace v4std {
 using SysHandler = int32_t (*)(uint16_t sys_id, int32_t arg0, int32_t arg1,
                                int32_t arg2);
 
+/**
+ * @brief Most stack cells a SYS call may consume or produce
+ */
+constexpr size_t kSysMaxCells = 8;
+
+/**
+ * @brief Stack-cell SYS call handler
+ *
+ * For calls whose inputs or results do not fit SysHandler: more than
+ * three inputs, or more than one result. The handler sees the call's
+ * stack cells as they are, with no packing.
+ *
+ * @param sys_id SYS call ID (e.g., V4SYS_I2C_READ_REG)
+ * @param in Input cells, deepest first
+ * @param in_count Number of input cells (the call's in_arity)
+ * @param out Result cells, zeroed, pushed in order after the call
+ * @param out_count Number of result cells (the call's out_arity)
+ */
+using SysCellHandler = void (*)(uint16_t sys_id, const int32_t *in,
+                                size_t in_count, int32_t *out,
+                                size_t out_count);
+
+/**
+ * @brief Registry entry
+ *
+ * Also the row type of the generated ROM dispatch table. At most one of
+ * handler and cell_handler is set.
+ */
+struct SysHandlerEntry {
+  uint16_t sys_id;
+  uint8_t flags;                         /**< V4SYS_HANDLER_* */
+  SysHandler handler;                    /**< Three-argument handler */
+  SysCellHandler cell_handler = nullptr; /**< Stack-cell handler */
+};
+
 /**
  * @brief Register a SYS call handler
  *
@@ -43,17 +117,60 @@ using SysHandler = int32_t (*)(uint16_t sys_id, int32_t arg0, int32_t arg1,
  * Thread safety: Not thread-safe. Registration should occur during
  * initialization before concurrent VM execution.
  *
+ * In V4STD_NO_HEAP builds the registry holds at most
+ * V4STD_MAX_SYS_HANDLERS entries. In V4STD_ROM_DISPATCH builds a
+ * handler already in the ROM table with the same flags is not stored;
+ * anything else takes one of V4STD_SYS_OVERLAY_HANDLERS overlay entries.
+ *
  * @param sys_id SYS call ID (e.g., V4SYS_LED_ON)
  * @param handler Handler function pointer (must not be null)
- * @return true if registration succeeded, false if handler is null
+ * @return true if registration succeeded, false if handler is null or
+ *         the registry is full
  */
 bool register_sys_handler(uint16_t sys_id, SysHandler handler);
 
+/**
+ * @brief Register a SYS call handler with registration flags
+ *
+ * With V4SYS_HANDLER_DEVICE_LOCK, invoke_sys_handler() and
+ * dispatch_sys_call() resolve the device addressed by the call (its
+ * first three inputs: kind, role, index) and hold that device's lock
+ * while the handler runs. Calls on different devices still
+ * run in parallel. If the device does not exist the handler runs
+ * unlocked.
+ *
+ * @param sys_id SYS call ID
+ * @param handler Handler function pointer (must not be null)
+ * @param flags V4SYS_HANDLER_* flags
+ * @return true if registration succeeded (see above)
+ */
+bool register_sys_handler(uint16_t sys_id, SysHandler handler, uint8_t flags);
+
+/**
+ * @brief Register a stack-cell SYS call handler
+ *
+ * Replaces any handler registered for the ID, as register_sys_handler()
+ * does, and takes the same flags and registry space. Only IDs defined in
+ * v4sys_ids.def can be registered, since the cell counts come from the
+ * generated metadata.
+ *
+ * @param sys_id SYS call ID
+ * @param handler Handler function pointer (must not be null)
+ * @param flags V4SYS_HANDLER_* flags
+ * @return true if registration succeeded, false if handler is null, the
+ *         ID is undefined, or the registry is full
+ */
+bool register_sys_cell_handler(uint16_t sys_id, SysCellHandler handler,
+                               uint8_t flags = 0);
+
 /**
  * @brief Unregister a SYS call handler
  *
  * Removes the handler for the specified SYS ID.
- * If no handler is registered, this is a no-op.
+ * If no handler is registered, this is a no-op. In V4STD_ROM_DISPATCH
+ * builds this also hides the ROM table entry, without taking an overlay
+ * entry, until the handler is registered again or
+ * clear_sys_handlers() runs.
  *
  * @param sys_id SYS call ID
  */
@@ -65,16 +182,40 @@ void unregister_sys_handler(uint16_t sys_id);
  * Looks up the handler function for the given SYS ID.
  *
  * @param sys_id SYS call ID
- * @return Handler function pointer, or nullptr if not registered
+ * @return Handler function pointer, or nullptr if not registered (or
+ *         registered as a stack-cell handler)
  */
 SysHandler get_sys_handler(uint16_t sys_id);
 
+/**
+ * @brief Get the registered stack-cell handler for a SYS ID
+ *
+ * @param sys_id SYS call ID
+ * @return Handler function pointer, or nullptr if the ID has none
+ */
+SysCellHandler get_sys_cell_handler(uint16_t sys_id);
+
+/**
+ * @brief Get registration flags for a SYS ID
+ *
+ * @param sys_id SYS call ID
+ * @return V4SYS_HANDLER_* flags, or 0 if no handler is registered
+ */
+uint8_t get_sys_handler_flags(uint16_t sys_id);
+
 /**
  * @brief Invoke a SYS call handler
  *
  * Looks up and invokes the handler for the given SYS ID.
  * If no handler is registered, returns an error code (-1).
  *
+ * Stack-cell handlers receive arg0..arg2 as their first in_arity cells
+ * and report their first result cell (0 if the call has none). A fourth
+ * input travels packed into arg2 as (cell2 << 16) | (cell3 & 0xFFFF),
+ * so both halves are limited to 16 bits; calls with wider or more inputs
+ * go through invoke_sys_cells() or dispatch_sys_call() (more than four
+ * inputs return -1 here).
+ *
  * @param sys_id SYS call ID
  * @param arg0 First argument
  * @param arg1 Second argument
@@ -84,11 +225,97 @@ SysHandler get_sys_handler(uint16_t sys_id);
 int32_t invoke_sys_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
                            int32_t arg2);
 
+/**
+ * @brief Invoke a SYS call handler with its input cells
+ *
+ * The cell form of invoke_sys_handler(), with no packing. Stack-cell
+ * handlers receive in, zero-padded to the call's in_arity, and report
+ * their first result cell; a SysHandler receives in[0..2]. Replays trace
+ * records exactly as they were recorded.
+ *
+ * @param sys_id SYS call ID
+ * @param in Input cells, deepest first
+ * @param in_count Number of input cells (at most kSysMaxCells)
+ * @return Handler result, or -1 if no handler registered or in_count is
+ *         out of range
+ */
+int32_t invoke_sys_cells(uint16_t sys_id, const int32_t *in, size_t in_count);
+
+/**
+ * @brief SYS call trace hook
+ *
+ * Called after every handler invocation made through invoke_sys_handler(),
+ * invoke_sys_cells() or dispatch_sys_call(), with the call's input cells
+ * and its first result. The cells are the three invoke_sys_handler()
+ * arguments (unpacked to in_arity cells for a stack-cell handler), the
+ * cells given to invoke_sys_cells(), or the in_arity cells popped by
+ * dispatch_sys_call(), so invoke_sys_cells() repeats any traced call.
+ * Calls with no registered handler are reported with result -1.
+ *
+ * @param context Pointer passed to set_sys_trace_hook()
+ * @param in Input cells, deepest first
+ * @param in_count Number of input cells (at most kSysMaxCells)
+ */
+using SysTraceHook = void (*)(void *context, uint16_t sys_id,
+                              const int32_t *in, size_t in_count,
+                              int32_t result);
+
+/**
+ * @brief Install or remove the SYS call trace hook
+ *
+ * Thread safety: Not thread-safe. Install the hook while no VM thread is
+ * making SYS calls.
+ *
+ * @param hook Hook function, or nullptr to disable tracing
+ * @param context Passed to every hook call
+ */
+void set_sys_trace_hook(SysTraceHook hook, void *context);
+
+/**
+ * @brief Result of a stack-based SYS call dispatch
+ */
+enum class SysCallStatus : uint8_t {
+  Ok = 0,         /**< Handler ran; results pushed */
+  UnknownId,      /**< SYS ID not defined in v4sys_ids.def */
+  NoHandler,      /**< No handler registered */
+  StackUnderflow, /**< Fewer stack cells than the call consumes */
+  StackOverflow,  /**< Not enough room for the call's results */
+  BadArity,       /**< Arity not expressible through SysHandler */
+  Blocking,       /**< Blocking call: route to the async path */
+};
+
+/**
+ * @brief Dispatch a SYS call against a VM data stack
+ *
+ * Uses the generated SYS metadata to validate the call before entering
+ * the handler: exactly in_arity cells are popped and out_arity cells are
+ * pushed. Malformed calls leave the stack untouched.
+ *
+ * The stack grows upward (stack[depth - 1] is top of stack). Input cells
+ * map to arg0..arg2 from deepest to top. Stack-cell handlers receive all
+ * input cells and fill all result cells, whatever the call's arity. A
+ * SysHandler can only serve calls with at most three inputs and one
+ * result; other calls to one are rejected with SysCallStatus::BadArity.
+ *
+ * Calls flagged V4SYS_FLAG_BLOCKING are not executed; the stack is left
+ * untouched and SysCallStatus::Blocking is returned so the VM can hand
+ * the call to its async path (e.g., invoke_sys_coro_handler()).
+ *
+ * @param sys_id SYS call ID
+ * @param stack Data stack cells
+ * @param depth Current stack depth (updated on success)
+ * @param capacity Stack capacity in cells
+ * @return SysCallStatus::Ok on success, otherwise the reason for rejection
+ */
+SysCallStatus dispatch_sys_call(uint16_t sys_id, int32_t *stack, size_t &depth,
+                                size_t capacity);
+
 /**
  * @brief Clear all registered SYS handlers
  *
  * Removes all handler registrations.
- * Useful for testing or re-initialization.
+ * Useful for testing or re-initialization. In V4STD_ROM_DISPATCH builds
+ * this empties the overlay, leaving the ROM table.
  */
 void clear_sys_handlers();
 
@@ -12,6 +12,7 @@
 #ifndef V4STD_SYS_LED_HPP
 #define V4STD_SYS_LED_HPP
 
+#include <cstddef>
 #include <cstdint>
 
 namespace v4std {
@@ -66,10 +67,24 @@ void set_led_hal(LedHal *hal);
  * - V4SYS_LED_SET
  * - V4SYS_LED_GET
  *
+ * Handlers are registered with V4SYS_HANDLER_DEVICE_LOCK, so VM threads
+ * can drive different LEDs in parallel and the LedHal only sees one call
+ * per handle at a time.
+ *
  * Must be called after set_led_hal() and Ddt::set_provider().
  */
 void register_led_sys_handlers();
 
+// Handlers installed by register_led_sys_handlers(), which the ROM dispatch
+// table (v4sys_handlers.def) refers to directly
+int32_t sys_led_on(uint16_t sys_id, int32_t arg0, int32_t arg1, int32_t arg2);
+int32_t sys_led_off(uint16_t sys_id, int32_t arg0, int32_t arg1, int32_t arg2);
+int32_t sys_led_toggle(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                       int32_t arg2);
+void sys_led_set(uint16_t sys_id, const int32_t *in, size_t in_count,
+                 int32_t *out, size_t out_count);
+int32_t sys_led_get(uint16_t sys_id, int32_t arg0, int32_t arg1, int32_t arg2);
+
 } // namespace v4std
 
 #endif // V4STD_SYS_LED_HPP
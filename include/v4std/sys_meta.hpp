@@ -0,0 +1,179 @@
+/**
+ * @file sys_meta.hpp
+ * @brief SYS call metadata (stack arity, device kind, flags)
+ *
+ * Metadata is generated from v4sys_ids.def into sys_meta_table.h and lets
+ * the dispatcher validate a call before entering its handler.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_SYS_META_HPP
+#define V4STD_SYS_META_HPP
+
+#include "v4std/ddt_types.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief SYS call flags
+ */
+#define V4SYS_FLAG_PURE (1 << 0)     /**< No side effects (query only) */
+#define V4SYS_FLAG_BLOCKING (1 << 1) /**< May block on a device event */
+
+/**
+ * @brief Include SYS name/description tables (sys_name(), sys_description())
+ *
+ * Enabled by default; size-optimized builds can define V4STD_SYS_NAMES=0
+ * (CMake: -DV4STD_SYS_NAMES=OFF) to strip the string tables.
+ */
+#ifndef V4STD_SYS_NAMES
+#define V4STD_SYS_NAMES 1
+#endif
+
+namespace v4std {
+
+/**
+ * @brief Metadata for one SYS call (6 bytes, POD type)
+ */
+struct SysMeta {
+  uint16_t id;       /**< SYS call ID (V4SYS_*) */
+  uint8_t in_arity;  /**< Stack cells consumed */
+  uint8_t out_arity; /**< Stack cells produced */
+  uint8_t kind;      /**< Device kind (v4dev_kind_t) or V4DEV_NONE */
+  uint8_t flags;     /**< V4SYS_FLAG_* */
+};
+
+/**
+ * @brief Device kind owning the range a SYS ID falls in
+ *
+ * Ranges are 0x0100 wide (see v4sys_ids.def). The system/capability range
+ * 0x0F00-0x0FFF maps to V4DEV_NONE.
+ *
+ * @param sys_id SYS call ID
+ * @return v4dev_kind_t value, or 0xFF if the range is unassigned
+ */
+constexpr uint8_t sys_range_kind(uint16_t sys_id) {
+  switch (sys_id >> 8) {
+  case 0x01:
+    return V4DEV_LED;
+  case 0x02:
+    return V4DEV_BUTTON;
+  case 0x03:
+    return V4DEV_TIMER;
+  case 0x04:
+    return V4DEV_UART;
+  case 0x05:
+    return V4DEV_I2C;
+  case 0x06:
+    return V4DEV_SPI;
+  case 0x07:
+    return V4DEV_ADC;
+  case 0x08:
+    return V4DEV_PWM;
+  case 0x09:
+    return V4DEV_STORAGE;
+  case 0x0A:
+    return V4DEV_DISPLAY;
+  case 0x0B:
+    return V4DEV_RNG;
+  case 0x0F:
+    return V4DEV_NONE;
+  default:
+    return 0xFF;
+  }
+}
+
+} // namespace v4std
+
+#include "v4std/sys_meta_table.h"
+
+namespace v4std {
+
+/**
+ * @brief Dense ordinal of a SYS ID
+ *
+ * Binary search over sys_ids_sorted. Use the result to index
+ * sys_meta_table or fixed-size per-call arrays sized by sys_id_count.
+ *
+ * @param sys_id SYS call ID
+ * @return Ordinal in [0, sys_id_count), or sys_id_count if undefined
+ */
+constexpr size_t sys_ordinal(uint16_t sys_id) {
+  size_t lo = 0;
+  size_t hi = sys_id_count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (sys_ids_sorted[mid] < sys_id) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo < sys_id_count && sys_ids_sorted[lo] == sys_id) ? lo
+                                                             : sys_id_count;
+}
+
+/**
+ * @brief Look up metadata for a SYS ID
+ *
+ * @param sys_id SYS call ID
+ * @return Pointer to metadata, or nullptr if the ID is not defined
+ */
+constexpr const SysMeta *find_sys_meta(uint16_t sys_id) {
+  size_t ordinal = sys_ordinal(sys_id);
+  return ordinal < sys_meta_count ? &sys_meta_table[ordinal] : nullptr;
+}
+
+/**
+ * @brief Name of a SYS call (e.g., "LED_ON")
+ *
+ * The string tables live in read-only data. Returns nullptr when the ID
+ * is undefined or the tables are stripped (V4STD_SYS_NAMES == 0).
+ *
+ * @param sys_id SYS call ID
+ * @return NUL-terminated name, or nullptr
+ */
+constexpr const char *sys_name(uint16_t sys_id) {
+#if V4STD_SYS_NAMES
+  size_t ordinal = sys_ordinal(sys_id);
+  return ordinal < sys_id_count ? sys_name_pool + sys_name_offsets[ordinal]
+                                : nullptr;
+#else
+  (void)sys_id;
+  return nullptr;
+#endif
+}
+
+/**
+ * @brief Description of a SYS call, as written in v4sys_ids.def
+ *
+ * @param sys_id SYS call ID
+ * @return NUL-terminated description, or nullptr (see sys_name())
+ */
+constexpr const char *sys_description(uint16_t sys_id) {
+#if V4STD_SYS_NAMES
+  size_t ordinal = sys_ordinal(sys_id);
+  return ordinal < sys_id_count
+             ? sys_description_pool + sys_description_offsets[ordinal]
+             : nullptr;
+#else
+  (void)sys_id;
+  return nullptr;
+#endif
+}
+
+/** @brief true if the SYS call has no side effects */
+constexpr bool sys_is_pure(const SysMeta &meta) {
+  return (meta.flags & V4SYS_FLAG_PURE) != 0;
+}
+
+/** @brief true if the SYS call may block and needs the async path */
+constexpr bool sys_is_blocking(const SysMeta &meta) {
+  return (meta.flags & V4SYS_FLAG_BLOCKING) != 0;
+}
+
+} // namespace v4std
+
+#endif // V4STD_SYS_META_HPP
@@ -0,0 +1,161 @@
+/**
+ * @file sys_trace.hpp
+ * @brief SYS call recorder and trace log reader
+ *
+ * SysTraceRecorder captures the SYS call stream (ID, input cells,
+ * result, inter-arrival time) into a caller-provided buffer using a
+ * compact binary format. SysTraceReader decodes it again; the replayer in
+ * the v4std_sim library drives a registry from the log.
+ *
+ * Log format (little-endian, LEB128 varints):
+ * - Header: "V4TR" magic, format version byte (2)
+ * - Records: varint delta_us, varint sys_id, varint in_count, then
+ *   zigzag varints for each input cell and the result
+ *
+ * Every cell is kept whole, so calls replay exactly through
+ * invoke_sys_cells(). A typical LED call encodes in 7-9 bytes.
+ *
+ * @copyright Copyright 2025 V4 Project
+ * @license Dual-licensed under MIT or Apache-2.0
+ */
+
+#ifndef V4STD_SYS_TRACE_HPP
+#define V4STD_SYS_TRACE_HPP
+
+#include "v4std/span.hpp"
+#include "v4std/sys_handlers.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace v4std {
+
+/** @brief Trace log format version written by SysTraceRecorder */
+inline constexpr uint8_t kSysTraceVersion = 2;
+
+/** @brief Size of the trace log header in bytes */
+inline constexpr size_t kSysTraceHeaderSize = 5;
+
+/**
+ * @brief Largest encoded record: delta (5) + ID (3) + count (1) + cells
+ *        and result (5 each)
+ */
+inline constexpr size_t kSysTraceMaxRecordSize =
+    5 + 3 + 1 + (kSysMaxCells + 1) * 5;
+
+/**
+ * @brief One recorded SYS call
+ */
+struct SysTraceRecord {
+  uint32_t delta_us;        /**< Time since the previous record (us) */
+  uint16_t sys_id;          /**< SYS call ID */
+  uint8_t in_count;         /**< Input cells used (<= kSysMaxCells) */
+  int32_t in[kSysMaxCells]; /**< Input cells, deepest first */
+  int32_t result;           /**< Handler result */
+};
+
+/**
+ * @brief Microsecond clock for the recorder (wraps at 2^32)
+ */
+using SysTraceClock = uint32_t (*)();
+
+/**
+ * @brief Records SYS calls into a caller-provided buffer
+ *
+ * attach() installs the recorder as the SYS trace hook. Recording stops
+ * when the buffer is full; further calls are counted in dropped().
+ *
+ * Thread safety: Not thread-safe. Record from one VM thread, or
+ * serialize SYS calls while attached.
+ */
+class SysTraceRecorder {
+public:
+  /**
+   * @param buffer Log storage (at least kSysTraceHeaderSize bytes)
+   * @param clock Microsecond clock used to time stamp calls
+   */
+  SysTraceRecorder(span<uint8_t> buffer, SysTraceClock clock);
+
+  /** @brief Install as the SYS trace hook (see set_sys_trace_hook()) */
+  void attach();
+
+  /** @brief Remove the SYS trace hook */
+  void detach();
+
+  /**
+   * @brief Append one record
+   *
+   * @return false if the record did not fit or has more than
+   *         kSysMaxCells inputs (counted in dropped())
+   */
+  bool record(const SysTraceRecord &rec);
+
+  /**
+   * @brief Record a call, time stamped with the recorder's clock
+   */
+  bool record_call(uint16_t sys_id, const int32_t *in, size_t in_count,
+                   int32_t result);
+
+  /** @brief Discard all records and restart the clock */
+  void reset();
+
+  /** @brief Encoded log (header and records) */
+  span<const uint8_t> data() const {
+    return span<const uint8_t>{buffer_.data(), size_};
+  }
+
+  /** @brief Number of records written */
+  size_t record_count() const { return count_; }
+
+  /** @brief Number of records dropped because the buffer was full */
+  size_t dropped() const { return dropped_; }
+
+private:
+  static void trace_hook(void *context, uint16_t sys_id, const int32_t *in,
+                         size_t in_count, int32_t result);
+
+  span<uint8_t> buffer_;
+  SysTraceClock clock_;
+  size_t size_ = 0;
+  size_t count_ = 0;
+  size_t dropped_ = 0;
+  uint32_t last_us_ = 0;
+  bool started_ = false;
+};
+
+/**
+ * @brief Decodes a trace log record by record
+ */
+class SysTraceReader {
+public:
+  explicit SysTraceReader(span<const uint8_t> log);
+
+  /** @brief true if the log has a valid header */
+  bool valid() const { return valid_; }
+
+  /**
+   * @brief Decode the next record
+   *
+   * @param rec Receives the record
+   * @return false at the end of the log or on a malformed record
+   */
+  bool next(SysTraceRecord &rec);
+
+  /** @brief true if decoding stopped on a truncated or malformed record */
+  bool error() const { return error_; }
+
+  /** @brief Restart from the first record */
+  void rewind() {
+    pos_ = kSysTraceHeaderSize;
+    error_ = false;
+  }
+
+private:
+  span<const uint8_t> log_;
+  size_t pos_ = kSysTraceHeaderSize;
+  bool valid_ = false;
+  bool error_ = false;
+};
+
+} // namespace v4std
+
+#endif // V4STD_SYS_TRACE_HPP
@@ -0,0 +1,127 @@
+/**
+ * @file capability.cpp
+ * @brief Capability SYS call implementation
+ */
+
+#include "v4std/capability.hpp"
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_types.h"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include <cstring>
+
+namespace v4std {
+
+// VM memory CAP_ENUM writes into
+static span<uint8_t> cap_memory;
+
+void set_cap_memory(span<uint8_t> memory) { cap_memory = memory; }
+
+// DDT keys are bytes; anything wider would alias another device
+static bool key_byte(int32_t value) { return value >= 0 && value <= 0xFF; }
+
+static const DeviceDesc *find_cap(int32_t kind, int32_t role, int32_t index) {
+  if (!key_byte(kind) || !key_byte(role) || !key_byte(index)) {
+    return nullptr;
+  }
+
+  return Ddt::find_device(static_cast<v4dev_kind_t>(kind),
+                          static_cast<v4dev_role_t>(role),
+                          static_cast<uint8_t>(index));
+}
+
+// SYS_CAP_COUNT handler
+int32_t sys_cap_count(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                      int32_t arg2) {
+  (void)sys_id;
+  (void)arg1;
+  (void)arg2;
+
+  if (!key_byte(arg0)) {
+    return 0;
+  }
+  return static_cast<int32_t>(
+      Ddt::count_devices(static_cast<v4dev_kind_t>(arg0)));
+}
+
+// SYS_CAP_EXISTS handler
+int32_t sys_cap_exists(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                       int32_t arg2) {
+  (void)sys_id;
+
+  return find_cap(arg0, arg1, arg2) ? 1 : 0;
+}
+
+// SYS_CAP_FLAGS handler
+int32_t sys_cap_flags(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                      int32_t arg2) {
+  (void)sys_id;
+
+  const DeviceDesc *dev = find_cap(arg0, arg1, arg2);
+  return dev ? desc_flags(*dev) : -1;
+}
+
+// SYS_CAP_HANDLE handler
+int32_t sys_cap_handle(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                       int32_t arg2) {
+  (void)sys_id;
+
+  const DeviceDesc *dev = find_cap(arg0, arg1, arg2);
+  return dev ? static_cast<int32_t>(dev->handle) : -1;
+}
+
+// SYS_CAP_ENUM handler: ( kind role max addr -- count )
+void sys_cap_enum(uint16_t sys_id, const int32_t *in, size_t in_count,
+                  int32_t *out, size_t out_count) {
+  (void)sys_id;
+  (void)in_count;
+  (void)out_count;
+
+  size_t max = in[2] < 0 ? 0 : static_cast<size_t>(in[2]);
+  size_t addr = static_cast<uint32_t>(in[3]);
+  out[0] = -1;
+
+  // No device has an out-of-range kind or role: an empty group
+  if (!key_byte(in[0]) || (in[1] != -1 && !key_byte(in[1]))) {
+    out[0] = cap_memory.data() ? 0 : -1;
+    return;
+  }
+
+  // Keep the group valid while copying it
+  Ddt::ReadGuard guard;
+  v4dev_kind_t kind = static_cast<v4dev_kind_t>(in[0]);
+  DeviceList group;
+  bool grouped =
+      in[1] < 0
+          ? Ddt::try_devices_of(kind, group)
+          : Ddt::try_devices_of(kind, static_cast<v4dev_role_t>(in[1]), group);
+  if (!grouped) {
+    return; // Devices may exist but cannot be enumerated
+  }
+
+  size_t count = group.size() < max ? group.size() : max;
+  size_t bytes = count * sizeof(v4dev_desc_t);
+  if (!cap_memory.data() || addr > cap_memory.size() ||
+      bytes > cap_memory.size() - addr) {
+    return;
+  }
+
+  // Always the 8-byte C layout, whatever the build's descriptor layout
+  uint8_t *dest = cap_memory.data() + addr;
+  for (size_t i = 0; i < count; ++i) {
+    v4dev_desc_t desc = to_c_desc(group[i]);
+    std::memcpy(dest + i * sizeof(v4dev_desc_t), &desc, sizeof(desc));
+  }
+
+  out[0] = static_cast<int32_t>(group.size());
+}
+
+void register_cap_sys_handlers() {
+  register_sys_handler(V4SYS_CAP_COUNT, sys_cap_count);
+  register_sys_handler(V4SYS_CAP_EXISTS, sys_cap_exists);
+  register_sys_handler(V4SYS_CAP_FLAGS, sys_cap_flags);
+  register_sys_handler(V4SYS_CAP_HANDLE, sys_cap_handle);
+  register_sys_cell_handler(V4SYS_CAP_ENUM, sys_cap_enum);
+}
+
+} // namespace v4std
@@ -4,23 +4,683 @@
  */
 
 #include "v4std/ddt.hpp"
+#include "v4std/config.hpp"
+#include "v4std/device_lock.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <functional>
+#include <iterator>
 
 namespace v4std {
 
-// Static member initialization
-DdtProvider *Ddt::provider_ = nullptr;
+// ============================================================================
+// Snapshot Publication
+// ============================================================================
 
-void Ddt::set_provider(DdtProvider *provider) { provider_ = provider; }
+struct ProviderEntry {
+  DdtProvider *provider;
+  int priority;
+};
 
-const v4dev_desc_t *Ddt::find_device(v4dev_kind_t kind, v4dev_role_t role,
-                                     uint8_t index) {
-  if (!provider_)
+#if V4STD_DDT_SOA
+// Queries scan the mirror in blocks of this many devices
+static constexpr size_t kQueryBlock = 64;
+static constexpr size_t kMirrorSlots =
+    (V4STD_DDT_MAX_DEVICES + kQueryBlock - 1) / kQueryBlock * kQueryBlock;
+
+// get_all_devices() split by field. Slots past count are stale; queries
+// compute them but never report them.
+struct DdtMirror {
+  alignas(V4STD_CACHE_LINE_SIZE) uint8_t kind[kMirrorSlots];
+  alignas(V4STD_CACHE_LINE_SIZE) uint8_t role[kMirrorSlots];
+  alignas(V4STD_CACHE_LINE_SIZE) uint8_t index[kMirrorSlots];
+  alignas(V4STD_CACHE_LINE_SIZE) uint8_t flags[kMirrorSlots];
+  alignas(V4STD_CACHE_LINE_SIZE) uint32_t handle[kMirrorSlots];
+  size_t count;
+  bool valid; // false if the devices do not fit
+};
+#endif
+
+// (kind, role) groups covered by the presence filter: every defined kind
+// and role, with room to spare. Keys outside fall back to a full search.
+static constexpr uint32_t kPresenceKinds = 16;
+static constexpr uint32_t kPresenceRoles = 8;
+static constexpr uint32_t kPresenceGroups = kPresenceKinds * kPresenceRoles;
+
+// Which groups have devices, and the highest index in each, so that a
+// miss is answered without touching the descriptors
+struct DdtPresence {
+  uint32_t present[kPresenceGroups / 32];
+  uint8_t max_index[kPresenceGroups];
+};
+
+#if V4STD_DDT_MERGED_INDEX
+// Position index capacity: the bytes of the merged index, as uint16_t
+static constexpr size_t kPositionSlots =
+    V4STD_DDT_MAX_DEVICES * sizeof(const DeviceDesc *) / sizeof(uint16_t);
+static constexpr size_t kMaxPositioned =
+    kPositionSlots < 0x10000 ? kPositionSlots : 0x10000;
+#endif
+
+// Providers, generation and merged index are published together so a
+// reader never pairs one provider list with another's index. Writers
+// alternate between two buffers: after a grace period the previous
+// buffer is unreferenced.
+struct DdtSnapshot {
+  ProviderEntry providers[V4STD_DDT_MAX_PROVIDERS];
+  size_t provider_count;
+  uint32_t generation;
+
+  // Sorted by (kind, role, index), one entry per key. Unused when a
+  // single provider keeps its own index or is larger than this one; a
+  // larger, unsorted table reuses the storage for 16-bit positions.
+#if V4STD_DDT_MERGED_INDEX
+  union {
+    const DeviceDesc *index[V4STD_DDT_MAX_DEVICES];
+    uint16_t positions[kPositionSlots];
+  };
+  size_t index_count;
+  bool positioned; // positions[] sorts the single provider's table
+#endif
+  bool table_sorted; // The single provider's table is in key order
+  bool indexed;
+  bool provider_lookup;
+
+  DdtPresence presence;
+
+#if V4STD_DDT_SOA
+  DdtMirror mirror;
+#endif
+};
+
+static DdtSnapshot snapshots[2];
+static std::atomic<const DdtSnapshot *> current_snapshot{&snapshots[0]};
+static std::atomic<bool> writer_busy{false};
+
+// Epoch-based reclamation: an active reader stores the epoch it entered
+// at (0 = slot free); writers advance the epoch and wait out older readers
+struct alignas(V4STD_CACHE_LINE_SIZE) ReaderSlot {
+  std::atomic<uint64_t> epoch{0};
+};
+
+static ReaderSlot reader_slots[V4STD_DDT_READER_SLOTS];
+static std::atomic<uint64_t> global_epoch{1};
+static std::atomic<uint32_t> overflow_readers{0};
+static std::atomic<uint32_t> next_reader_slot{0};
+
+static constexpr uint32_t kReaderSlots = V4STD_DDT_READER_SLOTS;
+static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+static V4STD_THREAD_LOCAL uint32_t read_depth = 0;
+static V4STD_THREAD_LOCAL uint32_t read_slot = kNoSlot;
+static V4STD_THREAD_LOCAL bool read_overflow = false;
+
+void Ddt::read_lock() {
+  if (read_depth++ > 0) {
+    return;
+  }
+
+  // Spread threads over the slots, round robin on first use
+  if (read_slot == kNoSlot) {
+    read_slot = next_reader_slot.fetch_add(1, std::memory_order_relaxed) %
+                kReaderSlots;
+  }
+
+  // Acquire pairs with the writer's fetch_add in wait_for_readers(): a
+  // reader that sees the new epoch also sees the snapshot published
+  // before it, so the writer may rightly skip its slot
+  uint64_t epoch = global_epoch.load(std::memory_order_acquire);
+
+  // One CAS per slot at most, starting from the slot used last time
+  for (uint32_t i = 0; i < kReaderSlots; ++i) {
+    uint32_t slot = (read_slot + i) % kReaderSlots;
+    uint64_t expected = 0;
+    if (reader_slots[slot].epoch.compare_exchange_strong(
+            expected, epoch, std::memory_order_seq_cst)) {
+      read_slot = slot;
+      read_overflow = false;
+      return;
+    }
+  }
+
+  overflow_readers.fetch_add(1, std::memory_order_seq_cst);
+  read_overflow = true;
+}
+
+void Ddt::read_unlock() {
+  if (--read_depth > 0) {
+    return;
+  }
+
+  if (read_overflow) {
+    overflow_readers.fetch_sub(1, std::memory_order_release);
+  } else {
+    reader_slots[read_slot].epoch.store(0, std::memory_order_release);
+  }
+}
+
+bool Ddt::in_read_section() { return read_depth > 0; }
+
+// Wait until every reader that entered before now has left
+static void wait_for_readers() {
+  uint64_t epoch = global_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+  for (auto &slot : reader_slots) {
+    for (;;) {
+      uint64_t entered = slot.epoch.load(std::memory_order_seq_cst);
+      if (entered == 0 || entered >= epoch) {
+        break;
+      }
+      V4STD_CPU_RELAX();
+    }
+  }
+
+  while (overflow_readers.load(std::memory_order_seq_cst) != 0) {
+    V4STD_CPU_RELAX();
+  }
+}
+
+static const DdtSnapshot &snapshot() {
+  return *current_snapshot.load(std::memory_order_seq_cst);
+}
+
+// ============================================================================
+// Merged Index
+// ============================================================================
+
+static inline uint32_t key_of(const DeviceDesc &dev) {
+  return (static_cast<uint32_t>(dev.kind) << 16) |
+         (static_cast<uint32_t>(desc_role(dev)) << 8) | dev.index;
+}
+
+static inline uint32_t key_of(v4dev_kind_t kind, v4dev_role_t role,
+                              uint8_t index) {
+  return (static_cast<uint32_t>(kind) << 16) |
+         (static_cast<uint32_t>(role) << 8) | index;
+}
+
+// Slot of desc in table. std::less gives a total order even when desc
+// points into an unrelated array, where the built-in < is unspecified.
+static bool slot_in(const DeviceDesc *table, size_t size,
+                    const DeviceDesc *desc, size_t &slot) {
+  std::less<const DeviceDesc *> before;
+  if (before(desc, table) || !before(desc, table + size)) {
+    return false;
+  }
+  slot = static_cast<size_t>(desc - table);
+  return true;
+}
+
+// true if a provider's table is in key order, so that it groups itself
+static bool table_sorted(const DdtProvider &provider) {
+  span<const DeviceDesc> table = provider.get_devices();
+  return std::is_sorted(
+      table.begin(), table.end(), [](const DeviceDesc &a, const DeviceDesc &b) {
+        return key_of(a) < key_of(b);
+      });
+}
+
+#if V4STD_DDT_MERGED_INDEX
+// Writer-only scratch: candidates before deduplication
+struct Candidate {
+  const DeviceDesc *desc;
+  size_t rank; // Provider precedence, 0 = highest
+};
+
+static Candidate candidates[V4STD_DDT_MAX_DEVICES];
+
+// Rank of a provider: how many providers beat it on priority, ties going
+// to the one added first
+static size_t rank_of(const DdtSnapshot &snap, size_t which) {
+  size_t rank = 0;
+  for (size_t i = 0; i < snap.provider_count; ++i) {
+    int p = snap.providers[i].priority;
+    int q = snap.providers[which].priority;
+    if (p > q || (p == q && i < which)) {
+      ++rank;
+    }
+  }
+  return rank;
+}
+
+// A single table too large for the index: sort its positions instead
+// if they fit. Repeated keys keep their table order.
+static void build_positions(DdtSnapshot &snap) {
+  span<const DeviceDesc> table = snap.providers[0].provider->get_devices();
+  if (snap.table_sorted || table.size() > kMaxPositioned) {
+    return;
+  }
+
+  for (size_t i = 0; i < table.size(); ++i) {
+    snap.positions[i] = static_cast<uint16_t>(i);
+  }
+  std::sort(snap.positions, snap.positions + table.size(),
+            [&table](uint16_t a, uint16_t b) {
+              uint32_t ka = key_of(table[a]);
+              uint32_t kb = key_of(table[b]);
+              return ka != kb ? ka < kb : a < b;
+            });
+  snap.index_count = table.size();
+  snap.positioned = true;
+}
+
+// Fill snap.index from snap.providers. Returns false if several
+// providers together exceed the index capacity.
+static bool build_index(DdtSnapshot &snap) {
+  size_t total = 0;
+  for (size_t i = 0; i < snap.provider_count; ++i) {
+    total += snap.providers[i].provider->get_devices().size();
+  }
+
+  snap.index_count = 0;
+  snap.positioned = false;
+  snap.provider_lookup =
+      snap.provider_count == 1 && snap.providers[0].provider->has_lookup();
+  snap.table_sorted =
+      snap.provider_count == 1 && table_sorted(*snap.providers[0].provider);
+
+  // A provider with its own lookup is indexed only to group its devices
+  bool own_index = snap.provider_lookup &&
+                   !snap.providers[0].provider->sorted_index().empty();
+  snap.indexed =
+      !own_index && !snap.table_sorted && total <= V4STD_DDT_MAX_DEVICES;
+  if (!snap.indexed) {
+    if (snap.provider_count == 1 && !own_index) {
+      build_positions(snap);
+    }
+    return snap.provider_count <= 1;
+  }
+
+  size_t count = 0;
+  for (size_t i = 0; i < snap.provider_count; ++i) {
+    size_t rank = rank_of(snap, i);
+    for (const auto &dev : snap.providers[i].provider->get_devices()) {
+      candidates[count++] = {&dev, rank};
+    }
+  }
+
+  // Winner of each key first: by rank, then by position in its table
+  std::sort(candidates, candidates + count,
+            [](const Candidate &a, const Candidate &b) {
+              uint32_t ka = key_of(*a.desc);
+              uint32_t kb = key_of(*b.desc);
+              if (ka != kb) {
+                return ka < kb;
+              }
+              if (a.rank != b.rank) {
+                return a.rank < b.rank;
+              }
+              return a.desc < b.desc;
+            });
+
+  // Each key keeps the entries of its best-ranked provider only. Repeats
+  // within that provider stay, as they do in its own table.
+  size_t winner_rank = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const DeviceDesc *desc = candidates[i].desc;
+    if (snap.index_count > 0 &&
+        key_of(*snap.index[snap.index_count - 1]) == key_of(*desc) &&
+        candidates[i].rank != winner_rank) {
+      continue;
+    }
+    winner_rank = candidates[i].rank;
+    snap.index[snap.index_count++] = desc;
+  }
+  return true;
+}
+
+static DeviceList index_of(const DdtSnapshot &snap) {
+  return DeviceList{snap.index, snap.index_count};
+}
+
+static DeviceList positions_of(const DdtSnapshot &snap) {
+  if (!snap.positioned) {
+    return DeviceList{};
+  }
+  return DeviceList{snap.providers[0].provider->get_devices().data(),
+                    snap.positions, snap.index_count};
+}
+#else
+// Without a merged index only one provider can be installed. A table
+// already in key order serves as its own index.
+static bool build_index(DdtSnapshot &snap) {
+  snap.indexed = false;
+  snap.table_sorted = false;
+  snap.provider_lookup =
+      snap.provider_count == 1 && snap.providers[0].provider->has_lookup();
+  if (snap.provider_count != 1) {
+    return snap.provider_count == 0;
+  }
+
+  snap.table_sorted = table_sorted(*snap.providers[0].provider);
+  return true;
+}
+
+static DeviceList index_of(const DdtSnapshot &) { return DeviceList{}; }
+#endif
+
+static DeviceList list_of(const DdtSnapshot &snap) {
+  if (snap.provider_count == 1) {
+    return DeviceList{snap.providers[0].provider->get_devices()};
+  }
+  return index_of(snap);
+}
+
+// ============================================================================
+// Presence Filter
+// ============================================================================
+
+// Group of a key, or false if the filter does not cover it
+static inline bool group_of(uint32_t kind, uint32_t role, uint32_t &group) {
+  if (kind >= kPresenceKinds || role >= kPresenceRoles) {
+    return false;
+  }
+  group = kind * kPresenceRoles + role;
+  return true;
+}
+
+static void build_presence(DdtSnapshot &snap) {
+  DdtPresence &presence = snap.presence;
+  std::fill(std::begin(presence.present), std::end(presence.present), 0u);
+  std::fill(std::begin(presence.max_index), std::end(presence.max_index), 0);
+
+  // Shadowed duplicates count too: harmless, they only widen the filter
+  for (const auto &dev : list_of(snap)) {
+    uint32_t group;
+    if (group_of(dev.kind, desc_role(dev), group)) {
+      presence.present[group / 32] |= 1u << (group % 32);
+      uint8_t index = static_cast<uint8_t>(dev.index);
+      presence.max_index[group] = std::max(presence.max_index[group], index);
+    }
+  }
+}
+
+// False only if no device has this key
+static inline bool may_exist(const DdtSnapshot &snap, uint32_t kind,
+                             uint32_t role, uint32_t index) {
+  uint32_t group;
+  if (!group_of(kind, role, group)) {
+    return true;
+  }
+  const DdtPresence &presence = snap.presence;
+  return (presence.present[group / 32] >> (group % 32) & 1u) != 0 &&
+         index <= presence.max_index[group];
+}
+
+// ============================================================================
+// Structure-of-Arrays Mirror
+// ============================================================================
+
+#if V4STD_DDT_SOA
+static void build_mirror(DdtSnapshot &snap) {
+  DdtMirror &mirror = snap.mirror;
+  DeviceList devices = list_of(snap);
+  mirror.valid = devices.size() <= V4STD_DDT_MAX_DEVICES;
+  mirror.count = mirror.valid ? devices.size() : 0;
+
+  for (size_t i = 0; i < mirror.count; ++i) {
+    const DeviceDesc &dev = devices[i];
+    mirror.kind[i] = dev.kind;
+    mirror.role[i] = desc_role(dev);
+    mirror.index[i] = dev.index;
+    mirror.flags[i] = desc_flags(dev);
+    mirror.handle[i] = dev.handle;
+  }
+}
+
+// Nonzero miss[j] if slot first + j does not match or is past the end.
+// Only fields the query masks are read; fixed trip counts let the loops
+// vectorize.
+static void match_block(const DdtMirror &mirror, const DeviceQuery &query,
+                        size_t first, uint8_t (&miss)[kQueryBlock]) {
+  size_t end = std::min(kQueryBlock, mirror.count - first);
+  for (size_t j = 0; j < kQueryBlock; ++j) {
+    miss[j] = static_cast<uint8_t>(j) >= static_cast<uint8_t>(end);
+  }
+
+  auto match_bytes = [&](const uint8_t *field, uint8_t value, uint8_t mask) {
+    if (mask == 0) {
+      return;
+    }
+    for (size_t j = 0; j < kQueryBlock; ++j) {
+      miss[j] |= static_cast<uint8_t>((field[first + j] ^ value) & mask);
+    }
+  };
+  match_bytes(mirror.kind, query.kind, query.kind_mask);
+  match_bytes(mirror.role, query.role, query.role_mask);
+  match_bytes(mirror.index, query.index, query.index_mask);
+  match_bytes(mirror.flags, query.flags, query.flags_mask);
+
+  if (query.handle_mask != 0) {
+    for (size_t j = 0; j < kQueryBlock; ++j) {
+      miss[j] |= ((mirror.handle[first + j] ^ query.handle) &
+                  query.handle_mask) != 0;
+    }
+  }
+}
+
+static size_t scan_mirror(const DdtMirror &mirror, const DeviceQuery &query,
+                          span<uint32_t> positions) {
+  size_t total = 0;
+  uint8_t miss[kQueryBlock];
+  for (size_t first = 0; first < mirror.count; first += kQueryBlock) {
+    match_block(mirror, query, first, miss);
+
+    if (positions.empty()) {
+      // Byte-wide count: at most kQueryBlock per block
+      uint8_t hits = 0;
+      for (size_t j = 0; j < kQueryBlock; ++j) {
+        hits += miss[j] == 0;
+      }
+      total += hits;
+      continue;
+    }
+
+    for (size_t j = 0; j < kQueryBlock; ++j) {
+      if (miss[j] == 0) {
+        if (total < positions.size()) {
+          positions[total] = static_cast<uint32_t>(first + j);
+        }
+        ++total;
+      }
+    }
+  }
+  return total;
+}
+#endif
+
+static size_t scan_list(const DeviceList &devices, const DeviceQuery &query,
+                        span<uint32_t> positions) {
+  size_t total = 0;
+  for (size_t i = 0; i < devices.size(); ++i) {
+    if (query.matches(devices[i])) {
+      if (total < positions.size()) {
+        positions[total] = static_cast<uint32_t>(i);
+      }
+      ++total;
+    }
+  }
+  return total;
+}
+
+static size_t scan(const DdtSnapshot &snap, const DeviceQuery &query,
+                   span<uint32_t> positions) {
+#if V4STD_DDT_SOA
+  if (snap.mirror.valid) {
+    return scan_mirror(snap.mirror, query, positions);
+  }
+#endif
+  return scan_list(list_of(snap), query, positions);
+}
+
+// ============================================================================
+// Provider Changes
+// ============================================================================
+
+// Build the next snapshot with a modified provider list and publish it.
+// edit() returns false to abandon the change.
+template <typename Edit> static bool publish(Edit edit) {
+  while (writer_busy.exchange(true, std::memory_order_acquire)) {
+    V4STD_CPU_RELAX();
+  }
+
+  const DdtSnapshot *old = current_snapshot.load(std::memory_order_relaxed);
+  DdtSnapshot *next = (old == &snapshots[0]) ? &snapshots[1] : &snapshots[0];
+  for (size_t i = 0; i < old->provider_count; ++i) {
+    next->providers[i] = old->providers[i];
+  }
+  next->provider_count = old->provider_count;
+  next->generation = old->generation + 1;
+
+  bool ok = edit(*next) && build_index(*next);
+  if (ok) {
+    build_presence(*next);
+#if V4STD_DDT_SOA
+    build_mirror(*next);
+#endif
+    current_snapshot.store(next, std::memory_order_seq_cst);
+    wait_for_readers();
+  }
+
+  writer_busy.store(false, std::memory_order_release);
+  return ok;
+}
+
+void Ddt::set_provider(DdtProvider *provider) {
+  publish([provider](DdtSnapshot &snap) {
+    snap.provider_count = 0;
+    if (provider) {
+      snap.providers[snap.provider_count++] = {provider, 0};
+    }
+    return true;
+  });
+}
+
+bool Ddt::add_provider(DdtProvider *provider, int priority) {
+  if (!provider) {
+    return false;
+  }
+
+  return publish([provider, priority](DdtSnapshot &snap) {
+    if (snap.provider_count >= V4STD_DDT_MAX_PROVIDERS) {
+      return false;
+    }
+    for (size_t i = 0; i < snap.provider_count; ++i) {
+      if (snap.providers[i].provider == provider) {
+        return false;
+      }
+    }
+    snap.providers[snap.provider_count++] = {provider, priority};
+    return true;
+  });
+}
+
+bool Ddt::remove_provider(DdtProvider *provider) {
+  return publish([provider](DdtSnapshot &snap) {
+    for (size_t i = 0; i < snap.provider_count; ++i) {
+      if (snap.providers[i].provider == provider) {
+        for (size_t j = i + 1; j < snap.provider_count; ++j) {
+          snap.providers[j - 1] = snap.providers[j];
+        }
+        --snap.provider_count;
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+size_t Ddt::provider_count() {
+  ReadGuard guard;
+  return snapshot().provider_count;
+}
+
+uint32_t Ddt::generation() {
+  ReadGuard guard;
+  return snapshot().generation;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+// First entry of a sorted list with key >= key
+static size_t lower_bound(const DeviceList &sorted, uint32_t key) {
+  size_t lo = 0;
+  size_t hi = sorted.size();
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (key_of(sorted[mid]) < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// The snapshot's devices in key order: the merged index, a single
+// provider's own index, its table if already sorted, or a position index
+// over it. Returns false if there is none.
+static bool sorted_view(const DdtSnapshot &snap, DeviceList &sorted) {
+  if (snap.indexed) {
+    sorted = index_of(snap);
+    return true;
+  }
+  if (snap.provider_count == 0) {
+    sorted = DeviceList{};
+    return true;
+  }
+
+  const DdtProvider *provider = snap.providers[0].provider;
+  span<const DeviceDesc> table = provider->get_devices();
+  if (snap.provider_lookup) {
+    span<const uint16_t> positions = provider->sorted_index();
+    if (!positions.empty()) {
+      sorted = DeviceList{table.data(), positions.data(), positions.size()};
+      return true;
+    }
+  }
+  if (snap.table_sorted) {
+    sorted = DeviceList{table};
+    return true;
+  }
+#if V4STD_DDT_MERGED_INDEX
+  if (snap.positioned) {
+    sorted = positions_of(snap);
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+static const DeviceDesc *find_in(const DdtSnapshot &snap, v4dev_kind_t kind,
+                                 v4dev_role_t role, uint8_t index) {
+  if (!may_exist(snap, kind, role, index)) {
     return nullptr;
+  }
+
+  uint32_t key = key_of(kind, role, index);
+
+  const DdtProvider *provider = snap.providers[0].provider;
+  if (snap.provider_lookup) {
+    return provider->lookup(kind, role, index);
+  }
 
-  auto devices = provider_->get_devices();
+  DeviceList sorted;
+  if (sorted_view(snap, sorted)) {
+    size_t pos = lower_bound(sorted, key);
+    if (pos < sorted.size() && key_of(sorted[pos]) == key) {
+      return &sorted[pos];
+    }
+    return nullptr;
+  }
 
-  for (const auto &dev : devices) {
-    if (dev.kind == kind && dev.role == role && dev.index == index) {
+  // Single unsorted provider too large to index
+  for (const auto &dev : provider->get_devices()) {
+    if (key_of(dev) == key) {
       return &dev;
     }
   }
@@ -28,19 +688,87 @@ const v4dev_desc_t *Ddt::find_device(v4dev_kind_t kind, v4dev_role_t role,
   return nullptr;
 }
 
-const v4dev_desc_t *Ddt::find_default_device(v4dev_kind_t kind,
-                                             v4dev_role_t role) {
+// Entries with first <= key < last. Returns false if unsorted.
+static bool range_of(const DdtSnapshot &snap, uint32_t first, uint32_t last,
+                     DeviceList &group) {
+  DeviceList sorted;
+  if (!sorted_view(snap, sorted)) {
+    group = DeviceList{};
+    return false;
+  }
+
+  size_t lo = lower_bound(sorted, first);
+  size_t hi = lower_bound(sorted, last);
+  group = sorted.sublist(lo, hi - lo);
+  return true;
+}
+
+bool DeviceList::position_of(const DeviceDesc *desc, size_t &position) const {
+  if (!desc || size_ == 0) {
+    return false;
+  }
+
+  if (table_ && !positions_) {
+    return slot_in(table_, size_, desc, position);
+  }
+
+  // Index: sorted by key, repeated keys next to each other
+  uint32_t key = key_of(*desc);
+  for (size_t pos = lower_bound(*this, key);
+       pos < size_ && key_of((*this)[pos]) == key; ++pos) {
+    if (&(*this)[pos] == desc) {
+      position = pos;
+      return true;
+    }
+  }
+  return false;
+}
+
+const DeviceDesc *Ddt::find_device(v4dev_kind_t kind, v4dev_role_t role,
+                                   uint8_t index) {
+  ReadGuard guard;
+  const DdtSnapshot &snap = snapshot();
+  if (snap.provider_count == 0)
+    return nullptr;
+
+  return find_in(snap, kind, role, index);
+}
+
+const DeviceDesc *Ddt::find_default_device(v4dev_kind_t kind,
+                                           v4dev_role_t role) {
   return find_device(kind, role, 0);
 }
 
+DeviceToken Ddt::find_token(v4dev_kind_t kind, v4dev_role_t role,
+                            uint8_t index) {
+  ReadGuard guard;
+  const DdtSnapshot &snap = snapshot();
+
+  DeviceToken token;
+  token.desc =
+      snap.provider_count ? find_in(snap, kind, role, index) : nullptr;
+  token.generation = snap.generation;
+  return token;
+}
+
+const DeviceDesc *Ddt::resolve(const DeviceToken &token) {
+  return token.generation == generation() ? token.desc : nullptr;
+}
+
 size_t Ddt::count_devices(v4dev_kind_t kind) {
-  if (!provider_)
+  ReadGuard guard;
+  const DdtSnapshot &snap = snapshot();
+  if (snap.provider_count == 0)
     return 0;
 
-  auto devices = provider_->get_devices();
-  size_t count = 0;
+  DeviceList sorted;
+  if (sorted_view(snap, sorted)) {
+    uint32_t first = static_cast<uint32_t>(kind) << 16;
+    return lower_bound(sorted, first + 0x10000) - lower_bound(sorted, first);
+  }
 
-  for (const auto &dev : devices) {
+  size_t count = 0;
+  for (const auto &dev : snap.providers[0].provider->get_devices()) {
     if (dev.kind == kind) {
       ++count;
     }
@@ -49,11 +777,75 @@ size_t Ddt::count_devices(v4dev_kind_t kind) {
   return count;
 }
 
-span<const v4dev_desc_t> Ddt::get_all_devices() {
-  if (!provider_)
-    return {};
+bool Ddt::try_devices_of(v4dev_kind_t kind, DeviceList &group) {
+  ReadGuard guard;
+  uint32_t first = static_cast<uint32_t>(kind) << 16;
+  return range_of(snapshot(), first, first + 0x10000, group);
+}
+
+bool Ddt::try_devices_of(v4dev_kind_t kind, v4dev_role_t role,
+                         DeviceList &group) {
+  ReadGuard guard;
+  const DdtSnapshot &snap = snapshot();
+  if (!may_exist(snap, kind, role, 0)) {
+    group = DeviceList{}; // Known to be empty, sorted or not
+    return true;
+  }
+  uint32_t first = key_of(kind, role, 0);
+  return range_of(snap, first, first + 0x100, group);
+}
+
+DeviceList Ddt::devices_of(v4dev_kind_t kind) {
+  DeviceList group;
+  try_devices_of(kind, group);
+  return group;
+}
+
+DeviceList Ddt::devices_of(v4dev_kind_t kind, v4dev_role_t role) {
+  DeviceList group;
+  try_devices_of(kind, role, group);
+  return group;
+}
+
+const v4dev_attr_t *Ddt::find_attributes(const DeviceDesc *desc) {
+  if (!desc) {
+    return nullptr;
+  }
+
+  ReadGuard guard;
+  const DdtSnapshot &snap = snapshot();
+  for (size_t i = 0; i < snap.provider_count; ++i) {
+    const DdtProvider *provider = snap.providers[i].provider;
+    span<const DeviceDesc> table = provider->get_devices();
+    size_t slot;
+    if (!slot_in(table.data(), table.size(), desc, slot)) {
+      continue;
+    }
+
+    span<const v4dev_attr_t> attributes = provider->get_attributes();
+    if (slot < attributes.size() && attributes[slot].kind != V4DEV_NONE) {
+      return &attributes[slot];
+    }
+    return nullptr;
+  }
+
+  return nullptr;
+}
+
+size_t Ddt::count_matching(const DeviceQuery &query) {
+  ReadGuard guard;
+  return scan(snapshot(), query, span<uint32_t>{});
+}
+
+size_t Ddt::select_matching(const DeviceQuery &query,
+                            span<uint32_t> positions) {
+  ReadGuard guard;
+  return scan(snapshot(), query, positions);
+}
 
-  return provider_->get_devices();
+DeviceList Ddt::get_all_devices() {
+  ReadGuard guard;
+  return list_of(snapshot());
 }
 
 } // namespace v4std
@@ -0,0 +1,180 @@
+/**
+ * @file ddt_image.cpp
+ * @brief Binary DDT image builder and MappedDdtProvider
+ */
+
+#include "v4std/ddt_image.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace v4std {
+
+static constexpr char kDdtImageMagic[4] = {'V', '4', 'D', 'T'};
+
+static inline uint32_t key_of(const DeviceDesc &dev) {
+  return (static_cast<uint32_t>(dev.kind) << 16) |
+         (static_cast<uint32_t>(desc_role(dev)) << 8) | dev.index;
+}
+
+static uint32_t fnv1a(const uint8_t *data, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// ============================================================================
+// Builder
+// ============================================================================
+
+size_t ddt_image_size(span<const DeviceDesc> devices) {
+  // One index entry per descriptor
+  return sizeof(DdtImageHeader) + devices.size() * sizeof(DeviceDesc) +
+         devices.size() * sizeof(uint16_t);
+}
+
+size_t build_ddt_image(span<const DeviceDesc> devices, span<uint8_t> out) {
+  size_t count = devices.size();
+  if (count > kDdtImageMaxDevices || out.size() < ddt_image_size(devices)) {
+    return 0;
+  }
+  // The index is sorted in place as uint16_t
+  if (reinterpret_cast<uintptr_t>(out.data()) % alignof(uint16_t) != 0) {
+    return 0;
+  }
+
+  uint8_t *base = out.data();
+  size_t devices_offset = sizeof(DdtImageHeader);
+  size_t index_offset = devices_offset + count * sizeof(DeviceDesc);
+  if (count > 0) {
+    std::memcpy(base + devices_offset, devices.data(),
+                count * sizeof(DeviceDesc));
+  }
+
+  // Sort positions by key in place; keys must be distinct
+  uint16_t *index = reinterpret_cast<uint16_t *>(base + index_offset);
+  for (size_t i = 0; i < count; ++i) {
+    index[i] = static_cast<uint16_t>(i);
+  }
+  std::sort(index, index + count, [&devices](uint16_t a, uint16_t b) {
+    return key_of(devices[a]) < key_of(devices[b]);
+  });
+  for (size_t i = 1; i < count; ++i) {
+    if (key_of(devices[index[i - 1]]) == key_of(devices[index[i]])) {
+      return 0;
+    }
+  }
+
+  size_t image_size = index_offset + count * sizeof(uint16_t);
+
+  DdtImageHeader header;
+  std::memcpy(header.magic, kDdtImageMagic, sizeof(header.magic));
+  header.version = kDdtImageVersion;
+  header.header_size = sizeof(DdtImageHeader);
+  header.image_size = static_cast<uint32_t>(image_size);
+  header.device_count = static_cast<uint32_t>(count);
+  header.devices_offset = static_cast<uint32_t>(devices_offset);
+  header.index_count = static_cast<uint32_t>(count);
+  header.index_offset = static_cast<uint32_t>(index_offset);
+  header.checksum = fnv1a(base + sizeof(DdtImageHeader),
+                          image_size - sizeof(DdtImageHeader));
+  std::memcpy(base, &header, sizeof(header));
+
+  return image_size;
+}
+
+// ============================================================================
+// MappedDdtProvider
+// ============================================================================
+
+bool MappedDdtProvider::attach(span<const uint8_t> image) {
+  detach();
+
+  const uint8_t *base = image.data();
+  size_t size = image.size();
+  if (!base || size < sizeof(DdtImageHeader) ||
+      reinterpret_cast<uintptr_t>(base) % kDdtImageAlign != 0) {
+    return false;
+  }
+
+  DdtImageHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, kDdtImageMagic, sizeof(header.magic)) != 0 ||
+      header.version != kDdtImageVersion ||
+      header.header_size != sizeof(DdtImageHeader) ||
+      header.image_size > size || header.device_count > kDdtImageMaxDevices ||
+      header.index_count != header.device_count) {
+    return false;
+  }
+
+  // 64-bit arithmetic: header fields are untrusted
+  uint64_t devices_end = static_cast<uint64_t>(header.devices_offset) +
+                         uint64_t{header.device_count} * sizeof(DeviceDesc);
+  uint64_t index_end = static_cast<uint64_t>(header.index_offset) +
+                       uint64_t{header.index_count} * sizeof(uint16_t);
+  if (header.devices_offset < sizeof(DdtImageHeader) ||
+      header.devices_offset % kDdtImageAlign != 0 ||
+      header.index_offset % alignof(uint16_t) != 0 ||
+      header.index_offset < sizeof(DdtImageHeader) ||
+      devices_end > header.image_size || index_end > header.image_size) {
+    return false;
+  }
+
+  if (fnv1a(base + sizeof(DdtImageHeader),
+            header.image_size - sizeof(DdtImageHeader)) != header.checksum) {
+    return false;
+  }
+
+  const DeviceDesc *devices =
+      reinterpret_cast<const DeviceDesc *>(base + header.devices_offset);
+  const uint16_t *index =
+      reinterpret_cast<const uint16_t *>(base + header.index_offset);
+
+  // Every entry in range, keys strictly ascending
+  for (size_t i = 0; i < header.index_count; ++i) {
+    if (index[i] >= header.device_count) {
+      return false;
+    }
+    if (i > 0 && key_of(devices[index[i - 1]]) >= key_of(devices[index[i]])) {
+      return false;
+    }
+  }
+
+  devices_ = span<const DeviceDesc>{devices, header.device_count};
+  index_ = index;
+  index_count_ = header.index_count;
+  return true;
+}
+
+void MappedDdtProvider::detach() {
+  devices_ = span<const DeviceDesc>{};
+  index_ = nullptr;
+  index_count_ = 0;
+}
+
+const DeviceDesc *MappedDdtProvider::lookup(v4dev_kind_t kind,
+                                            v4dev_role_t role,
+                                            uint8_t index) const {
+  uint32_t key = (static_cast<uint32_t>(kind) << 16) |
+                 (static_cast<uint32_t>(role) << 8) | index;
+
+  size_t lo = 0;
+  size_t hi = index_count_;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (key_of(devices_[index_[mid]]) < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (lo < index_count_ && key_of(devices_[index_[lo]]) == key) {
+    return &devices_[index_[lo]];
+  }
+  return nullptr;
+}
+
+} // namespace v4std
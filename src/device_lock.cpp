@@ -0,0 +1,39 @@
+/**
+ * @file device_lock.cpp
+ * @brief Per-device spinlock implementation
+ */
+
+#include "v4std/device_lock.hpp"
+#include "v4std/config.hpp"
+#include <atomic>
+
+namespace v4std {
+
+// One lock per cache line so neighbouring devices do not false-share
+struct alignas(V4STD_CACHE_LINE_SIZE) LockSlot {
+  std::atomic<bool> locked{false};
+};
+
+static LockSlot lock_slots[V4STD_DDT_LOCK_SLOTS];
+
+void DeviceLocks::lock(uint32_t key) {
+  std::atomic<bool> &locked = lock_slots[slot_of(key)].locked;
+  while (locked.exchange(true, std::memory_order_acquire)) {
+    // Spin on a plain load to keep the line shared until it is released
+    while (locked.load(std::memory_order_relaxed)) {
+      V4STD_CPU_RELAX();
+    }
+  }
+}
+
+bool DeviceLocks::try_lock(uint32_t key) {
+  std::atomic<bool> &locked = lock_slots[slot_of(key)].locked;
+  return !locked.load(std::memory_order_relaxed) &&
+         !locked.exchange(true, std::memory_order_acquire);
+}
+
+void DeviceLocks::unlock(uint32_t key) {
+  lock_slots[slot_of(key)].locked.store(false, std::memory_order_release);
+}
+
+} // namespace v4std
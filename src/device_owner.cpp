@@ -0,0 +1,216 @@
+/**
+ * @file device_owner.cpp
+ * @brief Device ownership and MPSC command forwarding
+ */
+
+#include "v4std/device_owner.hpp"
+#include "v4std/config.hpp"
+#include <cassert>
+
+namespace v4std {
+
+// ============================================================================
+// Owner Table
+// ============================================================================
+
+// Owner bound to the calling thread
+static V4STD_THREAD_LOCAL DeviceOwner *bound_owner = nullptr;
+
+#if V4STD_MAX_DEVICE_OWNERS > 0
+// One pinned device. Slots are claimed in order and never released (an
+// unpinned device keeps its slot with a null owner), so lookups scan only
+// the claimed prefix.
+struct OwnerSlot {
+  std::atomic<uint32_t> key{0}; // 0 = free
+  std::atomic<DeviceOwner *> owner{nullptr};
+};
+
+static OwnerSlot owner_slots[V4STD_MAX_DEVICE_OWNERS];
+static std::atomic<size_t> claimed_slots{0};
+
+static uint32_t owner_key(v4dev_kind_t kind, v4dev_role_t role,
+                          uint8_t index) {
+  return (1u << 24) | (static_cast<uint32_t>(kind) << 16) |
+         (static_cast<uint32_t>(role) << 8) | index;
+}
+
+bool set_device_owner(v4dev_kind_t kind, v4dev_role_t role, uint8_t index,
+                      DeviceOwner *owner) {
+  uint32_t key = owner_key(kind, role, index);
+  for (auto &slot : owner_slots) {
+    uint32_t current = slot.key.load(std::memory_order_acquire);
+    if (current == 0 && owner == nullptr) {
+      return true; // Not pinned
+    }
+    if (current == 0 &&
+        slot.key.compare_exchange_strong(current, key,
+                                         std::memory_order_acq_rel)) {
+      slot.owner.store(owner, std::memory_order_release);
+      size_t claimed = static_cast<size_t>(&slot - owner_slots) + 1;
+      size_t seen = claimed_slots.load(std::memory_order_relaxed);
+      while (seen < claimed &&
+             !claimed_slots.compare_exchange_weak(
+                 seen, claimed, std::memory_order_release)) {
+      }
+      return true;
+    }
+    if (current == key) {
+      slot.owner.store(owner, std::memory_order_release);
+      return true;
+    }
+  }
+  return owner == nullptr;
+}
+
+DeviceOwner *get_device_owner(v4dev_kind_t kind, v4dev_role_t role,
+                              uint8_t index) {
+  size_t claimed = claimed_slots.load(std::memory_order_acquire);
+  if (claimed == 0) {
+    return nullptr;
+  }
+
+  uint32_t key = owner_key(kind, role, index);
+  for (size_t i = 0; i < claimed; ++i) {
+    if (owner_slots[i].key.load(std::memory_order_acquire) == key) {
+      return owner_slots[i].owner.load(std::memory_order_acquire);
+    }
+  }
+  return nullptr;
+}
+
+void clear_device_owners() {
+  for (auto &slot : owner_slots) {
+    slot.owner.store(nullptr, std::memory_order_relaxed);
+    slot.key.store(0, std::memory_order_relaxed);
+  }
+  claimed_slots.store(0, std::memory_order_release);
+}
+#else
+bool set_device_owner(v4dev_kind_t, v4dev_role_t, uint8_t,
+                      DeviceOwner *owner) {
+  return owner == nullptr;
+}
+
+DeviceOwner *get_device_owner(v4dev_kind_t, v4dev_role_t, uint8_t) {
+  return nullptr;
+}
+
+void clear_device_owners() {}
+#endif
+
+// ============================================================================
+// DeviceOwner
+// ============================================================================
+
+DeviceOwner::DeviceOwner() {
+  for (size_t i = 0; i < kQueueSize; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+    cells_[i].request = nullptr;
+  }
+}
+
+void DeviceOwner::bind_current_thread() { bound_owner = this; }
+
+void DeviceOwner::unbind_current_thread() { bound_owner = nullptr; }
+
+DeviceOwner *DeviceOwner::current() { return bound_owner; }
+
+bool DeviceOwner::try_push(Request *request) {
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  for (;;) {
+    Cell &cell = cells_[pos & (kQueueSize - 1)];
+    size_t seq = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+        cell.request = request;
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false; // Full
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+DeviceOwner::Request *DeviceOwner::try_pop() {
+  Cell &cell = cells_[dequeue_pos_ & (kQueueSize - 1)];
+  size_t seq = cell.sequence.load(std::memory_order_acquire);
+  if (seq != dequeue_pos_ + 1) {
+    return nullptr; // Empty (or producer still writing)
+  }
+
+  Request *request = cell.request;
+  cell.sequence.store(dequeue_pos_ + kQueueSize, std::memory_order_release);
+  ++dequeue_pos_;
+  return request;
+}
+
+size_t DeviceOwner::drain(size_t max_batch) {
+  Ddt::ReadGuard ddt_guard;
+
+  size_t executed = 0;
+  while (executed < max_batch) {
+    Request *request = try_pop();
+    if (!request) {
+      break;
+    }
+
+    // The device is looked up here, under this drain's guard, since the
+    // forwarding thread holds none
+    if (Ddt::find_device(request->kind, request->role, request->index)) {
+      DeviceLockGuard guard{
+          DeviceLocks::key_of(request->kind, request->role, request->index)};
+      request->result = request->task(request->context);
+    } else {
+      request->result = request->task(request->context);
+    }
+    request->done.store(true, std::memory_order_release);
+    ++executed;
+  }
+
+  if (executed > 0) {
+    forwarded_.fetch_add(executed, std::memory_order_relaxed);
+    size_t peak = max_batch_.load(std::memory_order_relaxed);
+    if (executed > peak) {
+      max_batch_.store(executed, std::memory_order_relaxed); // Owner only
+    }
+  }
+  return executed;
+}
+
+int32_t DeviceOwner::forward(OwnerTask task, void *context, v4dev_kind_t kind,
+                             v4dev_role_t role, uint8_t index) {
+  assert(!Ddt::in_read_section() && "forward() under a Ddt::ReadGuard");
+
+  Request request;
+  request.task = task;
+  request.context = context;
+  request.kind = kind;
+  request.role = role;
+  request.index = index;
+  request.result = 0;
+  request.done.store(false, std::memory_order_relaxed);
+
+  DeviceOwner *self = bound_owner;
+  while (!try_push(&request)) {
+    if (self) {
+      self->drain();
+    }
+    V4STD_CPU_RELAX();
+  }
+
+  while (!request.done.load(std::memory_order_acquire)) {
+    if (self) {
+      self->drain();
+    }
+    V4STD_CPU_RELAX();
+  }
+
+  return request.result;
+}
+
+} // namespace v4std
@@ -0,0 +1,57 @@
+/**
+ * @file ddt_image_file.cpp
+ * @brief mmap-backed DDT image files
+ */
+
+#include "v4std/linux/ddt_image_file.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace v4std {
+
+MappedDdtFile::~MappedDdtFile() { close(); }
+
+bool MappedDdtFile::open(const char *path) {
+  close();
+
+  int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  size_t size = static_cast<size_t>(st.st_size);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // The mapping keeps the file referenced
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  if (!provider_.attach(span<const uint8_t>{
+          static_cast<const uint8_t *>(mapping), size})) {
+    munmap(mapping, size);
+    return false;
+  }
+
+  mapping_ = mapping;
+  size_ = size;
+  return true;
+}
+
+void MappedDdtFile::close() {
+  provider_.detach();
+  if (mapping_) {
+    munmap(mapping_, size_);
+    mapping_ = nullptr;
+    size_ = 0;
+  }
+}
+
+} // namespace v4std
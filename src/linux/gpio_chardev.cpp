@@ -0,0 +1,349 @@
+/**
+ * @file gpio_chardev.cpp
+ * @brief GPIO character-device LED and button HALs
+ */
+
+#include "v4std/linux/gpio_chardev.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace v4std {
+
+static_assert(GpioLedHal::kMaxLines == GPIO_V2_LINES_MAX &&
+                  GpioButtonHal::kMaxLines == GPIO_V2_LINES_MAX,
+              "line masks are 64 bits wide");
+
+// ============================================================================
+// System GpioIo
+// ============================================================================
+
+namespace {
+
+class SystemGpioIo : public GpioIo {
+public:
+  int open(const char *path, int flags) override {
+    return ::open(path, flags);
+  }
+
+  int close(int fd) override { return ::close(fd); }
+
+  int ioctl(int fd, unsigned long request, void *arg) override {
+    int ret;
+    do {
+      ret = ::ioctl(fd, request, arg);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+  }
+
+  ssize_t read(int fd, void *buf, size_t size) override {
+    ssize_t n;
+    do {
+      n = ::read(fd, buf, size);
+    } while (n < 0 && errno == EINTR);
+    return n;
+  }
+};
+
+} // namespace
+
+GpioIo &system_gpio_io() {
+  static SystemGpioIo io;
+  return io;
+}
+
+// ============================================================================
+// Line Requests
+// ============================================================================
+
+/**
+ * @brief Request lines on a chip; returns the line request fd or -1
+ */
+static int request_lines(GpioIo &io, const char *chip,
+                         span<const uint32_t> offsets, const char *consumer,
+                         gpio_v2_line_config &config) {
+  if (offsets.empty() || offsets.size() > GPIO_V2_LINES_MAX) {
+    return -1;
+  }
+
+  int chip_fd = io.open(chip, O_RDWR | O_CLOEXEC);
+  if (chip_fd < 0) {
+    return -1;
+  }
+
+  gpio_v2_line_request req;
+  memset(&req, 0, sizeof(req));
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    req.offsets[i] = offsets[i];
+  }
+  strncpy(req.consumer, consumer, sizeof(req.consumer) - 1);
+  req.config = config;
+  req.num_lines = static_cast<uint32_t>(offsets.size());
+
+  int ret = io.ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req);
+  io.close(chip_fd); // The line request outlives the chip fd
+  return ret < 0 ? -1 : req.fd;
+}
+
+/**
+ * @brief Mask covering the first count lines of a request
+ */
+static uint64_t all_lines(size_t count) {
+  return count >= 64 ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+}
+
+/**
+ * @brief Index of a line in a request (its bit in value masks), or -1
+ */
+static int find_line(const uint32_t *offsets, size_t count, uint32_t handle) {
+  for (size_t i = 0; i < count; ++i) {
+    if (offsets[i] == handle) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+// ============================================================================
+// GpioLedHal
+// ============================================================================
+
+GpioLedHal::~GpioLedHal() { close(); }
+
+bool GpioLedHal::open(const char *chip, span<const uint32_t> offsets,
+                      uint64_t active_low, const char *consumer) {
+  close();
+
+  // Off is level 1 for active-low LEDs
+  gpio_v2_line_config config;
+  memset(&config, 0, sizeof(config));
+  config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+  config.num_attrs = 1;
+  config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+  config.attrs[0].attr.values = active_low & all_lines(offsets.size());
+  config.attrs[0].mask = all_lines(offsets.size());
+
+  int fd = request_lines(io_, chip, offsets, consumer, config);
+  if (fd < 0) {
+    return false;
+  }
+
+  fd_ = fd;
+  num_lines_ = offsets.size();
+  for (size_t i = 0; i < num_lines_; ++i) {
+    offsets_[i] = offsets[i];
+  }
+  return true;
+}
+
+void GpioLedHal::close() {
+  if (fd_ >= 0) {
+    io_.close(fd_);
+    fd_ = -1;
+  }
+  num_lines_ = 0;
+  batch_depth_ = 0;
+  pending_bits_ = 0;
+  pending_mask_ = 0;
+}
+
+int GpioLedHal::line_of(uint32_t handle) const {
+  return find_line(offsets_, num_lines_, handle);
+}
+
+bool GpioLedHal::apply(uint64_t bits, uint64_t mask) {
+  gpio_v2_line_values values = {};
+  values.bits = bits;
+  values.mask = mask;
+  return io_.ioctl(fd_, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) == 0;
+}
+
+bool GpioLedHal::set_led(uint32_t handle, bool state, bool active_low) {
+  int line = line_of(handle);
+  if (line < 0) {
+    return false;
+  }
+
+  uint64_t bit = uint64_t{1} << line;
+  uint64_t bits = (state != active_low) ? bit : 0;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (batch_depth_ > 0) {
+    pending_bits_ = (pending_bits_ & ~bit) | bits;
+    pending_mask_ |= bit;
+    return true;
+  }
+  return apply(bits, bit);
+}
+
+bool GpioLedHal::get_led(uint32_t handle, bool active_low) {
+  int line = line_of(handle);
+  if (line < 0) {
+    return false;
+  }
+
+  uint64_t bit = uint64_t{1} << line;
+  bool level;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_mask_ & bit) {
+      // Report what the batch will drive, so toggles inside it compose
+      level = (pending_bits_ & bit) != 0;
+    } else {
+      gpio_v2_line_values values = {};
+      values.mask = bit;
+      if (io_.ioctl(fd_, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) != 0) {
+        return false;
+      }
+      level = (values.bits & bit) != 0;
+    }
+  }
+  return level != active_low;
+}
+
+void GpioLedHal::begin_batch() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++batch_depth_;
+}
+
+bool GpioLedHal::end_batch() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (batch_depth_ == 0 || --batch_depth_ > 0) {
+    return true;
+  }
+
+  uint64_t bits = pending_bits_;
+  uint64_t mask = pending_mask_;
+  pending_bits_ = 0;
+  pending_mask_ = 0;
+  return mask == 0 || apply(bits, mask);
+}
+
+// ============================================================================
+// GpioButtonHal
+// ============================================================================
+
+GpioButtonHal::~GpioButtonHal() { close(); }
+
+bool GpioButtonHal::open(const char *chip, span<const uint32_t> offsets,
+                         uint32_t debounce_us, const char *consumer) {
+  close();
+
+  gpio_v2_line_config config;
+  memset(&config, 0, sizeof(config));
+  config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING |
+                 GPIO_V2_LINE_FLAG_EDGE_FALLING;
+  if (debounce_us > 0) {
+    config.num_attrs = 1;
+    config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+    config.attrs[0].attr.debounce_period_us = debounce_us;
+    config.attrs[0].mask = all_lines(offsets.size());
+  }
+
+  int fd = request_lines(io_, chip, offsets, consumer, config);
+  if (fd < 0) {
+    return false;
+  }
+
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.fd = fd;
+  if (epoll_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    if (epoll_fd >= 0) {
+      ::close(epoll_fd);
+    }
+    io_.close(fd);
+    return false;
+  }
+
+  fd_ = fd;
+  epoll_fd_ = epoll_fd;
+  num_lines_ = offsets.size();
+  for (size_t i = 0; i < num_lines_; ++i) {
+    offsets_[i] = offsets[i];
+  }
+  return true;
+}
+
+void GpioButtonHal::close() {
+  if (epoll_fd_ >= 0) {
+    ::close(epoll_fd_);
+    epoll_fd_ = -1;
+  }
+  if (fd_ >= 0) {
+    io_.close(fd_);
+    fd_ = -1;
+  }
+  num_lines_ = 0;
+  event_head_ = 0;
+  event_count_ = 0;
+}
+
+int GpioButtonHal::line_of(uint32_t handle) const {
+  return find_line(offsets_, num_lines_, handle);
+}
+
+bool GpioButtonHal::get_button(uint32_t handle, bool active_low,
+                               bool &pressed) {
+  int line = line_of(handle);
+  if (line < 0) {
+    return false;
+  }
+
+  gpio_v2_line_values values = {};
+  values.mask = uint64_t{1} << line;
+  if (io_.ioctl(fd_, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) != 0) {
+    return false;
+  }
+  pressed = ((values.bits & values.mask) != 0) != active_low;
+  return true;
+}
+
+bool GpioButtonHal::fill(int timeout_ms) {
+  epoll_event ev;
+  int ready;
+  do {
+    ready = epoll_wait(epoll_fd_, &ev, 1, timeout_ms);
+  } while (ready < 0 && errno == EINTR);
+  if (ready <= 0) {
+    return false;
+  }
+
+  // The kernel hands out whole records, as many as fit
+  gpio_v2_line_event records[kEventBuffer];
+  ssize_t n = io_.read(fd_, records, sizeof(records));
+  if (n < static_cast<ssize_t>(sizeof(records[0]))) {
+    return false;
+  }
+
+  size_t count = static_cast<size_t>(n) / sizeof(records[0]);
+  for (size_t i = 0; i < count; ++i) {
+    GpioButtonEvent &event = events_[i];
+    event.handle = records[i].offset;
+    event.rising = records[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE;
+    event.timestamp_ns = records[i].timestamp_ns;
+  }
+  event_head_ = 0;
+  event_count_ = count;
+  return true;
+}
+
+bool GpioButtonHal::wait_event(GpioButtonEvent &event, int timeout_ms) {
+  if (fd_ < 0) {
+    return false;
+  }
+  if (event_count_ == 0 && !fill(timeout_ms)) {
+    return false;
+  }
+
+  event = events_[event_head_++];
+  --event_count_;
+  return true;
+}
+
+} // namespace v4std
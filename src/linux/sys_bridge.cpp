@@ -0,0 +1,399 @@
+/**
+ * @file sys_bridge.cpp
+ * @brief Shared-memory SYS call bridge implementation
+ */
+
+#include "v4std/linux/sys_bridge.hpp"
+#include "v4std/device_lock.hpp"
+#include "v4std/sys_handlers.hpp"
+#include <atomic>
+#include <climits>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace v4std {
+
+static constexpr uint32_t kBridgeMagic = 0x56344252; // "V4BR"
+static constexpr uint32_t kBridgeVersion = 1;
+
+// Adaptive spin budget: doubled when spinning finds data, halved when the
+// waiter has to park anyway
+static constexpr uint32_t kSpinMin = 16;
+static constexpr uint32_t kSpinInitial = 1024;
+static constexpr uint32_t kSpinMax = 16384;
+
+// Parked waiters re-check shutdown at least this often
+static constexpr long kParkTimeoutNs = 50 * 1000 * 1000;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "futex words must be plain lock-free 32-bit atomics");
+
+// ============================================================================
+// Shared Region Layout
+// ============================================================================
+
+struct SysBridgeRequest {
+  uint32_t seq;
+  uint16_t sys_id;
+  uint16_t reserved;
+  int32_t args[3];
+};
+
+struct SysBridgeResponse {
+  uint32_t seq;
+  int32_t result;
+};
+
+// SPSC ring. head is also the futex word the consumer parks on.
+template <typename T> struct SharedRing {
+  alignas(V4STD_CACHE_LINE_SIZE) std::atomic<uint32_t> head;
+  std::atomic<uint32_t> sleeping; // Consumer is parked on head
+  alignas(V4STD_CACHE_LINE_SIZE) std::atomic<uint32_t> tail;
+  alignas(V4STD_CACHE_LINE_SIZE) T slots[SysBridge::kRingSize];
+};
+
+struct SysBridgeShared {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t ring_size;
+  uint32_t region_size;
+  std::atomic<uint32_t> stop;
+  SharedRing<SysBridgeRequest> requests;
+  SharedRing<SysBridgeResponse> responses;
+};
+
+static size_t region_size() {
+  size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return (sizeof(SysBridgeShared) + page - 1) / page * page;
+}
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+// Shared (not FUTEX_PRIVATE) futexes: the peer is another process
+static void futex_wait(std::atomic<uint32_t> &word, uint32_t expected) {
+  struct timespec timeout = {0, kParkTimeoutNs};
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT,
+          expected, &timeout, nullptr, 0);
+}
+
+static void futex_wake(std::atomic<uint32_t> &word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+// Make [old head, head) visible and wake the consumer if it is parked.
+// The seq_cst store/load pair orders against the consumer's
+// sleeping-store/head-load so one side always sees the other.
+template <typename T> static void publish(SharedRing<T> &ring, uint32_t head) {
+  ring.head.store(head, std::memory_order_seq_cst);
+  if (ring.sleeping.load(std::memory_order_seq_cst)) {
+    futex_wake(ring.head);
+  }
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+SysBridge::~SysBridge() { close(); }
+
+bool SysBridge::create() {
+  close();
+
+  int fd = memfd_create("v4std-sys-bridge", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0) {
+    return false;
+  }
+
+  size_t size = region_size();
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0 ||
+      fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mem == MAP_FAILED) {
+    ::close(fd);
+    return false;
+  }
+
+  SysBridgeShared *shared = new (mem) SysBridgeShared();
+  shared->magic = kBridgeMagic;
+  shared->version = kBridgeVersion;
+  shared->ring_size = kRingSize;
+  shared->region_size = static_cast<uint32_t>(size);
+
+  shared_ = shared;
+  fd_ = fd;
+  spin_budget_ = kSpinInitial;
+  return true;
+}
+
+bool SysBridge::attach(int fd) {
+  close();
+  if (fd < 0) {
+    return false;
+  }
+
+  // A peer-supplied fd must be exactly our region size and sealed so the
+  // peer cannot shrink it under us (which would fault on access)
+  size_t size = region_size();
+  struct stat st;
+  int seals = fcntl(fd, F_GET_SEALS);
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != size ||
+      seals < 0 || !(seals & F_SEAL_SHRINK)) {
+    ::close(fd);
+    return false;
+  }
+
+  void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mem == MAP_FAILED) {
+    ::close(fd);
+    return false;
+  }
+
+  SysBridgeShared *shared = static_cast<SysBridgeShared *>(mem);
+  if (shared->magic != kBridgeMagic || shared->version != kBridgeVersion ||
+      shared->ring_size != kRingSize) {
+    munmap(mem, size);
+    ::close(fd);
+    return false;
+  }
+
+  shared_ = shared;
+  fd_ = fd;
+  req_head_ = shared->requests.head.load(std::memory_order_acquire);
+  req_tail_ = shared->requests.tail.load(std::memory_order_acquire);
+  resp_head_ = shared->responses.head.load(std::memory_order_acquire);
+  resp_tail_ = shared->responses.tail.load(std::memory_order_acquire);
+  next_seq_ = req_head_;
+  spin_budget_ = kSpinInitial;
+  return true;
+}
+
+void SysBridge::close() {
+  if (shared_) {
+    munmap(shared_, region_size());
+    shared_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+
+  req_head_ = req_tail_ = resp_head_ = resp_tail_ = next_seq_ = 0;
+  futex_waits_ = 0;
+  corrupt_ = false;
+}
+
+void SysBridge::shutdown() {
+  if (!shared_) {
+    return;
+  }
+  shared_->stop.store(1, std::memory_order_seq_cst);
+  futex_wake(shared_->requests.head);
+  futex_wake(shared_->responses.head);
+}
+
+bool SysBridge::is_shutdown() const {
+  return shared_ && shared_->stop.load(std::memory_order_acquire) != 0;
+}
+
+// ============================================================================
+// Waiting
+// ============================================================================
+
+// Wait until the consumed ring has data or the bridge stops.
+// Returns the number of readable slots (0 on shutdown or corruption).
+uint32_t SysBridge::wait_for_data(bool responses) {
+  std::atomic<uint32_t> &head =
+      responses ? shared_->responses.head : shared_->requests.head;
+  std::atomic<uint32_t> &sleeping =
+      responses ? shared_->responses.sleeping : shared_->requests.sleeping;
+  uint32_t tail = responses ? resp_tail_ : req_tail_;
+
+  uint32_t available = 0;
+  for (uint32_t i = 0; i < spin_budget_; ++i) {
+    available = head.load(std::memory_order_acquire) - tail;
+    if (available != 0) {
+      spin_budget_ = spin_budget_ < kSpinMax ? spin_budget_ * 2 : kSpinMax;
+      break;
+    }
+    cpu_relax();
+  }
+
+  while (available == 0) {
+    if (shared_->stop.load(std::memory_order_acquire)) {
+      return 0;
+    }
+
+    sleeping.store(1, std::memory_order_seq_cst);
+    uint32_t observed = head.load(std::memory_order_seq_cst);
+    if (observed == tail) {
+      ++futex_waits_;
+      futex_wait(head, observed);
+    }
+    sleeping.store(0, std::memory_order_relaxed);
+
+    available = head.load(std::memory_order_acquire) - tail;
+    spin_budget_ = spin_budget_ > kSpinMin ? spin_budget_ / 2 : kSpinMin;
+  }
+
+  if (available > kRingSize) {
+    corrupt_ = true;
+    return 0;
+  }
+  return available;
+}
+
+// ============================================================================
+// VM Side
+// ============================================================================
+
+bool SysBridge::call(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                     int32_t arg2, int32_t &result) {
+  SysBridgeCall single = {sys_id, {arg0, arg1, arg2}};
+  return call_batch(&single, &result, 1) == 1;
+}
+
+size_t SysBridge::call_batch(const SysBridgeCall *calls, int32_t *results,
+                             size_t count) {
+  if (!shared_ || corrupt_) {
+    return 0;
+  }
+
+  SharedRing<SysBridgeRequest> &requests = shared_->requests;
+  SharedRing<SysBridgeResponse> &responses = shared_->responses;
+
+  size_t done = 0;
+  while (done < count) {
+    if (shared_->stop.load(std::memory_order_acquire)) {
+      return done;
+    }
+
+    // At most one ring of requests is in flight, so the HAL side can
+    // always answer everything it takes
+    uint32_t chunk = count - done < kRingSize
+                         ? static_cast<uint32_t>(count - done)
+                         : kRingSize;
+    uint32_t first_seq = next_seq_;
+    for (uint32_t i = 0; i < chunk; ++i) {
+      const SysBridgeCall &call = calls[done + i];
+      SysBridgeRequest &slot =
+          requests.slots[(req_head_ + i) & (kRingSize - 1)];
+      slot.seq = next_seq_++;
+      slot.sys_id = call.sys_id;
+      slot.reserved = 0;
+      slot.args[0] = call.args[0];
+      slot.args[1] = call.args[1];
+      slot.args[2] = call.args[2];
+    }
+    req_head_ += chunk;
+    publish(requests, req_head_);
+
+    uint32_t received = 0;
+    while (received < chunk) {
+      uint32_t available = wait_for_data(true);
+      if (available == 0) {
+        return done + received;
+      }
+      if (available > chunk - received) {
+        corrupt_ = true;
+        return done + received;
+      }
+
+      for (uint32_t i = 0; i < available; ++i) {
+        const SysBridgeResponse &slot =
+            responses.slots[(resp_tail_ + i) & (kRingSize - 1)];
+        if (slot.seq != first_seq + received + i) {
+          corrupt_ = true;
+          return done + received;
+        }
+        results[done + received + i] = slot.result;
+      }
+      resp_tail_ += available;
+      responses.tail.store(resp_tail_, std::memory_order_release);
+      received += available;
+    }
+
+    done += chunk;
+  }
+
+  return done;
+}
+
+// ============================================================================
+// HAL Side
+// ============================================================================
+
+size_t SysBridge::serve(size_t max_batch) {
+  if (!shared_ || corrupt_) {
+    return 0;
+  }
+
+  SharedRing<SysBridgeRequest> &requests = shared_->requests;
+  SharedRing<SysBridgeResponse> &responses = shared_->responses;
+
+  uint32_t available =
+      requests.head.load(std::memory_order_acquire) - req_tail_;
+  uint32_t used =
+      resp_head_ - responses.tail.load(std::memory_order_acquire);
+  if (available > kRingSize || used > kRingSize) {
+    corrupt_ = true;
+    return 0;
+  }
+
+  uint32_t batch = available < kRingSize - used ? available : kRingSize - used;
+  if (batch > max_batch) {
+    batch = static_cast<uint32_t>(max_batch);
+  }
+  if (batch == 0) {
+    return 0;
+  }
+
+  for (uint32_t i = 0; i < batch; ++i) {
+    // Copy out first: the peer may rewrite the slot at any time
+    SysBridgeRequest request =
+        requests.slots[(req_tail_ + i) & (kRingSize - 1)];
+    SysBridgeResponse &slot =
+        responses.slots[(resp_head_ + i) & (kRingSize - 1)];
+    slot.seq = request.seq;
+    slot.result = invoke_sys_handler(request.sys_id, request.args[0],
+                                     request.args[1], request.args[2]);
+  }
+
+  req_tail_ += batch;
+  requests.tail.store(req_tail_, std::memory_order_release);
+  resp_head_ += batch;
+  publish(responses, resp_head_);
+  return batch;
+}
+
+void SysBridge::run() {
+  if (!shared_) {
+    return;
+  }
+
+  while (!corrupt_) {
+    if (wait_for_data(false) == 0) {
+      break;
+    }
+    serve();
+  }
+}
+
+} // namespace v4std
@@ -0,0 +1,86 @@
+/**
+ * @file sys_replay.cpp
+ * @brief SYS call log replayer implementation
+ */
+
+#include "v4std/sim/sys_replay.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_trace.hpp"
+#include <chrono>
+
+namespace v4std {
+
+using ReplayClock = std::chrono::steady_clock;
+
+static size_t latency_bucket(uint64_t ns) {
+  size_t bucket = 0;
+  while (ns > 1 && bucket + 1 < SysReplayStats::kBuckets) {
+    ns >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+uint64_t SysReplayStats::latency_percentile_ns(double percentile) const {
+  if (calls == 0) {
+    return 0;
+  }
+
+  double target = calls * percentile / 100.0;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += latency_histogram[i];
+    if (seen > 0 && static_cast<double>(seen) >= target) {
+      return uint64_t{1} << (i + 1);
+    }
+  }
+  return uint64_t{1} << kBuckets;
+}
+
+SysReplayStats replay_sys_trace(span<const uint8_t> log,
+                                const SysReplayOptions &options) {
+  SysReplayStats stats;
+  SysTraceReader reader{log};
+  if (!reader.valid()) {
+    stats.malformed = true;
+    return stats;
+  }
+
+  double speed = options.speed > 0.0 ? options.speed : 1.0;
+  auto start = ReplayClock::now();
+  double offset_ns = 0.0; // Recorded time of the current call
+
+  SysTraceRecord rec;
+  while (reader.next(rec)) {
+    if (options.paced) {
+      offset_ns += rec.delta_us * 1000.0 / speed;
+      auto due = start + std::chrono::nanoseconds(
+                             static_cast<int64_t>(offset_ns));
+      while (ReplayClock::now() < due) {
+      }
+    }
+
+    auto before = ReplayClock::now();
+    int32_t result = invoke_sys_cells(rec.sys_id, rec.in, rec.in_count);
+    auto after = ReplayClock::now();
+
+    uint64_t ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(after - before)
+            .count());
+    stats.total_ns += ns;
+    ++stats.latency_histogram[latency_bucket(ns)];
+    ++stats.calls;
+    if (result != rec.result) {
+      ++stats.divergences;
+    }
+  }
+
+  stats.malformed = reader.error();
+  stats.elapsed_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(ReplayClock::now() -
+                                                           start)
+          .count());
+  return stats;
+}
+
+} // namespace v4std
@@ -0,0 +1,186 @@
+/**
+ * @file virtual_board.cpp
+ * @brief Host virtual board implementation
+ */
+
+#include "v4std/sim/virtual_board.hpp"
+#include <chrono>
+
+namespace v4std {
+
+// ============================================================================
+// VirtualHal
+// ============================================================================
+
+bool VirtualHal::accept(uint32_t handle) {
+  const DeviceDesc *dev = board_->device(handle);
+  if (!dev || dev->kind != kind_) {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  board_->state(handle).calls.fetch_add(1, std::memory_order_relaxed);
+  simulate_latency();
+  return true;
+}
+
+void VirtualHal::simulate_latency() const {
+  uint32_t ns = latency_ns();
+  if (ns == 0) {
+    return;
+  }
+
+  // Busy wait: a synchronous HAL call holds the calling thread
+  auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns);
+  while (std::chrono::steady_clock::now() < until) {
+  }
+}
+
+bool VirtualHal::read(uint32_t handle, int32_t &value) {
+  if (!accept(handle)) {
+    return false;
+  }
+
+  reads_.fetch_add(1, std::memory_order_relaxed);
+  value = board_->state(handle).value.load(std::memory_order_relaxed);
+  return true;
+}
+
+bool VirtualHal::write(uint32_t handle, int32_t value) {
+  if (!accept(handle)) {
+    return false;
+  }
+
+  writes_.fetch_add(1, std::memory_order_relaxed);
+  board_->state(handle).value.store(value, std::memory_order_relaxed);
+  return true;
+}
+
+void VirtualHal::reset_counters() {
+  reads_.store(0, std::memory_order_relaxed);
+  writes_.store(0, std::memory_order_relaxed);
+  errors_.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// VirtualLedHal
+// ============================================================================
+
+bool VirtualLedHal::set_led(uint32_t handle, bool state, bool active_low) {
+  bool level = active_low ? !state : state;
+  return hal_.write(handle, level ? 1 : 0);
+}
+
+bool VirtualLedHal::get_led(uint32_t handle, bool active_low) {
+  int32_t level = 0;
+  if (!hal_.read(handle, level)) {
+    return false;
+  }
+  return active_low ? level == 0 : level != 0;
+}
+
+// ============================================================================
+// VirtualBoard
+// ============================================================================
+
+VirtualBoard::VirtualBoard() : led_hal_(hals_[V4DEV_LED]) {
+  for (size_t kind = 0; kind < kKindCount; ++kind) {
+    hals_[kind].board_ = this;
+    hals_[kind].kind_ = static_cast<uint8_t>(kind);
+  }
+}
+
+bool VirtualBoard::add_devices(v4dev_kind_t kind, v4dev_role_t role,
+                               size_t count, uint8_t flags) {
+  if (kind == V4DEV_NONE || static_cast<size_t>(kind) >= kKindCount ||
+      role == V4ROLE_NONE || static_cast<size_t>(role) >= kRoleCount) {
+    return false;
+  }
+
+  uint16_t &next = next_index_[kind][role];
+  if (count > kMaxPerRole - next) {
+    return false;
+  }
+
+  // Handles are positions and must fit the descriptor layout
+  uint64_t last_handle = uint64_t{devices_.size()} + count - 1;
+  if (count > 0 && last_handle > DeviceDescTraits<DeviceDesc>::max_handle) {
+    return false;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    devices_.push_back(DeviceDesc{static_cast<uint8_t>(kind),
+                                  static_cast<uint8_t>(role),
+                                  static_cast<uint8_t>(next++), flags,
+                                  static_cast<uint32_t>(devices_.size())});
+    states_.emplace_back();
+  }
+
+  return true;
+}
+
+bool VirtualBoard::add_all(size_t count) {
+  for (size_t kind = V4DEV_LED; kind < kKindCount; ++kind) {
+    for (size_t role = V4ROLE_STATUS; role < kRoleCount; ++role) {
+      if (!add_devices(static_cast<v4dev_kind_t>(kind),
+                       static_cast<v4dev_role_t>(role), count)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void VirtualBoard::clear() {
+  devices_.clear();
+  states_.clear();
+  for (auto &kind : next_index_) {
+    for (auto &next : kind) {
+      next = 0;
+    }
+  }
+  reset_counters();
+}
+
+span<const DeviceDesc> VirtualBoard::get_devices() const {
+  return span<const DeviceDesc>{devices_.data(), devices_.size()};
+}
+
+const DeviceDesc *VirtualBoard::device(uint32_t handle) const {
+  return handle < devices_.size() ? &devices_[handle] : nullptr;
+}
+
+int32_t VirtualBoard::value(uint32_t handle) const {
+  return device(handle) ? states_[handle].value.load(std::memory_order_relaxed)
+                        : 0;
+}
+
+void VirtualBoard::set_value(uint32_t handle, int32_t value) {
+  if (device(handle)) {
+    states_[handle].value.store(value, std::memory_order_relaxed);
+  }
+}
+
+uint64_t VirtualBoard::device_calls(uint32_t handle) const {
+  return device(handle) ? states_[handle].calls.load(std::memory_order_relaxed)
+                        : 0;
+}
+
+uint64_t VirtualBoard::total_calls() const {
+  uint64_t total = 0;
+  for (const auto &hal : hals_) {
+    total += hal.calls();
+  }
+  return total;
+}
+
+void VirtualBoard::reset_counters() {
+  for (auto &hal : hals_) {
+    hal.reset_counters();
+  }
+  for (auto &state : states_) {
+    state.calls.store(0, std::memory_order_relaxed);
+  }
+}
+
+} // namespace v4std
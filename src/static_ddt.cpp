@@ -0,0 +1,33 @@
+/**
+ * @file static_ddt.cpp
+ * @brief StaticDdtProvider lookups
+ */
+
+#include "v4std/static_ddt.hpp"
+
+namespace v4std {
+
+const DeviceDesc *StaticDdtProvider::lookup(v4dev_kind_t kind,
+                                            v4dev_role_t role,
+                                            uint8_t index) const {
+  // Keys outside the 24-bit space cannot belong to the table
+  if (static_cast<uint32_t>(kind) > 0xFF ||
+      static_cast<uint32_t>(role) > 0xFF) {
+    return nullptr;
+  }
+
+  uint32_t key = DdtPerfectHash::key(kind, role, index);
+  uint16_t position = slots_[hash_(key)];
+  if (position == kDdtEmptySlot) {
+    return nullptr;
+  }
+
+  // One compare: a missing key may share a slot with a present one
+  const DeviceDesc &dev = devices_[position];
+  if (dev.kind != kind || desc_role(dev) != role || dev.index != index) {
+    return nullptr;
+  }
+  return &dev;
+}
+
+} // namespace v4std
@@ -0,0 +1,308 @@
+/**
+ * @file sys_coro.cpp
+ * @brief Coroutine SYS handler scheduler, frame pool, and registry
+ */
+
+#include "v4std/sys_coro.hpp"
+
+#if V4STD_HAS_COROUTINES
+
+namespace v4std {
+
+// ============================================================================
+// Frame pool
+// ============================================================================
+
+namespace {
+
+struct alignas(alignof(std::max_align_t)) FrameBlock {
+  unsigned char bytes[V4STD_CORO_FRAME_SIZE];
+};
+
+FrameBlock frame_blocks[V4STD_CORO_MAX_FRAMES];
+bool frame_used[V4STD_CORO_MAX_FRAMES];
+size_t frames_in_use = 0;
+
+} // namespace
+
+void *CoroFramePool::allocate(size_t size) noexcept {
+  if (size > sizeof(FrameBlock)) {
+    return nullptr; // Frame too large for a pool block
+  }
+
+  for (size_t i = 0; i < V4STD_CORO_MAX_FRAMES; ++i) {
+    if (!frame_used[i]) {
+      frame_used[i] = true;
+      ++frames_in_use;
+      return frame_blocks[i].bytes;
+    }
+  }
+
+  return nullptr; // Pool exhausted
+}
+
+void CoroFramePool::deallocate(void *ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+
+  size_t i = static_cast<size_t>(static_cast<FrameBlock *>(ptr) - frame_blocks);
+  if (i < V4STD_CORO_MAX_FRAMES && frame_used[i]) {
+    frame_used[i] = false;
+    --frames_in_use;
+  }
+}
+
+size_t CoroFramePool::in_use() noexcept { return frames_in_use; }
+
+// ============================================================================
+// Scheduler
+// ============================================================================
+
+namespace {
+
+enum class WaitState : uint8_t { Free, Timer, Event, Ready };
+
+// One wait slot per suspended handler. A handler suspends at most once at a
+// time, so the frame count bounds the number of slots needed.
+struct WaitSlot {
+  std::coroutine_handle<> handle;
+  WaitState state = WaitState::Free;
+  uint32_t deadline = 0;
+  CoroEvent *event = nullptr;
+  int32_t *value_out = nullptr;
+};
+
+WaitSlot wait_slots[V4STD_CORO_MAX_FRAMES];
+uint32_t scheduler_now = 0;
+
+int16_t alloc_slot() {
+  for (size_t i = 0; i < V4STD_CORO_MAX_FRAMES; ++i) {
+    if (wait_slots[i].state == WaitState::Free) {
+      return static_cast<int16_t>(i);
+    }
+  }
+  return -1;
+}
+
+// Wraparound-safe "deadline has passed" check
+bool expired(uint32_t deadline, uint32_t now) {
+  return static_cast<int32_t>(now - deadline) >= 0;
+}
+
+} // namespace
+
+bool CoroScheduler::add_timer(std::coroutine_handle<> handle,
+                              uint32_t ms) noexcept {
+  int16_t slot = alloc_slot();
+  if (slot < 0) {
+    return false; // No slot: the awaiter resumes at once and reports it
+  }
+
+  WaitSlot &w = wait_slots[slot];
+  w.handle = handle;
+  w.state = WaitState::Timer;
+  w.deadline = scheduler_now + ms;
+  return true;
+}
+
+bool CoroScheduler::add_event_waiter(std::coroutine_handle<> handle,
+                                     CoroEvent &event,
+                                     int32_t *value_out) noexcept {
+  if (event.waiter_ >= 0) {
+    return false; // Event already has a waiter
+  }
+
+  int16_t slot = alloc_slot();
+  if (slot < 0) {
+    return false;
+  }
+
+  WaitSlot &w = wait_slots[slot];
+  w.handle = handle;
+  w.state = WaitState::Event;
+  w.event = &event;
+  w.value_out = value_out;
+  event.waiter_ = slot;
+  return true;
+}
+
+void CoroScheduler::make_ready(int16_t slot, int32_t value) noexcept {
+  WaitSlot &w = wait_slots[slot];
+  if (w.value_out) {
+    *w.value_out = value;
+  }
+  w.event = nullptr;
+  w.state = WaitState::Ready;
+}
+
+void CoroScheduler::cancel(std::coroutine_handle<> handle) noexcept {
+  for (auto &w : wait_slots) {
+    if (w.state != WaitState::Free && w.handle == handle) {
+      if (w.event) {
+        w.event->waiter_ = -1;
+      }
+      w = WaitSlot{};
+    }
+  }
+}
+
+size_t CoroScheduler::poll(uint32_t now_ms) noexcept {
+  scheduler_now = now_ms;
+
+  for (auto &w : wait_slots) {
+    if (w.state == WaitState::Timer && expired(w.deadline, now_ms)) {
+      w.state = WaitState::Ready;
+    }
+  }
+
+  // Resume in slot order. A resumed handler may suspend again and reuse
+  // its own (freed) slot, so release before resuming.
+  size_t resumed = 0;
+  for (auto &w : wait_slots) {
+    if (w.state == WaitState::Ready) {
+      std::coroutine_handle<> handle = w.handle;
+      w = WaitSlot{};
+      handle.resume();
+      ++resumed;
+    }
+  }
+
+  return resumed;
+}
+
+uint32_t CoroScheduler::now() noexcept { return scheduler_now; }
+
+size_t CoroScheduler::pending() noexcept {
+  size_t count = 0;
+  for (const auto &w : wait_slots) {
+    if (w.state != WaitState::Free) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+// ============================================================================
+// Awaitables
+// ============================================================================
+
+void SysTask::reset() noexcept {
+  if (!handle_) {
+    return;
+  }
+
+  if (!handle_.done()) {
+    CoroScheduler::cancel(handle_);
+  }
+  handle_.destroy();
+  handle_ = nullptr;
+}
+
+bool CoroEvent::Awaiter::await_suspend(
+    std::coroutine_handle<> handle) noexcept {
+  if (!CoroScheduler::add_event_waiter(handle, event, &value)) {
+    value = -1; // Could not wait: resume immediately with an error
+    return false;
+  }
+  return true;
+}
+
+void CoroEvent::signal(int32_t value) noexcept {
+  if (waiter_ >= 0) {
+    int16_t slot = waiter_;
+    waiter_ = -1;
+    CoroScheduler::make_ready(slot, value);
+    return;
+  }
+
+  pending_ = true;
+  latched_ = value;
+}
+
+bool SleepAwaiter::await_suspend(std::coroutine_handle<> handle) noexcept {
+  if (!CoroScheduler::add_timer(handle, ms)) {
+    slept = false; // Could not wait: resume immediately and report it
+    return false;
+  }
+  return true;
+}
+
+// ============================================================================
+// Handler registry
+// ============================================================================
+
+namespace {
+
+struct CoroEntry {
+  uint16_t sys_id;
+  SysCoroHandler handler; // nullptr marks a free entry
+};
+
+CoroEntry coro_registry[V4STD_CORO_MAX_HANDLERS];
+
+CoroEntry *find_entry(uint16_t sys_id) {
+  for (auto &e : coro_registry) {
+    if (e.handler && e.sys_id == sys_id) {
+      return &e;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+bool register_sys_coro_handler(uint16_t sys_id, SysCoroHandler handler) {
+  if (!handler) {
+    return false;
+  }
+
+  CoroEntry *entry = find_entry(sys_id);
+  if (!entry) {
+    for (auto &e : coro_registry) {
+      if (!e.handler) {
+        entry = &e;
+        break;
+      }
+    }
+  }
+  if (!entry) {
+    return false; // Table full
+  }
+
+  entry->sys_id = sys_id;
+  entry->handler = handler;
+  return true;
+}
+
+void unregister_sys_coro_handler(uint16_t sys_id) {
+  CoroEntry *entry = find_entry(sys_id);
+  if (entry) {
+    *entry = CoroEntry{};
+  }
+}
+
+SysCoroHandler get_sys_coro_handler(uint16_t sys_id) {
+  CoroEntry *entry = find_entry(sys_id);
+  return entry ? entry->handler : nullptr;
+}
+
+SysTask invoke_sys_coro_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                                int32_t arg2) {
+  SysCoroHandler handler = get_sys_coro_handler(sys_id);
+  if (!handler) {
+    return SysTask{};
+  }
+
+  return handler(sys_id, arg0, arg1, arg2);
+}
+
+void clear_sys_coro_handlers() {
+  for (auto &e : coro_registry) {
+    e = CoroEntry{};
+  }
+}
+
+} // namespace v4std
+
+#endif // V4STD_HAS_COROUTINES
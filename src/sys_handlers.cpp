@@ -4,47 +4,479 @@
  */
 
 #include "v4std/sys_handlers.hpp"
+#include "v4std/ddt.hpp"
+#include "v4std/device_lock.hpp"
+#include "v4std/device_owner.hpp"
+#include "v4std/sys_meta.hpp"
+
+#if V4STD_ROM_DISPATCH
+#include "v4std/sys_dispatch_table.h"
+#elif !V4STD_NO_HEAP
 #include <unordered_map>
+#endif
 
 namespace v4std {
 
-// Global handler registry
-// Note: In production embedded systems, consider using a fixed-size
-// array or other allocation-free structure. std::unordered_map is used
-// here for simplicity and flexibility during development.
-static std::unordered_map<uint16_t, SysHandler> handler_registry;
+using HandlerEntry = SysHandlerEntry;
 
-bool register_sys_handler(uint16_t sys_id, SysHandler handler) {
-  if (!handler) {
-    return false;
+static constexpr bool sys_arities_fit() {
+  for (size_t i = 0; i < sys_meta_count; ++i) {
+    if (sys_meta_table[i].in_arity > kSysMaxCells ||
+        sys_meta_table[i].out_arity > kSysMaxCells) {
+      return false;
+    }
   }
+  return true;
+}
+
+static_assert(sys_arities_fit(), "a SYS call has more than kSysMaxCells cells");
+
+#if V4STD_NO_HEAP || V4STD_ROM_DISPATCH
+
+#if V4STD_ROM_DISPATCH
+// Registrations over the ROM table; entries shadow it
+static constexpr size_t kRegistryCapacity = V4STD_SYS_OVERLAY_HANDLERS;
+#else
+static constexpr size_t kRegistryCapacity = V4STD_MAX_SYS_HANDLERS;
+#endif
+
+// Global handler registry: fixed-capacity array sorted by SYS ID.
+// Lookup is a binary search; registration shifts entries and is expected
+// to happen during initialization only.
+static HandlerEntry handler_registry[kRegistryCapacity];
+static size_t handler_count = 0;
 
-  handler_registry[sys_id] = handler;
+// First entry with sys_id >= the given ID
+static size_t find_handler_slot(uint16_t sys_id) {
+  size_t lo = 0;
+  size_t hi = handler_count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (handler_registry[mid].sys_id < sys_id) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static const HandlerEntry *find_registered(uint16_t sys_id) {
+  size_t pos = find_handler_slot(sys_id);
+  if (pos < handler_count && handler_registry[pos].sys_id == sys_id) {
+    return &handler_registry[pos];
+  }
+  return nullptr;
+}
+
+static bool insert_handler(const HandlerEntry &entry) {
+  size_t pos = find_handler_slot(entry.sys_id);
+  if (pos < handler_count && handler_registry[pos].sys_id == entry.sys_id) {
+    handler_registry[pos] = entry;
+    return true;
+  }
+
+  if (handler_count == kRegistryCapacity) {
+    return false; // Error: registry full
+  }
+
+  for (size_t i = handler_count; i > pos; --i) {
+    handler_registry[i] = handler_registry[i - 1];
+  }
+  handler_registry[pos] = entry;
+  ++handler_count;
   return true;
 }
 
-void unregister_sys_handler(uint16_t sys_id) { handler_registry.erase(sys_id); }
+static void erase_handler(uint16_t sys_id) {
+  size_t pos = find_handler_slot(sys_id);
+  if (pos == handler_count || handler_registry[pos].sys_id != sys_id) {
+    return;
+  }
 
-SysHandler get_sys_handler(uint16_t sys_id) {
+  for (size_t i = pos + 1; i < handler_count; ++i) {
+    handler_registry[i - 1] = handler_registry[i];
+  }
+  --handler_count;
+}
+
+#if V4STD_ROM_DISPATCH
+
+static constexpr bool rom_table_sorted() {
+  for (size_t i = 1; i < kRomSysHandlerCount; ++i) {
+    if (kRomSysHandlers[i - 1].sys_id >= kRomSysHandlers[i].sys_id) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(rom_table_sorted(), "ROM handler table must be sorted by ID");
+
+static const HandlerEntry *find_rom_handler(uint16_t sys_id) {
+  size_t lo = 0;
+  size_t hi = kRomSysHandlerCount;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (kRomSysHandlers[mid].sys_id < sys_id) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < kRomSysHandlerCount && kRomSysHandlers[lo].sys_id == sys_id) {
+    return &kRomSysHandlers[lo];
+  }
+  return nullptr;
+}
+
+// ROM entries removed by unregister_sys_handler(). A flag per entry, so
+// hiding the whole table takes no overlay entries.
+static bool rom_hidden[kRomSysHandlerCount > 0 ? kRomSysHandlerCount : 1];
+
+static size_t rom_slot(const HandlerEntry *rom) {
+  return static_cast<size_t>(rom - kRomSysHandlers);
+}
+
+static const HandlerEntry *find_handler(uint16_t sys_id) {
+  // Overlay first: entries there shadow the ROM table
+  if (handler_count > 0) {
+    const HandlerEntry *entry = find_registered(sys_id);
+    if (entry) {
+      return entry;
+    }
+  }
+  const HandlerEntry *rom = find_rom_handler(sys_id);
+  return rom && !rom_hidden[rom_slot(rom)] ? rom : nullptr;
+}
+
+static bool store_handler(const HandlerEntry &entry) {
+  // Already in ROM: drop any override instead of storing a copy
+  const HandlerEntry *rom = find_rom_handler(entry.sys_id);
+  if (rom && rom->handler == entry.handler &&
+      rom->cell_handler == entry.cell_handler && rom->flags == entry.flags) {
+    erase_handler(entry.sys_id);
+    rom_hidden[rom_slot(rom)] = false;
+    return true;
+  }
+
+  return insert_handler(entry);
+}
+
+void unregister_sys_handler(uint16_t sys_id) {
+  erase_handler(sys_id);
+  const HandlerEntry *rom = find_rom_handler(sys_id);
+  if (rom) {
+    rom_hidden[rom_slot(rom)] = true;
+  }
+}
+
+void clear_sys_handlers() {
+  handler_count = 0;
+  for (bool &hidden : rom_hidden) {
+    hidden = false;
+  }
+}
+
+size_t get_sys_handler_count() {
+  size_t count = handler_count;
+  for (size_t i = 0; i < kRomSysHandlerCount; ++i) {
+    if (!rom_hidden[i] && !find_registered(kRomSysHandlers[i].sys_id)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+#else
+
+static const HandlerEntry *find_handler(uint16_t sys_id) {
+  return find_registered(sys_id);
+}
+
+static bool store_handler(const HandlerEntry &entry) {
+  return insert_handler(entry);
+}
+
+void unregister_sys_handler(uint16_t sys_id) { erase_handler(sys_id); }
+
+void clear_sys_handlers() { handler_count = 0; }
+
+size_t get_sys_handler_count() { return handler_count; }
+
+#endif // V4STD_ROM_DISPATCH
+
+#else
+
+// Global handler registry
+// Note: Configure with V4STD_NO_HEAP for an allocation-free registry.
+// std::unordered_map is used here for simplicity and flexibility during
+// development.
+static std::unordered_map<uint16_t, HandlerEntry> handler_registry;
+
+static const HandlerEntry *find_handler(uint16_t sys_id) {
   auto it = handler_registry.find(sys_id);
   if (it != handler_registry.end()) {
-    return it->second;
+    return &it->second;
   }
   return nullptr;
 }
 
+static bool store_handler(const HandlerEntry &entry) {
+  handler_registry[entry.sys_id] = entry;
+  return true;
+}
+
+void unregister_sys_handler(uint16_t sys_id) { handler_registry.erase(sys_id); }
+
+void clear_sys_handlers() { handler_registry.clear(); }
+
+size_t get_sys_handler_count() { return handler_registry.size(); }
+
+#endif // V4STD_NO_HEAP || V4STD_ROM_DISPATCH
+
+bool register_sys_handler(uint16_t sys_id, SysHandler handler, uint8_t flags) {
+  if (!handler) {
+    return false;
+  }
+  return store_handler(HandlerEntry{sys_id, flags, handler});
+}
+
+bool register_sys_handler(uint16_t sys_id, SysHandler handler) {
+  return register_sys_handler(sys_id, handler, 0);
+}
+
+bool register_sys_cell_handler(uint16_t sys_id, SysCellHandler handler,
+                               uint8_t flags) {
+  if (!handler || !find_sys_meta(sys_id)) {
+    return false;
+  }
+  return store_handler(HandlerEntry{sys_id, flags, nullptr, handler});
+}
+
+SysHandler get_sys_handler(uint16_t sys_id) {
+  const HandlerEntry *entry = find_handler(sys_id);
+  return entry ? entry->handler : nullptr;
+}
+
+SysCellHandler get_sys_cell_handler(uint16_t sys_id) {
+  const HandlerEntry *entry = find_handler(sys_id);
+  return entry ? entry->cell_handler : nullptr;
+}
+
+uint8_t get_sys_handler_flags(uint16_t sys_id) {
+  const HandlerEntry *entry = find_handler(sys_id);
+  return entry ? entry->flags : 0;
+}
+
+// Trace hook (see set_sys_trace_hook())
+static SysTraceHook trace_hook = nullptr;
+static void *trace_context = nullptr;
+
+void set_sys_trace_hook(SysTraceHook hook, void *context) {
+  trace_hook = hook;
+  trace_context = context;
+}
+
+// Device addressed by a kind/role/index call
+struct CallDevice {
+  v4dev_kind_t kind;
+  v4dev_role_t role;
+  uint8_t index;
+};
+
+// One handler call. SysHandler calls read in[0..2]; stack-cell handlers
+// get all of in and out.
+struct HandlerCall {
+  HandlerEntry entry;
+  uint16_t sys_id;
+  const int32_t *in;
+  size_t in_count;
+  int32_t *out;
+  size_t out_count;
+};
+
+static bool find_call_device(const HandlerCall &call, CallDevice &device) {
+  if (call.in_count < 3) {
+    return false;
+  }
+
+  int32_t kind = call.in[0];
+  int32_t role = call.in[1];
+  int32_t index = call.in[2];
+  if (kind < 0 || kind > 0xFF || role < 0 || role > 0xFF || index < 0 ||
+      index > 0xFF) {
+    return false;
+  }
+
+  device.kind = static_cast<v4dev_kind_t>(kind);
+  device.role = static_cast<v4dev_role_t>(role);
+  device.index = static_cast<uint8_t>(index);
+  return true;
+}
+
+// Returns the handler's result, or a stack-cell handler's first result
+static int32_t run_handler_call(void *context) {
+  const HandlerCall &call = *static_cast<const HandlerCall *>(context);
+  if (call.entry.cell_handler) {
+    call.entry.cell_handler(call.sys_id, call.in, call.in_count, call.out,
+                            call.out_count);
+    return call.out_count > 0 ? call.out[0] : 0;
+  }
+  return call.entry.handler(call.sys_id, call.in[0], call.in[1], call.in[2]);
+}
+
+// Run a handler, holding its device lock if it asked for one. Calls on a
+// device pinned to another thread's owner are forwarded to that owner.
+static int32_t call_handler(HandlerCall &call) {
+  CallDevice device;
+  if (!(call.entry.flags & V4SYS_HANDLER_DEVICE_LOCK) ||
+      !find_call_device(call, device)) {
+    Ddt::ReadGuard ddt_guard;
+    return run_handler_call(&call);
+  }
+
+  // Forwarded without a guard: the owner may be the thread replacing the
+  // provider, and its drain() takes its own
+  DeviceOwner *owner = get_device_owner(device.kind, device.role,
+                                        device.index);
+  if (owner && owner != DeviceOwner::current()) {
+    return owner->forward(run_handler_call, &call, device.kind, device.role,
+                          device.index);
+  }
+
+  // Keeps the DDT the handler looks devices up in alive across hot-swaps
+  Ddt::ReadGuard ddt_guard;
+
+  if (Ddt::find_device(device.kind, device.role, device.index)) {
+    DeviceLockGuard guard{
+        DeviceLocks::key_of(device.kind, device.role, device.index)};
+    return run_handler_call(&call);
+  }
+  return run_handler_call(&call);
+}
+
+static void trace_call(uint16_t sys_id, const int32_t *in, size_t in_count,
+                       int32_t result) {
+  if (trace_hook) {
+    trace_hook(trace_context, sys_id, in, in_count, result);
+  }
+}
+
+// Stack-cell handler called with in_arity cells; in holds kSysMaxCells
+static int32_t invoke_cell_handler(const HandlerEntry &entry, uint16_t sys_id,
+                                   const SysMeta &meta, const int32_t *in) {
+  int32_t out[kSysMaxCells] = {};
+  HandlerCall call = {entry, sys_id, in, meta.in_arity, out, meta.out_arity};
+  return call_handler(call);
+}
+
 int32_t invoke_sys_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
                            int32_t arg2) {
-  SysHandler handler = get_sys_handler(sys_id);
-  if (!handler) {
-    return -1; // Error: no handler registered
+  const HandlerEntry *entry = find_handler(sys_id);
+  int32_t cells[kSysMaxCells] = {arg0, arg1, arg2};
+  size_t cell_count = 3;
+  int32_t result = -1; // Error: no handler registered
+  if (entry && entry->cell_handler) {
+    const SysMeta *meta = find_sys_meta(sys_id);
+    if (meta && meta->in_arity <= 4) { // More do not fit three arguments
+      if (meta->in_arity == 4) {
+        cells[2] = static_cast<int32_t>(static_cast<uint32_t>(arg2) >> 16);
+        cells[3] = arg2 & 0xFFFF;
+      }
+      cell_count = meta->in_arity;
+      result = invoke_cell_handler(*entry, sys_id, *meta, cells);
+    }
+  } else if (entry) {
+    HandlerCall call = {*entry, sys_id, cells, 3, nullptr, 0};
+    result = call_handler(call);
   }
 
-  return handler(sys_id, arg0, arg1, arg2);
+  trace_call(sys_id, cells, cell_count, result);
+  return result;
 }
 
-void clear_sys_handlers() { handler_registry.clear(); }
+int32_t invoke_sys_cells(uint16_t sys_id, const int32_t *in,
+                         size_t in_count) {
+  if (in_count > kSysMaxCells || (in_count > 0 && !in)) {
+    return -1;
+  }
 
-size_t get_sys_handler_count() { return handler_registry.size(); }
+  int32_t cells[kSysMaxCells] = {};
+  for (size_t i = 0; i < in_count; ++i) {
+    cells[i] = in[i];
+  }
+
+  const HandlerEntry *entry = find_handler(sys_id);
+  int32_t result = -1; // Error: no handler registered
+  if (entry && entry->cell_handler) {
+    const SysMeta *meta = find_sys_meta(sys_id);
+    if (meta) {
+      result = invoke_cell_handler(*entry, sys_id, *meta, cells);
+    }
+  } else if (entry) {
+    HandlerCall call = {*entry, sys_id, cells, 3, nullptr, 0};
+    result = call_handler(call);
+  }
+
+  trace_call(sys_id, cells, in_count, result);
+  return result;
+}
+
+SysCallStatus dispatch_sys_call(uint16_t sys_id, int32_t *stack, size_t &depth,
+                                size_t capacity) {
+  const SysMeta *meta = find_sys_meta(sys_id);
+  if (!meta) {
+    return SysCallStatus::UnknownId;
+  }
+
+  if (sys_is_blocking(*meta)) {
+    return SysCallStatus::Blocking;
+  }
+
+  if (depth < meta->in_arity) {
+    return SysCallStatus::StackUnderflow;
+  }
+
+  if (depth - meta->in_arity + meta->out_arity > capacity) {
+    return SysCallStatus::StackOverflow;
+  }
+
+  const HandlerEntry *entry = find_handler(sys_id);
+  if (!entry) {
+    return SysCallStatus::NoHandler;
+  }
+
+  if (!entry->cell_handler && (meta->in_arity > 3 || meta->out_arity > 1)) {
+    return SysCallStatus::BadArity;
+  }
+
+  // Pop inputs (deepest first); results may overwrite their cells
+  int32_t in[kSysMaxCells] = {};
+  const int32_t *cells = stack + depth - meta->in_arity;
+  for (size_t i = 0; i < meta->in_arity; ++i) {
+    in[i] = cells[i];
+  }
+  depth -= meta->in_arity;
+
+  int32_t out[kSysMaxCells] = {};
+  HandlerCall call = {*entry, sys_id, in, meta->in_arity, out,
+                      meta->out_arity};
+  if (!entry->cell_handler) {
+    call.in_count = 3; // SysHandler arguments; unused ones are 0
+  }
+  int32_t result = call_handler(call);
+  if (!entry->cell_handler) {
+    out[0] = result;
+  }
+
+  trace_call(sys_id, in, meta->in_arity, result);
+
+  for (size_t i = 0; i < meta->out_arity; ++i) {
+    stack[depth++] = out[i];
+  }
+
+  return SysCallStatus::Ok;
+}
 
 } // namespace v4std
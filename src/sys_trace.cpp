@@ -0,0 +1,190 @@
+/**
+ * @file sys_trace.cpp
+ * @brief SYS call recorder and trace log reader implementation
+ */
+
+#include "v4std/sys_trace.hpp"
+#include "v4std/sys_handlers.hpp"
+
+namespace v4std {
+
+static const uint8_t trace_magic[4] = {'V', '4', 'T', 'R'};
+
+// ============================================================================
+// Encoding helpers
+// ============================================================================
+
+static uint32_t zigzag_encode(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1) ^
+         static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value) {
+  return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// Returns bytes written
+static size_t put_varint(uint8_t *out, uint32_t value) {
+  size_t n = 0;
+  while (value >= 0x80) {
+    out[n++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  out[n++] = static_cast<uint8_t>(value);
+  return n;
+}
+
+// Returns false on a truncated or overlong varint
+static bool get_varint(span<const uint8_t> log, size_t &pos, uint32_t &value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 35; shift += 7) {
+    if (pos >= log.size()) {
+      return false;
+    }
+    uint8_t byte = log[pos++];
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ============================================================================
+// SysTraceRecorder
+// ============================================================================
+
+SysTraceRecorder::SysTraceRecorder(span<uint8_t> buffer, SysTraceClock clock)
+    : buffer_(buffer), clock_(clock) {
+  reset();
+}
+
+void SysTraceRecorder::reset() {
+  size_ = 0;
+  count_ = 0;
+  dropped_ = 0;
+  started_ = false;
+
+  if (buffer_.size() < kSysTraceHeaderSize) {
+    return; // Unusable buffer: every record is dropped
+  }
+
+  for (uint8_t byte : trace_magic) {
+    buffer_[size_++] = byte;
+  }
+  buffer_[size_++] = kSysTraceVersion;
+}
+
+void SysTraceRecorder::attach() { set_sys_trace_hook(trace_hook, this); }
+
+void SysTraceRecorder::detach() { set_sys_trace_hook(nullptr, nullptr); }
+
+void SysTraceRecorder::trace_hook(void *context, uint16_t sys_id,
+                                  const int32_t *in, size_t in_count,
+                                  int32_t result) {
+  static_cast<SysTraceRecorder *>(context)->record_call(sys_id, in, in_count,
+                                                        result);
+}
+
+bool SysTraceRecorder::record(const SysTraceRecord &rec) {
+  if (rec.in_count > kSysMaxCells) {
+    ++dropped_;
+    return false;
+  }
+
+  uint8_t encoded[kSysTraceMaxRecordSize];
+  size_t n = 0;
+  n += put_varint(encoded + n, rec.delta_us);
+  n += put_varint(encoded + n, rec.sys_id);
+  n += put_varint(encoded + n, rec.in_count);
+  for (size_t i = 0; i < rec.in_count; ++i) {
+    n += put_varint(encoded + n, zigzag_encode(rec.in[i]));
+  }
+  n += put_varint(encoded + n, zigzag_encode(rec.result));
+
+  if (size_ < kSysTraceHeaderSize || buffer_.size() - size_ < n) {
+    ++dropped_;
+    return false;
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    buffer_[size_++] = encoded[i];
+  }
+  ++count_;
+  return true;
+}
+
+bool SysTraceRecorder::record_call(uint16_t sys_id, const int32_t *in,
+                                   size_t in_count, int32_t result) {
+  if (in_count > kSysMaxCells) {
+    ++dropped_;
+    return false;
+  }
+
+  uint32_t now = clock_ ? clock_() : 0;
+  uint32_t delta = started_ ? now - last_us_ : 0; // Wrap-safe
+  last_us_ = now;
+  started_ = true;
+
+  SysTraceRecord rec = {delta, sys_id, 0, {}, result};
+  rec.in_count = static_cast<uint8_t>(in_count);
+  for (size_t i = 0; i < in_count; ++i) {
+    rec.in[i] = in[i];
+  }
+  return record(rec);
+}
+
+// ============================================================================
+// SysTraceReader
+// ============================================================================
+
+SysTraceReader::SysTraceReader(span<const uint8_t> log) : log_(log) {
+  if (log.size() < kSysTraceHeaderSize) {
+    return;
+  }
+
+  for (size_t i = 0; i < sizeof(trace_magic); ++i) {
+    if (log[i] != trace_magic[i]) {
+      return;
+    }
+  }
+  valid_ = log[4] == kSysTraceVersion;
+}
+
+bool SysTraceReader::next(SysTraceRecord &rec) {
+  if (!valid_ || error_ || pos_ >= log_.size()) {
+    return false;
+  }
+
+  uint32_t delta = 0;
+  uint32_t sys_id = 0;
+  uint32_t in_count = 0;
+  if (!get_varint(log_, pos_, delta) || !get_varint(log_, pos_, sys_id) ||
+      !get_varint(log_, pos_, in_count) || sys_id > 0xFFFF ||
+      in_count > kSysMaxCells) {
+    error_ = true;
+    return false;
+  }
+
+  rec.delta_us = delta;
+  rec.sys_id = static_cast<uint16_t>(sys_id);
+  rec.in_count = static_cast<uint8_t>(in_count);
+  for (size_t i = 0; i < kSysMaxCells; ++i) {
+    uint32_t cell = 0;
+    if (i < in_count && !get_varint(log_, pos_, cell)) {
+      error_ = true;
+      return false;
+    }
+    rec.in[i] = zigzag_decode(cell);
+  }
+
+  uint32_t result = 0;
+  if (!get_varint(log_, pos_, result)) {
+    error_ = true;
+    return false;
+  }
+  rec.result = zigzag_decode(result);
+  return true;
+}
+
+} // namespace v4std
@@ -0,0 +1,136 @@
+/**
+ * @file test_board_ddt.cpp
+ * @brief Tests for generated board device tables
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "boards/esp32c6_devkit_ddt.hpp"
+#include "boards/test_board_ddt.hpp"
+#include "v4std/ddt.hpp"
+
+using namespace v4std;
+
+namespace devkit = v4std::boards::esp32c6_devkit;
+namespace large = v4std::boards::test_board;
+
+// The tables are compile-time constants
+static_assert(sizeof(devkit::devices) / sizeof(DeviceDesc) == 6);
+static_assert(desc_flags(devkit::devices[2]) == V4DEV_FLAG_ACTIVE_LOW);
+static_assert(sizeof(devkit::hash_slots) / sizeof(uint16_t) == 8);
+static_assert(large::devices[32].handle == 0xFFu);
+
+// A stray entry in an empty slot fails the check: out of range, or a
+// device that hashes elsewhere
+constexpr bool with_stray_slot(uint16_t position) {
+  uint16_t slots[8] = {};
+  size_t empty = 8;
+  for (size_t i = 0; i < 8; ++i) {
+    slots[i] = devkit::hash_slots[i];
+    if (slots[i] == kDdtEmptySlot) {
+      empty = i;
+    }
+  }
+  if (empty == 8) {
+    return false;
+  }
+  slots[empty] = position;
+  return check_perfect_hash(devkit::devices, slots, devkit::hash);
+}
+
+static_assert(!with_stray_slot(6));
+static_assert(!with_stray_slot(0));
+
+TEST_CASE("BoardDdt: Generated table") {
+  devkit::Provider provider;
+  span<const DeviceDesc> devices = provider.get_devices();
+  REQUIRE(devices.size() == 6);
+  CHECK(devices.data() == devkit::devices);
+  CHECK(devices[0].kind == V4DEV_LED);
+  CHECK(devices[0].handle == 7);
+  CHECK(devices[3].kind == V4DEV_BUTTON);
+  CHECK(provider.has_lookup());
+
+  // Every device through its own slot
+  for (const auto &dev : devices) {
+    CHECK(provider.lookup(static_cast<v4dev_kind_t>(dev.kind),
+                          static_cast<v4dev_role_t>(desc_role(dev)),
+                          dev.index) == &dev);
+  }
+
+  CHECK(provider.lookup(V4DEV_LED, V4ROLE_USER, 2) == nullptr);
+  CHECK(provider.lookup(V4DEV_ADC, V4ROLE_USER, 0) == nullptr);
+  CHECK(provider.lookup(static_cast<v4dev_kind_t>(0x1FF), V4ROLE_USER, 0) ==
+        nullptr);
+}
+
+TEST_CASE("BoardDdt: Larger board") {
+  large::Provider provider;
+  span<const DeviceDesc> devices = provider.get_devices();
+  REQUIRE(devices.size() == 34);
+
+  for (const auto &dev : devices) {
+    CHECK(provider.lookup(static_cast<v4dev_kind_t>(dev.kind),
+                          static_cast<v4dev_role_t>(desc_role(dev)),
+                          dev.index) == &dev);
+  }
+
+  // Misses across the whole key space of the present kinds
+  size_t found = 0;
+  for (uint32_t role = 0; role < 8; ++role) {
+    for (uint32_t index = 0; index < 256; ++index) {
+      found += provider.lookup(V4DEV_UART, static_cast<v4dev_role_t>(role),
+                               static_cast<uint8_t>(index)) != nullptr;
+    }
+  }
+  CHECK(found == 24);
+
+  const DeviceDesc *odd = provider.lookup(
+      V4DEV_LED, static_cast<v4dev_role_t>(7), 255);
+  REQUIRE(odd != nullptr);
+  CHECK(desc_flags(*odd) == 0x8);
+  CHECK(desc_flags(*provider.lookup(V4DEV_RNG, V4ROLE_POWER, 0)) ==
+        V4DEV_FLAG_ACTIVE_LOW);
+
+  // Key order
+  span<const uint16_t> sorted = provider.sorted_index();
+  REQUIRE(sorted.size() == devices.size());
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    const DeviceDesc &a = devices[sorted[i - 1]];
+    const DeviceDesc &b = devices[sorted[i]];
+    uint32_t ka = DdtPerfectHash::key(a.kind, desc_role(a), a.index);
+    uint32_t kb = DdtPerfectHash::key(b.kind, desc_role(b), b.index);
+    CHECK(ka < kb);
+  }
+}
+
+TEST_CASE("BoardDdt: Installed in Ddt") {
+  large::Provider provider;
+  Ddt::set_provider(&provider);
+
+  const DeviceDesc *uart = Ddt::find_device(V4DEV_UART, V4ROLE_USER, 5);
+  REQUIRE(uart != nullptr);
+  CHECK(uart->handle == 0x52);
+
+  // Groups come from the generated key order
+  DeviceList adcs = Ddt::devices_of(V4DEV_ADC);
+  REQUIRE(adcs.size() == 8);
+  CHECK(desc_role(adcs[0]) == V4ROLE_USER);
+  CHECK(adcs[0].index == 0);
+  CHECK(desc_role(adcs[4]) == V4ROLE_DEBUG);
+  CHECK(Ddt::devices_of(V4DEV_UART, V4ROLE_USER).size() == 24);
+  CHECK(Ddt::count_devices(V4DEV_UART) == 24);
+
+  // Merged with another board like any provider
+  devkit::Provider devkit_provider;
+#if V4STD_DDT_MERGED_INDEX
+  CHECK(Ddt::add_provider(&devkit_provider));
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0)->handle == 7);
+  CHECK(Ddt::find_device(V4DEV_UART, V4ROLE_USER, 0)->handle == 0x57);
+#else
+  CHECK_FALSE(Ddt::add_provider(&devkit_provider));
+#endif
+
+  Ddt::set_provider(nullptr);
+}
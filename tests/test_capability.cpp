@@ -0,0 +1,220 @@
+/**
+ * @file test_capability.cpp
+ * @brief Tests for capability SYS call implementations
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/capability.hpp"
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_types.h"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include <cstring>
+#include <vector>
+
+using namespace v4std;
+
+class MockDdtProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_LED, V4ROLE_USER, 1, V4DEV_FLAG_ACTIVE_LOW, 10},
+        {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
+        {V4DEV_BUTTON, V4ROLE_USER, 0, V4DEV_FLAG_ACTIVE_LOW, 9},
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 8},
+    };
+
+    return span<const DeviceDesc>{devices, 4};
+  }
+};
+
+static MockDdtProvider g_provider;
+static uint8_t g_memory[64];
+
+#if V4STD_DDT_MERGED_INDEX
+static int32_t pack(int32_t max, int32_t addr) {
+  return (max << 16) | (addr & 0xFFFF);
+}
+#endif
+
+static v4dev_desc_t read_desc(size_t addr) {
+  v4dev_desc_t desc;
+  std::memcpy(&desc, g_memory + addr, sizeof(desc));
+  return desc;
+}
+
+TEST_CASE("CAP SYS: Queries") {
+  Ddt::set_provider(&g_provider);
+  register_cap_sys_handlers();
+
+  CHECK(invoke_sys_handler(V4SYS_CAP_COUNT, V4DEV_LED, 0, 0) == 3);
+  CHECK(invoke_sys_handler(V4SYS_CAP_COUNT, V4DEV_ADC, 0, 0) == 0);
+
+  CHECK(invoke_sys_handler(V4SYS_CAP_EXISTS, V4DEV_LED, V4ROLE_USER, 1) == 1);
+  CHECK(invoke_sys_handler(V4SYS_CAP_EXISTS, V4DEV_LED, V4ROLE_USER, 2) == 0);
+
+  CHECK(invoke_sys_handler(V4SYS_CAP_FLAGS, V4DEV_BUTTON, V4ROLE_USER, 0) ==
+        V4DEV_FLAG_ACTIVE_LOW);
+  CHECK(invoke_sys_handler(V4SYS_CAP_FLAGS, V4DEV_ADC, V4ROLE_USER, 0) == -1);
+
+  CHECK(invoke_sys_handler(V4SYS_CAP_HANDLE, V4DEV_LED, V4ROLE_STATUS, 0) ==
+        7);
+  CHECK(invoke_sys_handler(V4SYS_CAP_HANDLE, V4DEV_ADC, V4ROLE_USER, 0) ==
+        -1);
+}
+
+TEST_CASE("CAP SYS: Out-of-range keys do not alias other devices") {
+  Ddt::set_provider(&g_provider);
+  register_cap_sys_handlers();
+
+  // 0x100 + n would truncate to n, an existing key
+  CHECK(invoke_sys_handler(V4SYS_CAP_EXISTS, V4DEV_LED, V4ROLE_USER, 256) ==
+        0);
+  CHECK(invoke_sys_handler(V4SYS_CAP_EXISTS, V4DEV_LED, V4ROLE_USER, -1) ==
+        0);
+  CHECK(invoke_sys_handler(V4SYS_CAP_EXISTS, V4DEV_LED + 0x100, V4ROLE_USER,
+                           0) == 0);
+  CHECK(invoke_sys_handler(V4SYS_CAP_FLAGS, V4DEV_LED, V4ROLE_USER + 0x100,
+                           1) == -1);
+  CHECK(invoke_sys_handler(V4SYS_CAP_HANDLE, V4DEV_LED, V4ROLE_STATUS, 256) ==
+        -1);
+  CHECK(invoke_sys_handler(V4SYS_CAP_COUNT, V4DEV_LED + 0x100, 0, 0) == 0);
+
+  std::memset(g_memory, 0, sizeof(g_memory));
+  set_cap_memory(span<uint8_t>{g_memory, sizeof(g_memory)});
+  int32_t stack[8] = {V4DEV_LED, V4ROLE_USER + 0x100, 4, 0};
+  size_t depth = 4;
+  CHECK(dispatch_sys_call(V4SYS_CAP_ENUM, stack, depth, 8) ==
+        SysCallStatus::Ok);
+  CHECK(stack[0] == 0);
+  CHECK(read_desc(0).kind == V4DEV_NONE);
+  set_cap_memory(span<uint8_t>{});
+}
+
+// Groups of the unsorted mock table need the merged index
+#if V4STD_DDT_MERGED_INDEX
+TEST_CASE("CAP SYS: CAP_ENUM") {
+  Ddt::set_provider(&g_provider);
+  register_cap_sys_handlers();
+  std::memset(g_memory, 0, sizeof(g_memory));
+  set_cap_memory(span<uint8_t>{g_memory, sizeof(g_memory)});
+
+  SUBCASE("One role, sorted by index") {
+    CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, V4ROLE_USER,
+                             pack(4, 8)) == 2);
+    CHECK(read_desc(8).handle == 8);
+    CHECK(read_desc(16).handle == 10);
+    CHECK(read_desc(16).flags == V4DEV_FLAG_ACTIVE_LOW);
+    CHECK(read_desc(24).kind == V4DEV_NONE); // Nothing past the group
+  }
+
+  SUBCASE("All roles") {
+    CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, -1, pack(4, 0)) ==
+          3);
+    CHECK(read_desc(0).role == V4ROLE_STATUS);
+    CHECK(read_desc(8).role == V4ROLE_USER);
+    CHECK(read_desc(16).index == 1);
+  }
+
+  SUBCASE("Truncated to max") {
+    CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, -1, pack(1, 0)) ==
+          3);
+    CHECK(read_desc(0).handle == 7);
+    CHECK(read_desc(8).kind == V4DEV_NONE);
+  }
+
+  SUBCASE("Through dispatch_sys_call") {
+    int32_t stack[8] = {V4DEV_LED, V4ROLE_USER, 2, 32};
+    size_t depth = 4;
+    CHECK(dispatch_sys_call(V4SYS_CAP_ENUM, stack, depth, 8) ==
+          SysCallStatus::Ok);
+    REQUIRE(depth == 1);
+    CHECK(stack[0] == 2);
+    CHECK(read_desc(32).handle == 8);
+  }
+
+  SUBCASE("Addresses beyond 16 bits through dispatch_sys_call") {
+    static uint8_t large[0x10100];
+    set_cap_memory(span<uint8_t>{large, sizeof(large)});
+    int32_t stack[8] = {V4DEV_LED, V4ROLE_USER, 0x10000, 0x10010};
+    size_t depth = 4;
+    CHECK(dispatch_sys_call(V4SYS_CAP_ENUM, stack, depth, 8) ==
+          SysCallStatus::Ok);
+    REQUIRE(depth == 1);
+    CHECK(stack[0] == 2);
+    v4dev_desc_t desc;
+    std::memcpy(&desc, large + 0x10018, sizeof(desc));
+    CHECK(desc.handle == 10);
+    CHECK(large[0x10] == 0); // Not aliased to the low 16 bits
+  }
+
+  SUBCASE("Out of bounds") {
+    CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, -1, pack(3, 48)) ==
+          -1);
+    CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, -1, pack(1, 65)) ==
+          -1);
+    CHECK(read_desc(48).kind == V4DEV_NONE);
+
+    // Empty groups write nothing and fit anywhere in range
+    CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_ADC, -1, pack(4, 64)) ==
+          0);
+
+    set_cap_memory(span<uint8_t>{});
+    CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, -1, pack(1, 0)) ==
+          -1);
+  }
+
+  set_cap_memory(span<uint8_t>{});
+}
+
+// Unsorted LEDs, more than the position index holds
+class ManyLedsProvider : public DdtProvider {
+public:
+  static constexpr size_t kCount =
+      V4STD_DDT_MAX_DEVICES * sizeof(void *) / sizeof(uint16_t) + 1;
+
+  ManyLedsProvider() {
+    for (size_t i = 0; i < kCount; ++i) {
+      size_t n = kCount - 1 - i;
+      devices_.push_back({V4DEV_LED, static_cast<uint8_t>(n / 256),
+                          static_cast<uint8_t>(n % 256), 0,
+                          static_cast<uint32_t>(n)});
+    }
+  }
+
+  span<const DeviceDesc> get_devices() const override {
+    return span<const DeviceDesc>{devices_.data(), devices_.size()};
+  }
+
+private:
+  std::vector<DeviceDesc> devices_;
+};
+
+TEST_CASE("CAP SYS: CAP_ENUM reports a table too large to group") {
+  ManyLedsProvider many;
+  Ddt::set_provider(&many);
+  register_cap_sys_handlers();
+  set_cap_memory(span<uint8_t>{g_memory, sizeof(g_memory)});
+
+  CHECK(invoke_sys_handler(V4SYS_CAP_COUNT, V4DEV_LED, 0, 0) ==
+        static_cast<int32_t>(ManyLedsProvider::kCount));
+  CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, -1, pack(4, 0)) == -1);
+
+  set_cap_memory(span<uint8_t>{});
+  Ddt::set_provider(&g_provider);
+}
+#else
+// Without the merged index an unsorted table cannot be grouped
+TEST_CASE("CAP SYS: CAP_ENUM reports an ungroupable table") {
+  Ddt::set_provider(&g_provider);
+  register_cap_sys_handlers();
+  set_cap_memory(span<uint8_t>{g_memory, sizeof(g_memory)});
+
+  CHECK(invoke_sys_handler(V4SYS_CAP_COUNT, V4DEV_LED, 0, 0) == 3);
+  CHECK(invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, -1, 4 << 16) == -1);
+
+  set_cap_memory(span<uint8_t>{});
+}
+#endif
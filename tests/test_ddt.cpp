@@ -7,14 +7,19 @@
 #include "doctest.h"
 
 #include "v4std/ddt.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 using namespace v4std;
 
 // Mock DDT provider for testing
 class MockDdtProvider : public DdtProvider {
 public:
-  span<const v4dev_desc_t> get_devices() const override {
-    static constexpr v4dev_desc_t devices[] = {
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
         // STATUS LED (GPIO7, active-high)
         {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
         // USER LED (GPIO8, active-high)
@@ -29,13 +34,26 @@ public:
         {V4DEV_TIMER, V4ROLE_STATUS, 0, 0, 0},
     };
 
-    return span<const v4dev_desc_t>{devices, 6};
+    return span<const DeviceDesc>{devices, 6};
   }
 };
 
 // Global provider instance for tests
 static MockDdtProvider g_provider;
 
+#if !V4STD_DDT_MERGED_INDEX
+class SortedTableProvider : public DdtProvider {
+public:
+  explicit SortedTableProvider(span<const DeviceDesc> devices)
+      : devices_(devices) {}
+
+  span<const DeviceDesc> get_devices() const override { return devices_; }
+
+private:
+  span<const DeviceDesc> devices_;
+};
+#endif
+
 TEST_CASE("DDT: get_all_devices") {
   Ddt::set_provider(&g_provider);
 
@@ -49,7 +67,7 @@ TEST_CASE("DDT: find_device - exact match") {
   auto *led = Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0);
   REQUIRE(led != nullptr);
   CHECK(led->kind == V4DEV_LED);
-  CHECK(led->role == V4ROLE_STATUS);
+  CHECK(desc_role(*led) == V4ROLE_STATUS);
   CHECK(led->index == 0);
   CHECK(led->handle == 7);
 }
@@ -61,7 +79,7 @@ TEST_CASE("DDT: find_device - different index") {
   REQUIRE(led != nullptr);
   CHECK(led->index == 1);
   CHECK(led->handle == 10);
-  CHECK((led->flags & V4DEV_FLAG_ACTIVE_LOW) != 0);
+  CHECK((desc_flags(*led) & V4DEV_FLAG_ACTIVE_LOW) != 0);
 }
 
 TEST_CASE("DDT: find_device - not found") {
@@ -77,7 +95,7 @@ TEST_CASE("DDT: find_default_device") {
   auto *button = Ddt::find_default_device(V4DEV_BUTTON, V4ROLE_USER);
   REQUIRE(button != nullptr);
   CHECK(button->kind == V4DEV_BUTTON);
-  CHECK(button->role == V4ROLE_USER);
+  CHECK(desc_role(*button) == V4ROLE_USER);
   CHECK(button->index == 0);
   CHECK(button->handle == 9);
 }
@@ -111,13 +129,93 @@ TEST_CASE("DDT: count_devices") {
   }
 }
 
+#if V4STD_DDT_MERGED_INDEX
+TEST_CASE("DDT: devices_of") {
+  Ddt::set_provider(&g_provider);
+
+  SUBCASE("By kind, sorted by role and index") {
+    DeviceList leds = Ddt::devices_of(V4DEV_LED);
+    REQUIRE(leds.size() == 3);
+    CHECK(leds[0].handle == 7); // STATUS/0
+    CHECK(leds[1].handle == 8); // USER/0
+    CHECK(leds[2].handle == 10); // USER/1
+
+    // Entries are the provider's descriptors
+    CHECK(&leds[2] == &g_provider.get_devices()[2]);
+
+    size_t count = 0;
+    for (const auto &led : leds) {
+      CHECK(led.kind == V4DEV_LED);
+      ++count;
+    }
+    CHECK(count == 3);
+  }
+
+  SUBCASE("By kind and role") {
+    DeviceList user = Ddt::devices_of(V4DEV_LED, V4ROLE_USER);
+    REQUIRE(user.size() == 2);
+    CHECK(user[0].index == 0);
+    CHECK(user[1].index == 1);
+
+    size_t position = 0;
+    CHECK(user.position_of(&user[1], position));
+    CHECK(position == 1);
+    CHECK_FALSE(user.position_of(&g_provider.get_devices()[0], position));
+
+    CHECK(Ddt::devices_of(V4DEV_LED, V4ROLE_STATUS).size() == 1);
+    CHECK(Ddt::devices_of(V4DEV_LED, V4ROLE_POWER).empty());
+  }
+
+  SUBCASE("Missing kind") {
+    CHECK(Ddt::devices_of(V4DEV_I2C).empty());
+    CHECK(Ddt::devices_of(V4DEV_NONE).empty());
+  }
+
+  SUBCASE("No provider") {
+    Ddt::set_provider(nullptr);
+    CHECK(Ddt::devices_of(V4DEV_LED).empty());
+    Ddt::set_provider(&g_provider);
+  }
+}
+#else
+// Without the merged index a lone table must be in key order to group
+TEST_CASE("DDT: devices_of without a merged index") {
+  static constexpr DeviceDesc kSorted[] = {
+      {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
+      {V4DEV_LED, V4ROLE_USER, 0, 0, 8},
+      {V4DEV_LED, V4ROLE_USER, 1, V4DEV_FLAG_ACTIVE_LOW, 10},
+      {V4DEV_BUTTON, V4ROLE_USER, 0, V4DEV_FLAG_ACTIVE_LOW, 9},
+  };
+  SortedTableProvider sorted{span<const DeviceDesc>{kSorted}};
+
+  Ddt::set_provider(&sorted);
+  DeviceList leds = Ddt::devices_of(V4DEV_LED);
+  REQUIRE(leds.size() == 3);
+  CHECK(&leds[2] == &kSorted[2]);
+  CHECK(Ddt::devices_of(V4DEV_LED, V4ROLE_USER).size() == 2);
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_USER, 1) == &kSorted[2]);
+
+  // g_provider lists its UART before its TIMER
+  Ddt::set_provider(&g_provider);
+  DeviceList group;
+  CHECK_FALSE(Ddt::try_devices_of(V4DEV_LED, group));
+  CHECK(Ddt::devices_of(V4DEV_LED).empty());
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_USER, 1) != nullptr);
+  CHECK(Ddt::count_devices(V4DEV_LED) == 3);
+
+  // Only one provider at a time
+  CHECK_FALSE(Ddt::add_provider(&sorted));
+  CHECK(Ddt::get_all_devices().size() == 6);
+}
+#endif
+
 TEST_CASE("DDT: Find UART by role") {
   Ddt::set_provider(&g_provider);
 
   auto *uart = Ddt::find_default_device(V4DEV_UART, V4ROLE_CONSOLE);
   REQUIRE(uart != nullptr);
   CHECK(uart->kind == V4DEV_UART);
-  CHECK(uart->role == V4ROLE_CONSOLE);
+  CHECK(desc_role(*uart) == V4ROLE_CONSOLE);
 }
 
 TEST_CASE("DDT: Find TIMER") {
@@ -149,3 +247,574 @@ TEST_CASE("DDT: Null provider behavior") {
   // Restore provider for other tests
   Ddt::set_provider(&g_provider);
 }
+
+// Heap-allocated table, as built on USB hot-plug. The destructor poisons
+// the entries so a reader still using them would notice.
+class HotplugProvider : public DdtProvider {
+public:
+  explicit HotplugProvider(uint32_t handle_base) {
+    for (uint8_t i = 0; i < 4; ++i) {
+      devices_.push_back({V4DEV_LED, V4ROLE_USER, i, 0, handle_base + i});
+    }
+  }
+
+  ~HotplugProvider() override {
+    for (auto &dev : devices_) {
+      dev.kind = 0xFF;
+      dev.handle = DeviceDescTraits<DeviceDesc>::max_handle;
+    }
+  }
+
+  span<const DeviceDesc> get_devices() const override {
+    return span<const DeviceDesc>{devices_.data(), devices_.size()};
+  }
+
+private:
+  std::vector<DeviceDesc> devices_;
+};
+
+TEST_CASE("DDT: Generation and device tokens") {
+  Ddt::set_provider(&g_provider);
+  uint32_t generation = Ddt::generation();
+
+  DeviceToken token = Ddt::find_token(V4DEV_LED, V4ROLE_USER, 1);
+  REQUIRE(token.desc != nullptr);
+  CHECK(token.generation == generation);
+  CHECK(Ddt::resolve(token) == token.desc);
+
+  DeviceToken missing = Ddt::find_token(V4DEV_LED, V4ROLE_USER, 9);
+  CHECK(missing.desc == nullptr);
+  CHECK(Ddt::resolve(missing) == nullptr);
+
+  // Replacing the provider (even with the same one) invalidates tokens
+  Ddt::set_provider(&g_provider);
+  CHECK(Ddt::generation() == generation + 1);
+  CHECK(Ddt::resolve(token) == nullptr);
+
+  token = Ddt::find_token(V4DEV_LED, V4ROLE_USER, 1);
+  CHECK(Ddt::resolve(token) == token.desc);
+}
+
+TEST_CASE("DDT: in_read_section tracks nested guards") {
+  CHECK_FALSE(Ddt::in_read_section());
+  {
+    Ddt::ReadGuard guard;
+    {
+      Ddt::ReadGuard nested;
+      CHECK(Ddt::in_read_section());
+    }
+    CHECK(Ddt::in_read_section());
+  }
+  CHECK_FALSE(Ddt::in_read_section());
+}
+
+TEST_CASE("DDT: set_provider waits for readers") {
+  Ddt::set_provider(&g_provider);
+  std::atomic<bool> swapped{false};
+
+  std::thread writer;
+  {
+    Ddt::ReadGuard guard;
+    Ddt::ReadGuard nested;
+    const DeviceDesc *led = Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0);
+    REQUIRE(led != nullptr);
+
+    writer = std::thread([&swapped] {
+      Ddt::set_provider(nullptr);
+      swapped.store(true);
+    });
+
+    // The new (empty) table is published immediately...
+    while (Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0) != nullptr) {
+      std::this_thread::yield();
+    }
+
+    // ...but the writer's grace period cannot end while we read the old one
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_FALSE(swapped.load());
+    CHECK(led->handle == 7);
+  }
+
+  writer.join();
+  CHECK(swapped.load());
+  Ddt::set_provider(&g_provider);
+}
+
+TEST_CASE("DDT: Hot-swap under concurrent readers") {
+  HotplugProvider *current = new HotplugProvider(0);
+  Ddt::set_provider(current);
+
+  std::atomic<bool> stop{false};
+  std::atomic<int> bad_reads{0};
+  std::atomic<uint64_t> reads{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; ++t) {
+    readers.emplace_back([&] {
+      DeviceToken token;
+      while (!stop.load(std::memory_order_relaxed)) {
+        Ddt::ReadGuard guard;
+        const DeviceDesc *led = Ddt::resolve(token);
+        if (!led) {
+          token = Ddt::find_token(V4DEV_LED, V4ROLE_USER, 2);
+          led = token.desc;
+        }
+        if (led && (led->kind != V4DEV_LED || led->handle % 4 != 2)) {
+          bad_reads.fetch_add(1);
+        }
+        reads.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  // Replace and free the table repeatedly while readers run
+  for (uint32_t i = 1; i <= 50; ++i) {
+    uint64_t seen = reads.load();
+    while (reads.load() == seen) {
+      std::this_thread::yield();
+    }
+
+    HotplugProvider *next = new HotplugProvider(i * 4);
+    Ddt::set_provider(next);
+    delete current;
+    current = next;
+  }
+
+  stop.store(true);
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  CHECK(bad_reads.load() == 0);
+  CHECK(reads.load() > 0);
+
+  Ddt::set_provider(&g_provider);
+  delete current;
+}
+
+// Expansion module table: overrides the user LED, adds a second UART
+class ExpansionProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_UART, V4ROLE_USER, 0, 0, 100},
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 101},
+        {V4DEV_ADC, V4ROLE_USER, 0, 0, 102},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+// Table of a given size with distinct keys
+class SizedProvider : public DdtProvider {
+public:
+  // Keys ascend with i, so the table is in key order unless reversed
+  SizedProvider(size_t count, uint8_t kind, bool reversed = false) {
+    for (size_t i = 0; i < count; ++i) {
+      devices_.push_back({kind, static_cast<uint8_t>(1 + i / 256),
+                          static_cast<uint8_t>(i % 256), 0,
+                          static_cast<uint32_t>(i)});
+    }
+    if (reversed) {
+      std::reverse(devices_.begin(), devices_.end());
+    }
+  }
+
+  span<const DeviceDesc> get_devices() const override {
+    return span<const DeviceDesc>{devices_.data(), devices_.size()};
+  }
+
+private:
+  std::vector<DeviceDesc> devices_;
+};
+
+static ExpansionProvider g_expansion;
+
+TEST_CASE("DDT: Single provider is used without copying") {
+  Ddt::set_provider(&g_provider);
+  CHECK(Ddt::provider_count() == 1);
+
+  DeviceList devices = Ddt::get_all_devices();
+  REQUIRE(devices.size() == 6);
+  CHECK(&devices[0] == g_provider.get_devices().data());
+  CHECK(devices[3].kind == V4DEV_BUTTON); // Provider order is kept
+
+  size_t position = 0;
+  CHECK(devices.position_of(&devices[4], position));
+  CHECK(position == 4);
+  DeviceDesc outside{};
+  CHECK_FALSE(devices.position_of(&outside, position));
+}
+
+#if V4STD_DDT_MERGED_INDEX
+TEST_CASE("DDT: Merged providers") {
+  Ddt::set_provider(&g_provider);
+  uint32_t generation = Ddt::generation();
+
+  CHECK(Ddt::add_provider(&g_expansion));
+  CHECK(Ddt::provider_count() == 2);
+  CHECK(Ddt::generation() == generation + 1);
+
+  SUBCASE("Union is sorted and deduplicated") {
+    // 6 + 3 descriptors, LED/USER/0 in both
+    DeviceList devices = Ddt::get_all_devices();
+    REQUIRE(devices.size() == 8);
+
+    uint32_t previous = 0;
+    bool sorted = true;
+    for (const auto &dev : devices) {
+      uint32_t key = (dev.kind << 16) | (desc_role(dev) << 8) | dev.index;
+      sorted = sorted && key > previous;
+      previous = key;
+    }
+    CHECK(sorted);
+
+    // Descriptors are the providers' own, not copies
+    const DeviceDesc *adc = Ddt::find_device(V4DEV_ADC, V4ROLE_USER, 0);
+    CHECK(adc == &g_expansion.get_devices()[2]);
+
+    size_t position = 0;
+    CHECK(devices.position_of(adc, position));
+    CHECK(&devices[position] == adc);
+
+    CHECK(Ddt::count_devices(V4DEV_LED) == 3);
+    CHECK(Ddt::count_devices(V4DEV_UART) == 2);
+    CHECK(Ddt::count_devices(V4DEV_ADC) == 1);
+    CHECK(Ddt::count_devices(V4DEV_PWM) == 0);
+
+    // Groups span both providers
+    DeviceList user = Ddt::devices_of(V4DEV_LED, V4ROLE_USER);
+    REQUIRE(user.size() == 2);
+    CHECK(user[0].handle == 8);
+    CHECK(user[1].handle == 10);
+    CHECK(Ddt::devices_of(V4DEV_UART).size() == 2);
+  }
+
+  SUBCASE("Equal priority: first added wins") {
+    const DeviceDesc *led = Ddt::find_device(V4DEV_LED, V4ROLE_USER, 0);
+    REQUIRE(led != nullptr);
+    CHECK(led->handle == 8);
+
+    // The losing duplicate is not part of the union
+    size_t position = 0;
+    CHECK_FALSE(Ddt::get_all_devices().position_of(
+        &g_expansion.get_devices()[1], position));
+  }
+
+  SUBCASE("Higher priority wins") {
+    CHECK(Ddt::remove_provider(&g_expansion));
+    CHECK(Ddt::add_provider(&g_expansion, 1));
+
+    const DeviceDesc *led = Ddt::find_device(V4DEV_LED, V4ROLE_USER, 0);
+    REQUIRE(led != nullptr);
+    CHECK(led->handle == 101);
+
+    // Keys only one provider has are unaffected
+    led = Ddt::find_device(V4DEV_LED, V4ROLE_USER, 1);
+    REQUIRE(led != nullptr);
+    CHECK(led->handle == 10);
+  }
+
+  SUBCASE("Removing a provider") {
+    CHECK(Ddt::remove_provider(&g_expansion));
+    CHECK_FALSE(Ddt::remove_provider(&g_expansion));
+    CHECK(Ddt::provider_count() == 1);
+    CHECK(Ddt::find_device(V4DEV_ADC, V4ROLE_USER, 0) == nullptr);
+    CHECK(Ddt::get_all_devices().size() == 6);
+  }
+
+  Ddt::set_provider(&g_provider);
+}
+#endif
+
+#if V4STD_DDT_MERGED_INDEX
+// Table that repeats a key
+class RepeatProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 1},
+        {V4DEV_BUTTON, V4ROLE_USER, 0, 0, 2},
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 3},
+        {V4DEV_LED, V4ROLE_USER, 1, 0, 4},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+static size_t count_leds_listed() {
+  size_t count = 0;
+  for (const auto &dev : Ddt::get_all_devices()) {
+    count += dev.kind == V4DEV_LED;
+  }
+  return count;
+}
+
+TEST_CASE("DDT: Counts agree with get_all_devices") {
+  RepeatProvider repeat;
+  Ddt::set_provider(&repeat);
+  DeviceQuery leds = DeviceQuery{}.with_kind(V4DEV_LED);
+
+  // Repeats within one table all count; lookups find the first
+  CHECK(count_leds_listed() == 3);
+  CHECK(Ddt::count_devices(V4DEV_LED) == 3);
+  CHECK(Ddt::count_matching(leds) == 3);
+  CHECK(Ddt::devices_of(V4DEV_LED).size() == 3);
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_USER, 0)->handle == 1);
+
+  size_t position = 0;
+  DeviceList user = Ddt::devices_of(V4DEV_LED, V4ROLE_USER);
+  CHECK(user.position_of(&repeat.get_devices()[2], position));
+  CHECK(position == 1);
+
+  // A second provider's LED/USER/0 is shadowed, the repeats are not
+  CHECK(Ddt::add_provider(&g_expansion));
+  CHECK(Ddt::get_all_devices().size() == 6);
+  CHECK(count_leds_listed() == 3);
+  CHECK(Ddt::count_devices(V4DEV_LED) == 3);
+  CHECK(Ddt::count_matching(leds) == 3);
+
+  // Until it takes precedence
+  CHECK(Ddt::remove_provider(&g_expansion));
+  CHECK(Ddt::add_provider(&g_expansion, 1));
+  CHECK(count_leds_listed() == 2);
+  CHECK(Ddt::count_devices(V4DEV_LED) == 2);
+  CHECK(Ddt::devices_of(V4DEV_LED).size() == 2);
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_USER, 0)->handle == 101);
+
+  Ddt::set_provider(&g_provider);
+}
+#endif
+
+#if V4STD_DDT_MERGED_INDEX
+TEST_CASE("DDT: Provider limits") {
+  Ddt::set_provider(nullptr);
+  CHECK(Ddt::provider_count() == 0);
+
+  CHECK_FALSE(Ddt::add_provider(nullptr));
+  CHECK(Ddt::add_provider(&g_provider));
+  CHECK_FALSE(Ddt::add_provider(&g_provider));
+
+  // Several providers must fit the merged index
+  SizedProvider big(V4STD_DDT_MAX_DEVICES, V4DEV_PWM);
+  uint32_t generation = Ddt::generation();
+  CHECK_FALSE(Ddt::add_provider(&big));
+  CHECK(Ddt::generation() == generation);
+  CHECK(Ddt::provider_count() == 1);
+
+  // A single larger provider is still usable
+  constexpr size_t kHuge = V4STD_DDT_MAX_DEVICES + 10;
+  SizedProvider huge(kHuge, V4DEV_PWM);
+  Ddt::set_provider(&huge);
+  CHECK(Ddt::get_all_devices().size() == kHuge);
+  const DeviceDesc &last = huge.get_devices()[kHuge - 1];
+  CHECK(Ddt::find_device(V4DEV_PWM, static_cast<v4dev_role_t>(desc_role(last)),
+                         last.index) == &last);
+  CHECK(Ddt::count_devices(V4DEV_PWM) == kHuge);
+  CHECK(Ddt::devices_of(V4DEV_PWM).size() == kHuge); // Its own order
+
+  // At most V4STD_DDT_MAX_PROVIDERS, all sharing one key here
+  std::vector<SizedProvider> small(V4STD_DDT_MAX_PROVIDERS + 1,
+                                   SizedProvider{1, V4DEV_LED});
+  Ddt::set_provider(nullptr);
+  for (size_t i = 0; i < V4STD_DDT_MAX_PROVIDERS; ++i) {
+    CHECK(Ddt::add_provider(&small[i]));
+  }
+  CHECK_FALSE(Ddt::add_provider(&small[V4STD_DDT_MAX_PROVIDERS]));
+  CHECK(Ddt::provider_count() == V4STD_DDT_MAX_PROVIDERS);
+  CHECK(Ddt::get_all_devices().size() == 1);
+
+  Ddt::set_provider(&g_provider);
+}
+#endif
+
+TEST_CASE("DDT: Bulk queries") {
+  Ddt::set_provider(&g_provider);
+
+  SUBCASE("count_matching") {
+    CHECK(Ddt::count_matching(DeviceQuery{}) == 6);
+    CHECK(Ddt::count_matching(DeviceQuery{}.with_kind(V4DEV_LED)) == 3);
+    CHECK(Ddt::count_matching(DeviceQuery{}.with_flags(
+              V4DEV_FLAG_ACTIVE_LOW, V4DEV_FLAG_ACTIVE_LOW)) == 2);
+    CHECK(Ddt::count_matching(
+              DeviceQuery{}.with_kind(V4DEV_LED).with_flags(
+                  V4DEV_FLAG_ACTIVE_LOW, 0)) == 2);
+    CHECK(Ddt::count_matching(DeviceQuery{}.with_handle(0)) == 2);
+    CHECK(Ddt::count_matching(
+              DeviceQuery{}.with_role(V4ROLE_USER).with_index(1)) == 1);
+    CHECK(Ddt::count_matching(DeviceQuery{}.with_kind(V4DEV_ADC)) == 0);
+  }
+
+  SUBCASE("select_matching") {
+    uint32_t positions[4] = {};
+    auto query = DeviceQuery{}.with_role(V4ROLE_USER);
+    CHECK(Ddt::select_matching(query, span<uint32_t>{positions}) == 3);
+    CHECK(positions[0] == 1);
+    CHECK(positions[1] == 2);
+    CHECK(positions[2] == 3);
+
+    // Truncated, total still reported
+    positions[1] = 99;
+    CHECK(Ddt::select_matching(query, span<uint32_t>{positions, 1}) == 3);
+    CHECK(positions[1] == 99);
+
+    DeviceList devices = Ddt::get_all_devices();
+    CHECK(Ddt::select_matching(DeviceQuery{}.with_handle(9),
+                               span<uint32_t>{positions}) == 1);
+    CHECK(devices[positions[0]].kind == V4DEV_BUTTON);
+  }
+
+#if V4STD_DDT_MERGED_INDEX
+  SUBCASE("Positions follow the merged index") {
+    CHECK(Ddt::add_provider(&g_expansion));
+    uint32_t positions[8] = {};
+    size_t total = Ddt::select_matching(DeviceQuery{}.with_role(V4ROLE_USER),
+                                        span<uint32_t>{positions});
+    CHECK(total == 5);
+
+    DeviceList devices = Ddt::get_all_devices();
+    for (size_t i = 0; i < total; ++i) {
+      CHECK(desc_role(devices[positions[i]]) == V4ROLE_USER);
+    }
+    CHECK(Ddt::count_matching(DeviceQuery{}.with_handle(101)) == 0); // Lost
+  }
+#endif
+
+  SUBCASE("Tables larger than the mirror") {
+    constexpr size_t kHuge = V4STD_DDT_MAX_DEVICES + 10;
+    SizedProvider huge(kHuge, V4DEV_PWM);
+    Ddt::set_provider(&huge);
+    CHECK(Ddt::count_matching(DeviceQuery{}.with_kind(V4DEV_PWM)) == kHuge);
+
+    // Handles name positions only if the descriptor layout can hold them
+    if (kHuge - 1 <= DeviceDescTraits<DeviceDesc>::max_handle) {
+      uint32_t position = 0;
+      CHECK(Ddt::select_matching(DeviceQuery{}.with_handle(kHuge - 1),
+                                 span<uint32_t>{&position, 1}) == 1);
+      CHECK(position == kHuge - 1);
+    }
+  }
+
+  SUBCASE("Every block position") {
+    // Spans several query blocks with a partial last one
+    SizedProvider sized(V4STD_DDT_MAX_DEVICES - 3, V4DEV_ADC);
+    Ddt::set_provider(&sized);
+    size_t count = V4STD_DDT_MAX_DEVICES - 3;
+    CHECK(Ddt::count_matching(DeviceQuery{}) == count);
+    CHECK(Ddt::count_matching(DeviceQuery{}.with_index(3)) ==
+          (count + 252) / 256);
+    for (uint32_t handle : {0u, 63u, 64u, static_cast<uint32_t>(count - 1)}) {
+      uint32_t position = 0;
+      CHECK(Ddt::select_matching(DeviceQuery{}.with_handle(handle),
+                                 span<uint32_t>{&position, 1}) == 1);
+      CHECK(position == handle);
+    }
+    CHECK(Ddt::count_matching(DeviceQuery{}.with_handle(
+              static_cast<uint32_t>(count))) == 0);
+  }
+
+  Ddt::set_provider(&g_provider);
+}
+
+#if V4STD_DDT_MERGED_INDEX
+TEST_CASE("DDT: Oversized providers are still grouped") {
+  constexpr size_t kHuge = V4STD_DDT_MAX_DEVICES + 10;
+  DeviceList group;
+
+  SUBCASE("In key order") {
+    SizedProvider huge(kHuge, V4DEV_PWM);
+    Ddt::set_provider(&huge);
+    CHECK(Ddt::try_devices_of(V4DEV_PWM, group));
+    CHECK(group.size() == kHuge);
+    CHECK(&group[0] == &huge.get_devices()[0]);
+    CHECK(Ddt::devices_of(V4DEV_PWM, V4ROLE_STATUS).size() == 256);
+    Ddt::set_provider(&g_provider);
+  }
+
+  SUBCASE("Unsorted, through a position index") {
+    SizedProvider huge(kHuge, V4DEV_PWM, true);
+    Ddt::set_provider(&huge);
+    CHECK(Ddt::try_devices_of(V4DEV_PWM, group));
+    REQUIRE(group.size() == kHuge);
+    CHECK(Ddt::count_devices(V4DEV_PWM) == kHuge);
+    CHECK(group[0].handle == 0);
+    CHECK(group[kHuge - 1].handle == kHuge - 1);
+    CHECK(&group[0] == &huge.get_devices()[kHuge - 1]);
+    CHECK(Ddt::devices_of(V4DEV_PWM, V4ROLE_STATUS).size() == 256);
+    CHECK(Ddt::find_device(V4DEV_PWM, V4ROLE_STATUS, 5) ==
+          &huge.get_devices()[kHuge - 6]);
+    Ddt::set_provider(&g_provider);
+  }
+
+  SUBCASE("Unsorted beyond the position index") {
+    constexpr size_t kTooMany =
+        V4STD_DDT_MAX_DEVICES * sizeof(void *) / sizeof(uint16_t) + 1;
+    SizedProvider huge(kTooMany, V4DEV_PWM, true);
+    Ddt::set_provider(&huge);
+    CHECK(Ddt::count_devices(V4DEV_PWM) == kTooMany);
+    CHECK_FALSE(Ddt::try_devices_of(V4DEV_PWM, group));
+    CHECK(group.empty());
+    CHECK(Ddt::find_device(V4DEV_PWM, V4ROLE_STATUS, 5) ==
+          &huge.get_devices()[kTooMany - 6]);
+
+    // Groups the presence filter rules out are still known to be empty
+    CHECK(Ddt::try_devices_of(V4DEV_LED, V4ROLE_USER, group));
+    CHECK(group.empty());
+    Ddt::set_provider(&g_provider);
+  }
+}
+#endif
+
+// Counts table reads after publication
+class CountingProvider : public SizedProvider {
+public:
+  using SizedProvider::SizedProvider;
+
+  span<const DeviceDesc> get_devices() const override {
+    ++reads;
+    return SizedProvider::get_devices();
+  }
+
+  mutable size_t reads = 0;
+};
+
+TEST_CASE("DDT: Misses skip the table") {
+  // Too large for the merged index: hits search the table itself
+  constexpr size_t kHuge = V4STD_DDT_MAX_DEVICES + 10;
+  CountingProvider huge(kHuge, V4DEV_PWM);
+  Ddt::set_provider(&huge);
+  huge.reads = 0;
+
+  // Absent kind, absent role, index past the group's highest
+  const DeviceDesc &last = huge.get_devices()[kHuge - 1];
+  huge.reads = 0;
+  auto role = static_cast<v4dev_role_t>(desc_role(last));
+  auto next_role = static_cast<v4dev_role_t>(desc_role(last) + 1);
+  auto past = static_cast<uint8_t>(last.index + 1);
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_USER, 0) == nullptr);
+  CHECK(Ddt::find_device(V4DEV_PWM, next_role, 0) == nullptr);
+  CHECK(Ddt::find_device(V4DEV_PWM, role, past) == nullptr);
+  CHECK(Ddt::devices_of(V4DEV_LED, V4ROLE_USER).empty());
+  CHECK(huge.reads == 0);
+
+  CHECK(Ddt::find_device(V4DEV_PWM, role, last.index) == &last);
+  CHECK(huge.reads == 1);
+
+  // Keys outside the filtered range are still searched
+  CHECK(Ddt::find_device(static_cast<v4dev_kind_t>(0x40), V4ROLE_USER, 0) ==
+        nullptr);
+  CHECK(huge.reads == 2);
+
+  // Rebuilt on every change
+  Ddt::set_provider(&g_provider);
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_USER, 1) != nullptr);
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_USER, 2) == nullptr);
+  CHECK(Ddt::find_device(V4DEV_PWM, V4ROLE_USER, 0) == nullptr);
+#if V4STD_DDT_MERGED_INDEX
+  CHECK(Ddt::add_provider(&g_expansion));
+  CHECK(Ddt::find_device(V4DEV_ADC, V4ROLE_USER, 0) != nullptr);
+  CHECK(Ddt::remove_provider(&g_expansion));
+  CHECK(Ddt::find_device(V4DEV_ADC, V4ROLE_USER, 0) == nullptr);
+#endif
+
+  Ddt::set_provider(&g_provider);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_ddt_attr.cpp
+ * @brief Tests for extended device attributes
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_attr.hpp"
+
+using namespace v4std;
+
+static constexpr DeviceDesc kDevices[] = {
+    {V4DEV_I2C, V4ROLE_USER, 0, 0, 0},
+    {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7}, // No attributes
+    {V4DEV_UART, V4ROLE_CONSOLE, 0, 0, 1},
+    {V4DEV_ADC, V4ROLE_USER, 0, 0, 2},
+    {V4DEV_DISPLAY, V4ROLE_USER, 0, 0, 3},
+    {V4DEV_BUTTON, V4ROLE_USER, 0, 0, 9}, // Past the attribute table
+};
+
+// Placed in read-only data
+static constexpr v4dev_attr_t kAttributes[] = {
+    make_attr(I2cAttr{0x3C, 400000}),
+    v4dev_attr_t{},
+    make_attr(UartAttr{115200, 8, 2, 1}),
+    make_attr(AdcAttr{-12, 4096 + 205, 3300, 12}),
+    make_attr(DisplayAttr{320, 240, 16, 1}),
+};
+
+// Packing is usable in constant expressions
+static_assert(make_attr(I2cAttr{0x3C, 400000}).data[0] == 0x3C);
+static_assert(make_attr(DisplayAttr{320, 240, 16, 1}).data[0] ==
+              (320u | (240u << 16)));
+
+class AttrProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    return span<const DeviceDesc>{kDevices};
+  }
+
+  span<const v4dev_attr_t> get_attributes() const override {
+    return span<const v4dev_attr_t>{kAttributes};
+  }
+};
+
+// Descriptors only
+class PlainProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_I2C, V4ROLE_DEBUG, 0, 0, 5},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+static AttrProvider g_provider;
+static PlainProvider g_plain;
+
+TEST_CASE("DdtAttr: Typed round trip") {
+  I2cAttr i2c{};
+  CHECK(decode_attr(kAttributes[0], i2c));
+  CHECK(i2c.address == 0x3C);
+  CHECK(i2c.speed_hz == 400000);
+
+  UartAttr uart{};
+  CHECK(decode_attr(kAttributes[2], uart));
+  CHECK(uart.baud == 115200);
+  CHECK(uart.data_bits == 8);
+  CHECK(uart.parity == 2);
+  CHECK(uart.stop_bits == 1);
+
+  AdcAttr adc{};
+  CHECK(decode_attr(kAttributes[3], adc));
+  CHECK(adc.offset == -12);
+  CHECK(adc.gain_q12 == 4096 + 205);
+  CHECK(adc.vref_mv == 3300);
+  CHECK(adc.resolution_bits == 12);
+  CHECK(adc.apply(4108) == 4301); // (4108 - 12) * 4301 / 4096
+
+  DisplayAttr display{};
+  CHECK(decode_attr(kAttributes[4], display));
+  CHECK(display.width == 320);
+  CHECK(display.height == 240);
+  CHECK(display.bpp == 16);
+  CHECK(display.rotation == 1);
+
+  // Wrong type
+  CHECK_FALSE(decode_attr(kAttributes[0], uart));
+  CHECK_FALSE(decode_attr(kAttributes[1], i2c));
+}
+
+TEST_CASE("DdtAttr: Lookup by descriptor slot") {
+  Ddt::set_provider(&g_provider);
+
+  const DeviceDesc *i2c_dev = Ddt::find_device(V4DEV_I2C, V4ROLE_USER, 0);
+  const v4dev_attr_t *attr = Ddt::find_attributes(i2c_dev);
+  CHECK(attr == &kAttributes[0]);
+
+  UartAttr uart{};
+  CHECK(get_device_attr(Ddt::find_device(V4DEV_UART, V4ROLE_CONSOLE, 0),
+                        uart));
+  CHECK(uart.baud == 115200);
+
+  DisplayAttr display{};
+  CHECK(get_device_attr(Ddt::find_device(V4DEV_DISPLAY, V4ROLE_USER, 0),
+                        display));
+  CHECK(display.width == 320);
+
+  // Unset slot, slot past the table, wrong type, missing device
+  CHECK(Ddt::find_attributes(Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0)) ==
+        nullptr);
+  CHECK(Ddt::find_attributes(&kDevices[5]) == nullptr);
+  I2cAttr i2c{};
+  CHECK_FALSE(get_device_attr(Ddt::find_device(V4DEV_ADC, V4ROLE_USER, 0),
+                              i2c));
+  CHECK_FALSE(get_device_attr(Ddt::find_device(V4DEV_SPI, V4ROLE_USER, 0),
+                              i2c));
+  CHECK(Ddt::find_attributes(nullptr) == nullptr);
+
+  Ddt::set_provider(nullptr);
+}
+
+#if V4STD_DDT_MERGED_INDEX
+TEST_CASE("DdtAttr: Several providers") {
+  Ddt::set_provider(&g_plain);
+  CHECK(Ddt::add_provider(&g_provider));
+
+  // Each descriptor maps to its own provider's table
+  I2cAttr i2c{};
+  CHECK(get_device_attr(Ddt::find_device(V4DEV_I2C, V4ROLE_USER, 0), i2c));
+  CHECK(i2c.address == 0x3C);
+  CHECK_FALSE(get_device_attr(Ddt::find_device(V4DEV_I2C, V4ROLE_DEBUG, 0),
+                              i2c));
+
+  // Not installed
+  CHECK(Ddt::remove_provider(&g_provider));
+  CHECK(Ddt::find_attributes(&kDevices[0]) == nullptr);
+
+  Ddt::set_provider(nullptr);
+}
+#endif
@@ -0,0 +1,277 @@
+/**
+ * @file test_ddt_image.cpp
+ * @brief Tests for binary DDT images and MappedDdtProvider
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_image.hpp"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if V4STD_TEST_MAPPED_FILE
+#include "v4std/linux/ddt_image_file.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace v4std;
+
+// Unsorted
+static constexpr DeviceDesc kDevices[] = {
+    {V4DEV_UART, V4ROLE_CONSOLE, 0, 0, 0},
+    {V4DEV_LED, V4ROLE_USER, 1, V4DEV_FLAG_ACTIVE_LOW, 10},
+    {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
+    {V4DEV_BUTTON, V4ROLE_USER, 0, V4DEV_FLAG_ACTIVE_LOW, 9},
+    {V4DEV_LED, V4ROLE_USER, 0, 0, 8},
+    {V4DEV_PWM, V4ROLE_USER, 0, 0, 11},
+};
+
+// Image buffer with the alignment attach() requires
+struct ImageBuffer {
+  std::vector<uint32_t> words;
+  size_t size = 0;
+
+  uint8_t *data() { return reinterpret_cast<uint8_t *>(words.data()); }
+  span<const uint8_t> bytes() { return span<const uint8_t>{data(), size}; }
+};
+
+static ImageBuffer build(span<const DeviceDesc> devices) {
+  ImageBuffer image;
+  size_t capacity = ddt_image_size(devices);
+  image.words.resize((capacity + 3) / 4);
+  image.size = build_ddt_image(devices, span<uint8_t>{image.data(), capacity});
+  return image;
+}
+
+TEST_CASE("DdtImage: Build and attach") {
+  span<const DeviceDesc> devices{kDevices};
+  ImageBuffer image = build(devices);
+  REQUIRE(image.size > 0);
+  CHECK(image.size <= ddt_image_size(devices));
+
+  DdtImageHeader header;
+  std::memcpy(&header, image.data(), sizeof(header));
+  CHECK(std::memcmp(header.magic, "V4DT", 4) == 0);
+  CHECK(header.version == kDdtImageVersion);
+  CHECK(header.device_count == 6);
+  CHECK(header.index_count == 6);
+  CHECK(header.image_size == image.size);
+
+  MappedDdtProvider provider;
+  CHECK_FALSE(provider.is_attached());
+  REQUIRE(provider.attach(image.bytes()));
+  CHECK(provider.is_attached());
+  CHECK(provider.has_lookup());
+
+  // Served in place, table order kept
+  span<const DeviceDesc> table = provider.get_devices();
+  REQUIRE(table.size() == 6);
+  CHECK(reinterpret_cast<const uint8_t *>(table.data()) ==
+        image.data() + header.devices_offset);
+  CHECK(table[3].kind == V4DEV_BUTTON);
+
+  const DeviceDesc *led = provider.lookup(V4DEV_LED, V4ROLE_STATUS, 0);
+  REQUIRE(led != nullptr);
+  CHECK(led->handle == 7);
+  CHECK(led == &table[2]);
+  CHECK(desc_flags(*provider.lookup(V4DEV_LED, V4ROLE_USER, 1)) ==
+        V4DEV_FLAG_ACTIVE_LOW);
+  CHECK(provider.lookup(V4DEV_UART, V4ROLE_CONSOLE, 0) == &table[0]);
+  CHECK(provider.lookup(V4DEV_LED, V4ROLE_USER, 2) == nullptr);
+  CHECK(provider.lookup(V4DEV_ADC, V4ROLE_USER, 0) == nullptr);
+
+  provider.detach();
+  CHECK_FALSE(provider.is_attached());
+  CHECK(provider.get_devices().empty());
+  CHECK(provider.lookup(V4DEV_LED, V4ROLE_STATUS, 0) == nullptr);
+}
+
+TEST_CASE("DdtImage: Empty table") {
+  ImageBuffer image = build(span<const DeviceDesc>{});
+  REQUIRE(image.size == sizeof(DdtImageHeader));
+
+  MappedDdtProvider provider;
+  REQUIRE(provider.attach(image.bytes()));
+  CHECK(provider.get_devices().empty());
+  CHECK(provider.lookup(V4DEV_LED, V4ROLE_STATUS, 0) == nullptr);
+}
+
+TEST_CASE("DdtImage: Builder rejects a small buffer") {
+  span<const DeviceDesc> devices{kDevices};
+  std::vector<uint32_t> words(64);
+  uint8_t *out = reinterpret_cast<uint8_t *>(words.data());
+  CHECK(build_ddt_image(devices,
+                        span<uint8_t>{out, ddt_image_size(devices) - 1}) ==
+        0);
+}
+
+TEST_CASE("DdtImage: Builder rejects a misaligned buffer") {
+  span<const DeviceDesc> devices{kDevices};
+  std::vector<uint32_t> words(64);
+  uint8_t *out = reinterpret_cast<uint8_t *>(words.data()) + 1;
+  CHECK(build_ddt_image(devices,
+                        span<uint8_t>{out, ddt_image_size(devices)}) == 0);
+}
+
+TEST_CASE("DdtImage: Builder rejects repeated keys") {
+  static constexpr DeviceDesc kRepeated[] = {
+      {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
+      {V4DEV_UART, V4ROLE_CONSOLE, 0, 0, 0},
+      {V4DEV_LED, V4ROLE_STATUS, 0, 0, 70},
+  };
+  CHECK(build(span<const DeviceDesc>{kRepeated}).size == 0);
+}
+
+TEST_CASE("DdtImage: Invalid images are rejected") {
+  span<const DeviceDesc> devices{kDevices};
+  ImageBuffer image = build(devices);
+  REQUIRE(image.size > 0);
+
+  MappedDdtProvider provider;
+  DdtImageHeader header;
+  std::memcpy(&header, image.data(), sizeof(header));
+
+  SUBCASE("Truncated") {
+    CHECK_FALSE(provider.attach(
+        span<const uint8_t>{image.data(), image.size - 1}));
+    CHECK_FALSE(provider.attach(span<const uint8_t>{image.data(), 16}));
+    CHECK_FALSE(provider.attach(span<const uint8_t>{}));
+  }
+
+  SUBCASE("Misaligned") {
+    std::vector<uint32_t> words(image.words.size() + 1);
+    uint8_t *shifted = reinterpret_cast<uint8_t *>(words.data()) + 1;
+    std::memcpy(shifted, image.data(), image.size);
+    CHECK_FALSE(provider.attach(span<const uint8_t>{shifted, image.size}));
+  }
+
+  SUBCASE("Bad magic or version") {
+    image.data()[0] = 'X';
+    CHECK_FALSE(provider.attach(image.bytes()));
+
+    image.data()[0] = 'V';
+    header.version = kDdtImageVersion + 1;
+    std::memcpy(image.data(), &header, sizeof(header));
+    CHECK_FALSE(provider.attach(image.bytes()));
+  }
+
+  SUBCASE("Offsets out of range") {
+    header.index_offset = header.image_size;
+    std::memcpy(image.data(), &header, sizeof(header));
+    CHECK_FALSE(provider.attach(image.bytes()));
+
+    std::memcpy(&header, image.data(), sizeof(header));
+    header.index_offset = static_cast<uint32_t>(
+        image.size - header.index_count * sizeof(uint16_t));
+    header.device_count = 0xFFFFFFFFu;
+    std::memcpy(image.data(), &header, sizeof(header));
+    CHECK_FALSE(provider.attach(image.bytes()));
+  }
+
+  SUBCASE("Corrupted payload") {
+    // Flip a handle byte: checksum mismatch
+    image.data()[header.devices_offset + 4] ^= 0x01;
+    CHECK_FALSE(provider.attach(image.bytes()));
+  }
+
+  SUBCASE("Index missing an entry") {
+    header.index_count -= 1;
+    std::memcpy(image.data(), &header, sizeof(header));
+    CHECK_FALSE(provider.attach(image.bytes()));
+  }
+
+  SUBCASE("Index out of order") {
+    // Swap two index entries and fix up the checksum
+    uint16_t *index =
+        reinterpret_cast<uint16_t *>(image.data() + header.index_offset);
+    uint16_t first = index[0];
+    index[0] = index[1];
+    index[1] = first;
+
+    uint32_t hash = 2166136261u;
+    for (size_t i = sizeof(DdtImageHeader); i < image.size; ++i) {
+      hash = (hash ^ image.data()[i]) * 16777619u;
+    }
+    header.checksum = hash;
+    std::memcpy(image.data(), &header, sizeof(header));
+    CHECK_FALSE(provider.attach(image.bytes()));
+  }
+
+  CHECK_FALSE(provider.is_attached());
+}
+
+TEST_CASE("DdtImage: Installed in Ddt") {
+  ImageBuffer image = build(span<const DeviceDesc>{kDevices});
+  MappedDdtProvider provider;
+  REQUIRE(provider.attach(image.bytes()));
+
+  // Alone, the image's own index answers lookups
+  Ddt::set_provider(&provider);
+  const DeviceDesc *led = Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0);
+  REQUIRE(led != nullptr);
+  CHECK(led->handle == 7);
+  CHECK(Ddt::get_all_devices().size() == 6);
+
+  // Groups come from the image's index
+  DeviceList leds = Ddt::devices_of(V4DEV_LED);
+  REQUIRE(leds.size() == 3);
+  CHECK(&leds[0] == led);
+  CHECK(leds[2].handle == 10);
+  CHECK(Ddt::devices_of(V4DEV_LED, V4ROLE_USER).size() == 2);
+  CHECK(Ddt::count_devices(V4DEV_LED) == 3);
+
+  // Merged with another provider, it is indexed like any other
+  MappedDdtProvider other;
+  static constexpr DeviceDesc kExtra[] = {{V4DEV_ADC, V4ROLE_USER, 0, 0, 1}};
+  ImageBuffer extra = build(span<const DeviceDesc>{kExtra});
+  REQUIRE(other.attach(extra.bytes()));
+#if V4STD_DDT_MERGED_INDEX
+  CHECK(Ddt::add_provider(&other));
+  CHECK(Ddt::find_device(V4DEV_ADC, V4ROLE_USER, 0) != nullptr);
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0)->handle == 7);
+  CHECK(Ddt::get_all_devices().size() == 7);
+#else
+  CHECK_FALSE(Ddt::add_provider(&other));
+#endif
+
+  Ddt::set_provider(nullptr);
+}
+
+#if V4STD_TEST_MAPPED_FILE
+TEST_CASE("DdtImage: MappedDdtFile") {
+  ImageBuffer image = build(span<const DeviceDesc>{kDevices});
+
+  char path[] = "/tmp/test_ddt_image_XXXXXX";
+  int fd = mkstemp(path);
+  REQUIRE(fd >= 0);
+  CHECK(write(fd, image.data(), image.size) ==
+        static_cast<ssize_t>(image.size));
+  close(fd);
+
+  MappedDdtFile file;
+  REQUIRE(file.open(path));
+  CHECK(file.size() == image.size);
+  CHECK(file.provider().lookup(V4DEV_BUTTON, V4ROLE_USER, 0)->handle == 9);
+
+  Ddt::set_provider(&file.provider());
+  CHECK(Ddt::find_device(V4DEV_UART, V4ROLE_CONSOLE, 0) != nullptr);
+  Ddt::set_provider(nullptr);
+
+  file.close();
+  CHECK_FALSE(file.provider().is_attached());
+  CHECK_FALSE(file.open("/nonexistent/board.ddt"));
+
+  // Not an image
+  fd = open(path, O_WRONLY | O_TRUNC);
+  REQUIRE(fd >= 0);
+  CHECK(write(fd, "hello", 5) == 5);
+  close(fd);
+  CHECK_FALSE(file.open(path));
+
+  unlink(path);
+}
+#endif
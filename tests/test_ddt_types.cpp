@@ -6,10 +6,15 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include "v4std/ddt.hpp"
 #include "v4std/ddt_types.h"
+#include <type_traits>
 
 // Test C++ compilation
 static_assert(sizeof(v4dev_desc_t) == 8, "v4dev_desc_t must be 8 bytes");
+static_assert(sizeof(v4dev_desc_compact_t) == 4,
+              "v4dev_desc_compact_t must be 4 bytes");
+static_assert(sizeof(v4dev_attr_t) == 12, "v4dev_attr_t must be 12 bytes");
 
 TEST_CASE("v4dev_desc_t: Struct size") { CHECK(sizeof(v4dev_desc_t) == 8); }
 
@@ -54,3 +59,81 @@ TEST_CASE("v4dev_desc_t: Active-low flag") {
 
   CHECK((button.flags & V4DEV_FLAG_ACTIVE_LOW) != 0);
 }
+
+TEST_CASE("v4dev_desc_compact_t: Same fields in 4 bytes") {
+  static constexpr v4dev_desc_compact_t table[] = {
+      {V4DEV_LED, V4DEV_COMPACT_ROLE_FLAGS(V4ROLE_USER, V4DEV_FLAG_ACTIVE_LOW),
+       1, 10},
+      {V4DEV_UART, V4DEV_COMPACT_ROLE_FLAGS(V4ROLE_DEBUG, 0x0F), 255, 255},
+  };
+  static_assert(sizeof(table) == 8);
+
+  CHECK(table[0].kind == V4DEV_LED);
+  CHECK(V4DEV_COMPACT_ROLE(table[0]) == V4ROLE_USER);
+  CHECK(table[0].index == 1);
+  CHECK(V4DEV_COMPACT_FLAGS(table[0]) == V4DEV_FLAG_ACTIVE_LOW);
+  CHECK(table[0].handle == 10);
+  CHECK(V4DEV_COMPACT_ROLE(table[1]) == V4ROLE_DEBUG);
+  CHECK(table[1].index == 255);
+  CHECK(V4DEV_COMPACT_FLAGS(table[1]) == 0x0F);
+  CHECK(table[1].handle == 255);
+
+  // Byte layout is fixed: kind, role | flags << 4, index, handle
+  const auto *bytes = reinterpret_cast<const uint8_t *>(&table[0]);
+  CHECK(bytes[0] == V4DEV_LED);
+  CHECK(bytes[1] == (V4ROLE_USER | V4DEV_FLAG_ACTIVE_LOW << 4));
+  CHECK(bytes[2] == 1);
+  CHECK(bytes[3] == 10);
+}
+
+TEST_CASE("v4dev_desc_compact_t: C++ constructor") {
+  constexpr v4std::CompactDeviceDesc desc{V4DEV_LED, V4ROLE_STATUS, 2,
+                                          V4DEV_FLAG_ACTIVE_LOW, 7};
+  static_assert(v4std::desc_role(desc) == V4ROLE_STATUS);
+  static_assert(v4std::desc_flags(desc) == V4DEV_FLAG_ACTIVE_LOW);
+  CHECK(desc.index == 2);
+  CHECK(desc.handle == 7);
+}
+
+// Constant-evaluates only if the fields fit the compact layout
+template <uint32_t Role, uint32_t Flags, uint32_t Handle, typename = void>
+struct compact_constant : std::false_type {};
+template <uint32_t Role, uint32_t Flags, uint32_t Handle>
+struct compact_constant<
+    Role, Flags, Handle,
+    std::void_t<std::integral_constant<
+        uint8_t, v4std::CompactDeviceDesc{V4DEV_LED, Role, 0, Flags, Handle}
+                     .handle>>> : std::true_type {};
+
+static_assert(compact_constant<0x0F, 0x0F, 0xFF>::value);
+static_assert(!compact_constant<0x10, 0, 0>::value, "role too large");
+static_assert(!compact_constant<0, 0x10, 0>::value, "flags too large");
+static_assert(!compact_constant<0, 0, 300>::value, "handle too large");
+
+TEST_CASE("v4dev_desc_compact_t: Conversion") {
+  using v4std::desc_fits;
+  using v4std::make_desc;
+  using v4std::to_c_desc;
+
+  constexpr v4dev_desc_t wide = {V4DEV_BUTTON, V4ROLE_POWER, 3,
+                                 V4DEV_FLAG_ACTIVE_LOW, 42};
+  static_assert(desc_fits<v4dev_desc_compact_t>(wide));
+
+  constexpr v4dev_desc_compact_t narrow = make_desc<v4dev_desc_compact_t>(wide);
+  constexpr v4dev_desc_t back = to_c_desc(narrow);
+  CHECK(back.kind == wide.kind);
+  CHECK(back.role == wide.role);
+  CHECK(back.index == wide.index);
+  CHECK(back.flags == wide.flags);
+  CHECK(back.handle == wide.handle);
+
+  // Fields past the compact ranges
+  CHECK_FALSE(desc_fits<v4dev_desc_compact_t>(
+      v4dev_desc_t{V4DEV_LED, V4ROLE_USER, 0, 0, 256}));
+  CHECK_FALSE(desc_fits<v4dev_desc_compact_t>(
+      v4dev_desc_t{V4DEV_LED, 16, 0, 0, 0}));
+  CHECK_FALSE(desc_fits<v4dev_desc_compact_t>(
+      v4dev_desc_t{V4DEV_LED, V4ROLE_USER, 0, 0x10, 0}));
+  CHECK(desc_fits<v4dev_desc_t>(
+      v4dev_desc_t{V4DEV_LED, V4ROLE_USER, 0, 0xFF, 0xFFFFFFFFu}));
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_device_lock.cpp
+ * @brief Tests for per-device locking of SYS handlers
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_types.h"
+#include "v4std/device_lock.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_led.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace v4std;
+
+// LED HAL with plain (unsynchronized) state: correct only if each handle
+// sees one call at a time
+class PlainLedHal : public LedHal {
+public:
+  bool states[8] = {};
+
+  bool set_led(uint32_t handle, bool state, bool active_low) override {
+    states[handle] = active_low ? !state : state;
+    return true;
+  }
+
+  bool get_led(uint32_t handle, bool active_low) override {
+    return active_low ? !states[handle] : states[handle];
+  }
+};
+
+class LockTestProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 0},
+        {V4DEV_LED, V4ROLE_USER, 1, 0, 1},
+        {V4DEV_LED, V4ROLE_USER, 2, 0, 2},
+        {V4DEV_LED, V4ROLE_USER, 3, 0, 3},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+// Same LEDs at other positions
+class ShiftedTestProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_BUTTON, V4ROLE_USER, 0, 0, 4},
+        {V4DEV_BUTTON, V4ROLE_USER, 1, 0, 5},
+        {V4DEV_LED, V4ROLE_USER, 2, 0, 2},
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 0},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+static PlainLedHal g_hal;
+static LockTestProvider g_provider;
+static ShiftedTestProvider g_shifted;
+
+static constexpr uint32_t led_key(uint8_t index) {
+  return DeviceLocks::key_of(V4DEV_LED, V4ROLE_USER, index);
+}
+
+// Records whether the device lock was held while the handler ran
+static std::atomic<int> g_locked_calls{0};
+static int32_t probe_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                             int32_t arg2) {
+  (void)sys_id;
+  uint32_t key = DeviceLocks::key_of(static_cast<v4dev_kind_t>(arg0),
+                                     static_cast<v4dev_role_t>(arg1),
+                                     static_cast<uint8_t>(arg2));
+  if (!DeviceLocks::try_lock(key)) {
+    g_locked_calls.fetch_add(1);
+    return 1;
+  }
+  DeviceLocks::unlock(key);
+  return 0;
+}
+
+TEST_CASE("DeviceLocks: Slots and try_lock") {
+  CHECK(DeviceLocks::slot_count() == V4STD_DDT_LOCK_SLOTS);
+  CHECK(DeviceLocks::key_of(V4DEV_LED, V4ROLE_USER, 3) == 0x010203);
+  for (uint8_t index = 0; index < 4; ++index) {
+    CHECK(DeviceLocks::slot_of(led_key(index)) < DeviceLocks::slot_count());
+  }
+  // Consecutive indices use different slots
+  CHECK(DeviceLocks::slot_of(led_key(0)) != DeviceLocks::slot_of(led_key(1)));
+
+  DeviceLocks::lock(led_key(0));
+  CHECK_FALSE(DeviceLocks::try_lock(led_key(0)));
+  CHECK(DeviceLocks::try_lock(led_key(1))); // Different device and slot
+  DeviceLocks::unlock(led_key(1));
+  DeviceLocks::unlock(led_key(0));
+  CHECK(DeviceLocks::try_lock(led_key(0)));
+  DeviceLocks::unlock(led_key(0));
+
+  {
+    DeviceLockGuard guard{led_key(2)};
+    CHECK_FALSE(DeviceLocks::try_lock(led_key(2)));
+  }
+  CHECK(DeviceLocks::try_lock(led_key(2)));
+  DeviceLocks::unlock(led_key(2));
+}
+
+TEST_CASE("DeviceLocks: Flagged handlers run under the device lock") {
+  clear_sys_handlers();
+  Ddt::set_provider(&g_provider);
+  g_locked_calls = 0;
+
+  register_sys_handler(V4SYS_LED_ON, probe_handler, V4SYS_HANDLER_DEVICE_LOCK);
+  register_sys_handler(V4SYS_LED_OFF, probe_handler);
+  CHECK(get_sys_handler_flags(V4SYS_LED_ON) == V4SYS_HANDLER_DEVICE_LOCK);
+  CHECK(get_sys_handler_flags(V4SYS_LED_OFF) == 0);
+  CHECK(get_sys_handler_flags(V4SYS_BUTTON_READ) == 0); // Unregistered
+
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 2) == 1);
+  CHECK(invoke_sys_handler(V4SYS_LED_OFF, V4DEV_LED, V4ROLE_USER, 2) == 0);
+
+  // Unknown device: handler runs unlocked
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_STATUS, 2) == 0);
+
+  // Stack dispatch takes the same path
+  int32_t stack[4] = {V4DEV_LED, V4ROLE_USER, 1};
+  size_t depth = 3;
+  CHECK(dispatch_sys_call(V4SYS_LED_ON, stack, depth, 4) ==
+        SysCallStatus::Ok);
+  CHECK(stack[0] == 1);
+  CHECK(g_locked_calls == 2);
+
+  // The lock is released afterwards
+  CHECK(DeviceLocks::try_lock(led_key(2)));
+  DeviceLocks::unlock(led_key(2));
+
+  // A provider that moves the device keeps its lock
+  Ddt::set_provider(&g_shifted);
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 2) == 1);
+  CHECK(g_locked_calls == 3);
+
+  clear_sys_handlers();
+  Ddt::set_provider(nullptr);
+}
+
+TEST_CASE("DeviceLocks: Concurrent toggles are not lost") {
+  clear_sys_handlers();
+  Ddt::set_provider(&g_provider);
+  set_led_hal(&g_hal);
+  register_led_sys_handlers();
+
+  CHECK(get_sys_handler_flags(V4SYS_LED_TOGGLE) == V4SYS_HANDLER_DEVICE_LOCK);
+
+  for (bool &state : g_hal.states) {
+    state = false;
+  }
+
+  // Each device is toggled an odd number of times in total
+  constexpr int kThreads = 4;
+  constexpr int kToggles = 5001;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < kToggles; ++i) {
+        for (int32_t index = 0; index < 4; ++index) {
+          invoke_sys_handler(V4SYS_LED_TOGGLE, V4DEV_LED, V4ROLE_USER, index);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // 4 x 5001 toggles per device: even, so every LED ends up off
+  for (int index = 0; index < 4; ++index) {
+    CHECK_FALSE(g_hal.states[index]);
+  }
+
+  // One more toggle on device 1 only
+  invoke_sys_handler(V4SYS_LED_TOGGLE, V4DEV_LED, V4ROLE_USER, 1);
+  CHECK(g_hal.states[1]);
+  CHECK_FALSE(g_hal.states[0]);
+
+  clear_sys_handlers();
+  set_led_hal(nullptr);
+  Ddt::set_provider(nullptr);
+}
@@ -0,0 +1,332 @@
+/**
+ * @file test_device_owner.cpp
+ * @brief Tests for device ownership and call forwarding
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_types.h"
+#include "v4std/device_owner.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_led.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace v4std;
+
+// LED HAL that records which thread last touched each handle
+class ThreadLedHal : public LedHal {
+public:
+  bool states[4] = {};
+  std::thread::id last_thread[4];
+
+  bool set_led(uint32_t handle, bool state, bool active_low) override {
+    states[handle] = active_low ? !state : state;
+    last_thread[handle] = std::this_thread::get_id();
+    return true;
+  }
+
+  bool get_led(uint32_t handle, bool active_low) override {
+    last_thread[handle] = std::this_thread::get_id();
+    return active_low ? !states[handle] : states[handle];
+  }
+};
+
+class OwnerTestProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 0},
+        {V4DEV_LED, V4ROLE_USER, 1, 0, 1},
+        {V4DEV_LED, V4ROLE_USER, 2, 0, 2},
+        {V4DEV_LED, V4ROLE_USER, 3, 0, 3},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+// The same LEDs behind a status LED, so every USER LED moves one slot up
+class ShiftedTestProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_LED, V4ROLE_STATUS, 0, 0, 3},
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 0},
+        {V4DEV_LED, V4ROLE_USER, 1, 0, 1},
+        {V4DEV_LED, V4ROLE_USER, 2, 0, 2},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+static ThreadLedHal g_hal;
+static OwnerTestProvider g_provider;
+static ShiftedTestProvider g_shifted_provider;
+
+static void setup() {
+  clear_sys_handlers();
+  clear_device_owners();
+  Ddt::set_provider(&g_provider);
+  set_led_hal(&g_hal);
+  register_led_sys_handlers();
+  for (int i = 0; i < 4; ++i) {
+    g_hal.states[i] = false;
+    g_hal.last_thread[i] = std::thread::id{};
+  }
+}
+
+static void teardown() {
+  clear_device_owners();
+  clear_sys_handlers();
+  set_led_hal(nullptr);
+  Ddt::set_provider(nullptr);
+}
+
+// Owner thread: binds, signals readiness, drains until stopped
+struct OwnerThread {
+  DeviceOwner owner;
+  std::atomic<bool> ready{false};
+  std::atomic<bool> stop{false};
+  std::thread::id id;
+  std::thread thread;
+
+  void start() {
+    thread = std::thread([this] {
+      owner.bind_current_thread();
+      id = std::this_thread::get_id();
+      ready.store(true);
+      while (!stop.load()) {
+        if (owner.drain() == 0) {
+          std::this_thread::yield();
+        }
+      }
+      owner.drain();
+      DeviceOwner::unbind_current_thread();
+    });
+    while (!ready.load()) {
+      std::this_thread::yield();
+    }
+  }
+
+  void join() {
+    stop.store(true);
+    thread.join();
+  }
+};
+
+TEST_CASE("DeviceOwner: Owner table") {
+  DeviceOwner owner;
+  clear_device_owners();
+
+  CHECK(get_device_owner(V4DEV_LED, V4ROLE_USER, 0) == nullptr);
+  CHECK(set_device_owner(V4DEV_LED, V4ROLE_USER, 1, &owner));
+  CHECK(get_device_owner(V4DEV_LED, V4ROLE_USER, 1) == &owner);
+  CHECK(get_device_owner(V4DEV_LED, V4ROLE_USER, 0) == nullptr);
+  CHECK(get_device_owner(V4DEV_LED, V4ROLE_STATUS, 1) == nullptr);
+
+  CHECK(set_device_owner(V4DEV_LED, V4ROLE_USER, 1, nullptr));
+  CHECK(get_device_owner(V4DEV_LED, V4ROLE_USER, 1) == nullptr);
+
+  // One slot per device ever pinned, reused when it is pinned again
+  for (size_t i = 1; i < V4STD_MAX_DEVICE_OWNERS; ++i) {
+    auto kind = static_cast<v4dev_kind_t>(0x80 + (i >> 8));
+    CHECK(set_device_owner(kind, V4ROLE_USER, static_cast<uint8_t>(i),
+                           &owner));
+  }
+  auto first_kind = static_cast<v4dev_kind_t>(0x80);
+  CHECK(get_device_owner(first_kind, V4ROLE_USER, 1) == &owner);
+  CHECK(set_device_owner(V4DEV_LED, V4ROLE_USER, 1, &owner));
+  CHECK_FALSE(set_device_owner(V4DEV_LED, V4ROLE_USER, 2, &owner));
+  CHECK(set_device_owner(V4DEV_LED, V4ROLE_USER, 2, nullptr));
+  CHECK(get_device_owner(V4DEV_LED, V4ROLE_USER, 1) == &owner);
+  clear_device_owners();
+  CHECK(get_device_owner(V4DEV_LED, V4ROLE_USER, 1) == nullptr);
+
+  CHECK(DeviceOwner::current() == nullptr);
+  owner.bind_current_thread();
+  CHECK(DeviceOwner::current() == &owner);
+  DeviceOwner::unbind_current_thread();
+  CHECK(DeviceOwner::current() == nullptr);
+}
+
+TEST_CASE("DeviceOwner: Calls run on the owner thread") {
+  setup();
+
+  OwnerThread owner_thread;
+  owner_thread.start();
+  set_device_owner(V4DEV_LED, V4ROLE_USER, 2, &owner_thread.owner);
+
+  // Owned device: forwarded and executed by the owner thread
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 2) == 1);
+  CHECK(g_hal.states[2]);
+  CHECK(g_hal.last_thread[2] == owner_thread.id);
+  CHECK(invoke_sys_handler(V4SYS_LED_GET, V4DEV_LED, V4ROLE_USER, 2) == 1);
+  CHECK(owner_thread.owner.forwarded() == 2);
+
+  // Unowned device: runs on the calling thread
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 0) == 1);
+  CHECK(g_hal.last_thread[0] == std::this_thread::get_id());
+
+  // Stack dispatch takes the same path
+  int32_t stack[4] = {V4DEV_LED, V4ROLE_USER, 2};
+  size_t depth = 3;
+  CHECK(dispatch_sys_call(V4SYS_LED_GET, stack, depth, 4) ==
+        SysCallStatus::Ok);
+  CHECK(stack[0] == 1);
+  CHECK(owner_thread.owner.forwarded() == 3);
+
+  owner_thread.join();
+  teardown();
+}
+
+TEST_CASE("DeviceOwner: Owner's own calls run directly") {
+  setup();
+
+  DeviceOwner owner;
+  owner.bind_current_thread();
+  set_device_owner(V4DEV_LED, V4ROLE_USER, 1, &owner);
+
+  // No drain needed: the calling thread is the owner
+  CHECK(invoke_sys_handler(V4SYS_LED_TOGGLE, V4DEV_LED, V4ROLE_USER, 1) ==
+        1);
+  CHECK(g_hal.states[1]);
+  CHECK(owner.forwarded() == 0);
+  CHECK(owner.drain() == 0);
+
+  DeviceOwner::unbind_current_thread();
+  teardown();
+}
+
+TEST_CASE("DeviceOwner: Concurrent forwarded toggles are not lost") {
+  setup();
+
+  OwnerThread owner_thread;
+  owner_thread.start();
+  for (uint8_t index = 0; index < 4; ++index) {
+    set_device_owner(V4DEV_LED, V4ROLE_USER, index, &owner_thread.owner);
+  }
+
+  constexpr int kThreads = 4;
+  constexpr int kToggles = 1001;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < kToggles; ++i) {
+        for (int32_t index = 0; index < 4; ++index) {
+          invoke_sys_handler(V4SYS_LED_TOGGLE, V4DEV_LED, V4ROLE_USER, index);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  owner_thread.join();
+
+  // 4 x 1001 toggles per device: even, so every LED ends up off
+  for (int index = 0; index < 4; ++index) {
+    CHECK_FALSE(g_hal.states[index]);
+    CHECK(g_hal.last_thread[index] == owner_thread.id);
+  }
+  CHECK(owner_thread.owner.forwarded() == kThreads * kToggles * 4);
+  CHECK(owner_thread.owner.max_batch() >= 1);
+  CHECK(owner_thread.owner.max_batch() <= DeviceOwner::kQueueSize);
+
+  teardown();
+}
+
+TEST_CASE("DeviceOwner: Pins follow the device across provider changes") {
+  setup();
+
+  OwnerThread owner_thread;
+  owner_thread.start();
+  set_device_owner(V4DEV_LED, V4ROLE_USER, 2, &owner_thread.owner);
+
+  // USER 2 now sits in the slot USER 1 used to have
+  Ddt::set_provider(&g_shifted_provider);
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 2) == 1);
+  CHECK(g_hal.last_thread[2] == owner_thread.id);
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 1) == 1);
+  CHECK(g_hal.last_thread[1] == std::this_thread::get_id());
+  CHECK(owner_thread.owner.forwarded() == 1);
+
+  owner_thread.join();
+  teardown();
+}
+
+TEST_CASE("DeviceOwner: Owner can replace the provider during a forward") {
+  setup();
+
+  // The owner swaps providers before serving a pending call; a caller
+  // that waited inside a read guard would block the swap forever
+  DeviceOwner owner;
+  set_device_owner(V4DEV_LED, V4ROLE_USER, 2, &owner);
+  std::atomic<bool> calling{false};
+  std::thread owner_thread([&] {
+    owner.bind_current_thread();
+    while (!calling.load()) {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Ddt::set_provider(&g_shifted_provider);
+    while (owner.drain() == 0) {
+      std::this_thread::yield();
+    }
+    DeviceOwner::unbind_current_thread();
+  });
+
+  calling.store(true);
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 2) == 1);
+  owner_thread.join();
+  CHECK(g_hal.states[2]);
+  CHECK(owner.forwarded() == 1);
+  CHECK(Ddt::get_all_devices().size() == 4);
+  CHECK(Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0) != nullptr);
+
+  teardown();
+}
+
+TEST_CASE("DeviceOwner: Owners forwarding to each other do not deadlock") {
+  setup();
+
+  // Each owner thread owns one device and hammers the other's device
+  DeviceOwner owners[2];
+  set_device_owner(V4DEV_LED, V4ROLE_USER, 0, &owners[0]);
+  set_device_owner(V4DEV_LED, V4ROLE_USER, 1, &owners[1]);
+
+  constexpr int kCalls = 2000;
+  std::atomic<int> finished{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&owners, &finished, t] {
+      owners[t].bind_current_thread();
+      int32_t other = 1 - t;
+      for (int i = 0; i < kCalls; ++i) {
+        invoke_sys_handler(V4SYS_LED_TOGGLE, V4DEV_LED, V4ROLE_USER, other);
+        owners[t].drain();
+      }
+      finished.fetch_add(1);
+      // Keep serving the peer until it is done too
+      while (finished.load() < 2) {
+        owners[t].drain();
+        std::this_thread::yield();
+      }
+      DeviceOwner::unbind_current_thread();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  CHECK(owners[0].forwarded() == kCalls);
+  CHECK(owners[1].forwarded() == kCalls);
+  CHECK_FALSE(g_hal.states[0]);
+  CHECK_FALSE(g_hal.states[1]);
+
+  teardown();
+}
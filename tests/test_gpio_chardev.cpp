@@ -0,0 +1,315 @@
+/**
+ * @file test_gpio_chardev.cpp
+ * @brief Tests for the GPIO character-device HALs against a fake chip
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt.hpp"
+#include "v4std/linux/gpio_chardev.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include <cstring>
+#include <linux/gpio.h>
+#include <unistd.h>
+
+using namespace v4std;
+
+/**
+ * @brief In-process gpiochip
+ *
+ * Line requests are backed by a pipe, so epoll sees edge events written
+ * by emit() exactly as it would see the kernel's.
+ */
+class FakeGpioIo : public GpioIo {
+public:
+  static constexpr int kChipFd = 1000;
+
+  ~FakeGpioIo() override {
+    if (line_fd >= 0) {
+      ::close(line_fd);
+      ::close(event_fd);
+    }
+  }
+
+  int open(const char *path, int flags) override {
+    (void)flags;
+    if (strcmp(path, "/dev/gpiochip0") != 0) {
+      return -1;
+    }
+    ++chip_opens;
+    return kChipFd;
+  }
+
+  int close(int fd) override {
+    if (fd == kChipFd) {
+      ++chip_closes;
+      return 0;
+    }
+    if (fd == line_fd) {
+      ::close(line_fd);
+      ::close(event_fd);
+      line_fd = -1;
+      event_fd = -1;
+      return 0;
+    }
+    return -1;
+  }
+
+  int ioctl(int fd, unsigned long request, void *arg) override {
+    if (fd == kChipFd && request == GPIO_V2_GET_LINE_IOCTL) {
+      if (line_fd >= 0) {
+        return -1;
+      }
+      auto &req = *static_cast<gpio_v2_line_request *>(arg);
+      int fds[2];
+      if (pipe(fds) != 0) {
+        return -1;
+      }
+      line_fd = fds[0];
+      event_fd = fds[1];
+      line_request = req;
+      req.fd = line_fd;
+      const auto &attr = req.config.attrs[0];
+      if (req.config.num_attrs > 0 &&
+          attr.attr.id == GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES) {
+        levels = attr.attr.values & attr.mask;
+      }
+      return 0;
+    }
+
+    if (fd != line_fd) {
+      return -1;
+    }
+    auto &values = *static_cast<gpio_v2_line_values *>(arg);
+    if (request == GPIO_V2_LINE_SET_VALUES_IOCTL) {
+      ++set_calls;
+      last_set = values;
+      levels = (levels & ~values.mask) | (values.bits & values.mask);
+      return 0;
+    }
+    if (request == GPIO_V2_LINE_GET_VALUES_IOCTL) {
+      values.bits = levels & values.mask;
+      return 0;
+    }
+    return -1;
+  }
+
+  ssize_t read(int fd, void *buf, size_t size) override {
+    return ::read(fd, buf, size);
+  }
+
+  void emit(uint32_t offset, bool rising, uint64_t timestamp_ns) {
+    gpio_v2_line_event event = {};
+    event.timestamp_ns = timestamp_ns;
+    event.id = rising ? GPIO_V2_LINE_EVENT_RISING_EDGE
+                      : GPIO_V2_LINE_EVENT_FALLING_EDGE;
+    event.offset = offset;
+    REQUIRE(::write(event_fd, &event, sizeof(event)) == sizeof(event));
+  }
+
+  gpio_v2_line_request line_request = {};
+  gpio_v2_line_values last_set = {};
+  uint64_t levels = 0;
+  int line_fd = -1;
+  int event_fd = -1;
+  int chip_opens = 0;
+  int chip_closes = 0;
+  int set_calls = 0;
+};
+
+class LedProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_LED, V4ROLE_STATUS, 0, 0, 27},
+        {V4DEV_LED, V4ROLE_USER, 0, V4DEV_FLAG_ACTIVE_LOW, 22},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+static LedProvider g_provider;
+static const uint32_t kLedOffsets[] = {17, 27, 22};
+static const uint32_t kButtonOffsets[] = {5, 6};
+
+TEST_CASE("GPIO LED: One request covers every line") {
+  FakeGpioIo io;
+  GpioLedHal leds(io);
+
+  CHECK_FALSE(leds.open("/dev/gpiochip9", span<const uint32_t>{kLedOffsets}));
+  REQUIRE(leds.open("/dev/gpiochip0", span<const uint32_t>{kLedOffsets}));
+  CHECK(leds.fd() == io.line_fd);
+  CHECK(io.chip_opens == 1);
+  CHECK(io.chip_closes == 1);
+
+  CHECK(io.line_request.num_lines == 3);
+  CHECK(io.line_request.offsets[0] == 17);
+  CHECK(io.line_request.offsets[2] == 22);
+  CHECK(strcmp(io.line_request.consumer, "v4std-led") == 0);
+  CHECK(io.line_request.config.flags == GPIO_V2_LINE_FLAG_OUTPUT);
+  CHECK(io.line_request.config.attrs[0].attr.id ==
+        GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES);
+  CHECK(io.line_request.config.attrs[0].mask == 0x7);
+  CHECK(io.line_request.config.attrs[0].attr.values == 0);
+
+  // A second HAL cannot claim the lines
+  GpioLedHal other(io);
+  CHECK_FALSE(other.open("/dev/gpiochip0", span<const uint32_t>{kLedOffsets}));
+
+  leds.close();
+  CHECK(io.line_fd == -1);
+}
+
+TEST_CASE("GPIO LED: Active-low LEDs start off") {
+  FakeGpioIo io;
+  GpioLedHal leds(io);
+  REQUIRE(leds.open("/dev/gpiochip0", span<const uint32_t>{kLedOffsets},
+                    0x4 | (uint64_t{1} << 40)));
+
+  // Bits beyond the request are ignored
+  CHECK(io.line_request.config.attrs[0].attr.values == 0x4);
+  CHECK(io.levels == 0x4);
+  CHECK_FALSE(leds.get_led(22, true));
+  CHECK_FALSE(leds.get_led(17, false));
+  CHECK(io.set_calls == 0);
+}
+
+TEST_CASE("GPIO LED: Unbatched updates") {
+  FakeGpioIo io;
+  GpioLedHal leds(io);
+  REQUIRE(leds.open("/dev/gpiochip0", span<const uint32_t>{kLedOffsets}));
+
+  CHECK(leds.set_led(27, true, false));
+  CHECK(io.set_calls == 1);
+  CHECK(io.last_set.mask == 0x2);
+  CHECK(io.last_set.bits == 0x2);
+  CHECK(leds.get_led(27, false));
+  CHECK_FALSE(leds.get_led(17, false));
+
+  // Active-low LEDs are on at level 0
+  CHECK(leds.set_led(22, true, true));
+  CHECK(io.last_set.mask == 0x4);
+  CHECK(io.last_set.bits == 0);
+  CHECK(leds.get_led(22, true));
+  CHECK(io.levels == 0x2);
+
+  // Lines outside the request
+  CHECK_FALSE(leds.set_led(4, true, false));
+  CHECK(io.set_calls == 2);
+}
+
+TEST_CASE("GPIO LED: A batch is one ioctl") {
+  FakeGpioIo io;
+  GpioLedHal leds(io);
+  REQUIRE(leds.open("/dev/gpiochip0", span<const uint32_t>{kLedOffsets}));
+  io.levels = 0x4;
+
+  leds.begin_batch();
+  CHECK(leds.set_led(17, true, false));
+  CHECK(leds.set_led(27, true, false));
+  CHECK(leds.set_led(27, false, false));
+  CHECK(io.set_calls == 0);
+
+  // Reads see the batch, other lines the hardware
+  CHECK_FALSE(leds.get_led(27, false));
+  CHECK(leds.get_led(17, false));
+  CHECK(leds.get_led(22, false));
+
+  // Nested batches apply at the outermost end
+  leds.begin_batch();
+  CHECK(leds.set_led(22, false, false));
+  CHECK(leds.end_batch());
+  CHECK(io.set_calls == 0);
+
+  CHECK(leds.end_batch());
+  CHECK(io.set_calls == 1);
+  CHECK(io.last_set.mask == 0x7);
+  CHECK(io.last_set.bits == 0x1);
+  CHECK(io.levels == 0x1);
+
+  // Empty batches issue nothing
+  leds.begin_batch();
+  CHECK(leds.end_batch());
+  CHECK(io.set_calls == 1);
+}
+
+TEST_CASE("GPIO LED: Drives the LED SYS calls") {
+  FakeGpioIo io;
+  GpioLedHal leds(io);
+  REQUIRE(
+      leds.open("/dev/gpiochip0", span<const uint32_t>{kLedOffsets}, 0x4));
+
+  Ddt::set_provider(&g_provider);
+  set_led_hal(&leds);
+  clear_sys_handlers();
+  register_led_sys_handlers();
+  CHECK(invoke_sys_handler(V4SYS_LED_GET, V4DEV_LED, V4ROLE_USER, 0) == 0);
+
+  leds.begin_batch();
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_STATUS, 0) == 1);
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 0) == 1);
+  CHECK(invoke_sys_handler(V4SYS_LED_TOGGLE, V4DEV_LED, V4ROLE_USER, 0) ==
+        1);
+  CHECK(io.set_calls == 0);
+  CHECK(leds.end_batch());
+
+  CHECK(io.set_calls == 1);
+  CHECK(io.last_set.mask == 0x6);
+  CHECK(io.last_set.bits == 0x6); // Toggled off; line 22 is active-low
+  CHECK(invoke_sys_handler(V4SYS_LED_GET, V4DEV_LED, V4ROLE_USER, 0) == 0);
+  CHECK(invoke_sys_handler(V4SYS_LED_GET, V4DEV_LED, V4ROLE_STATUS, 0) == 1);
+
+  clear_sys_handlers();
+  set_led_hal(nullptr);
+  Ddt::set_provider(nullptr);
+}
+
+TEST_CASE("GPIO button: Edge events through epoll") {
+  FakeGpioIo io;
+  GpioButtonHal buttons(io);
+  REQUIRE(buttons.open("/dev/gpiochip0", span<const uint32_t>{kButtonOffsets},
+                       5000));
+  CHECK(buttons.epoll_fd() >= 0);
+
+  CHECK(io.line_request.num_lines == 2);
+  CHECK(io.line_request.config.flags ==
+        (GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING |
+         GPIO_V2_LINE_FLAG_EDGE_FALLING));
+  CHECK(io.line_request.config.attrs[0].attr.id ==
+        GPIO_V2_LINE_ATTR_ID_DEBOUNCE);
+  CHECK(io.line_request.config.attrs[0].attr.debounce_period_us == 5000);
+  CHECK(io.line_request.config.attrs[0].mask == 0x3);
+
+  GpioButtonEvent event;
+  CHECK_FALSE(buttons.wait_event(event, 0));
+
+  io.emit(6, false, 100);
+  io.emit(6, true, 200);
+  io.emit(5, false, 300);
+
+  REQUIRE(buttons.wait_event(event, 1000));
+  CHECK(event.handle == 6);
+  CHECK_FALSE(event.rising);
+  CHECK(event.timestamp_ns == 100);
+  REQUIRE(buttons.wait_event(event, 0));
+  CHECK(event.rising);
+  REQUIRE(buttons.wait_event(event, 0));
+  CHECK(event.handle == 5);
+  CHECK(event.timestamp_ns == 300);
+  CHECK_FALSE(buttons.wait_event(event, 0));
+
+  // Active-low buttons read pressed at level 0
+  bool pressed = false;
+  io.levels = 0x2;
+  CHECK(buttons.get_button(5, true, pressed));
+  CHECK(pressed);
+  CHECK(buttons.get_button(6, true, pressed));
+  CHECK_FALSE(pressed);
+  CHECK_FALSE(buttons.get_button(7, true, pressed));
+
+  buttons.close();
+  CHECK(buttons.epoll_fd() == -1);
+  CHECK_FALSE(buttons.wait_event(event, 0));
+}
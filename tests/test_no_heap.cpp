@@ -0,0 +1,481 @@
+/**
+ * @file test_no_heap.cpp
+ * @brief Allocation-free guarantee test (V4STD_NO_HEAP builds)
+ *
+ * Replaces the global allocation functions with counting versions. On
+ * glibc, malloc/calloc/realloc are interposed as well, so allocations made
+ * through the C library are caught too. Each test initializes the library,
+ * arms the counter, exercises the runtime API, and disarms the counter
+ * before making any assertion (doctest itself may allocate). Helper threads
+ * are started before arming, since creating a thread allocates.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/capability.hpp"
+#include "v4std/ddt.hpp"
+#include "v4std/ddt_attr.hpp"
+#include "v4std/ddt_types.h"
+#include "v4std/device_owner.hpp"
+#include "v4std/sys_coro.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_led.hpp"
+#include "v4std/sys_meta.hpp"
+#include "v4std/sys_trace.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#if V4STD_ROM_DISPATCH
+#include "v4std/sys_dispatch_table.h"
+#endif
+
+static_assert(V4STD_NO_HEAP, "test_no_heap requires a V4STD_NO_HEAP build");
+
+#if V4STD_ROM_DISPATCH
+// Runtime registrations go to the overlay
+static constexpr size_t kHandlerCapacity = V4STD_SYS_OVERLAY_HANDLERS;
+#else
+static constexpr size_t kHandlerCapacity = V4STD_MAX_SYS_HANDLERS;
+#endif
+
+// ============================================================================
+// Allocation counter
+// ============================================================================
+
+static std::atomic<bool> g_armed{false};
+static std::atomic<size_t> g_allocations{0};
+
+static void note_allocation() {
+  if (g_armed.load(std::memory_order_relaxed)) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+static void arm() {
+  g_allocations.store(0);
+  g_armed.store(true);
+}
+
+static size_t disarm() {
+  g_armed.store(false);
+  return g_allocations.load();
+}
+
+#if defined(__GLIBC__)
+// operator new goes through malloc, so counting here covers both
+#define V4STD_TEST_MALLOC_HOOK 1
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) noexcept {
+  note_allocation();
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept {
+  note_allocation();
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept {
+  note_allocation();
+  return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) noexcept { __libc_free(ptr); }
+}
+#else
+#define V4STD_TEST_MALLOC_HOOK 0
+#endif
+
+static void *counted_new(size_t size) {
+#if !V4STD_TEST_MALLOC_HOOK
+  note_allocation();
+#endif
+  void *ptr = std::malloc(size ? size : 1);
+  if (!ptr) {
+    std::abort();
+  }
+  return ptr;
+}
+
+void *operator new(size_t size) { return counted_new(size); }
+void *operator new[](size_t size) { return counted_new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return counted_new(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return counted_new(size);
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+// Escapes allocations so the compiler cannot elide them
+static void *volatile g_sink;
+
+// ============================================================================
+// Fixtures (fixed storage only)
+// ============================================================================
+
+using namespace v4std;
+
+class FixedLedHal : public LedHal {
+public:
+  bool states[16] = {};
+
+  bool set_led(uint32_t handle, bool state, bool active_low) override {
+    states[handle & 15] = active_low ? !state : state;
+    return true;
+  }
+
+  bool get_led(uint32_t handle, bool active_low) override {
+    bool physical = states[handle & 15];
+    return active_low ? !physical : physical;
+  }
+};
+
+class FixedDdtProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
+        {V4DEV_LED, V4ROLE_USER, 0, 0, 8},
+        {V4DEV_LED, V4ROLE_USER, 1, V4DEV_FLAG_ACTIVE_LOW, 10},
+        {V4DEV_BUTTON, V4ROLE_USER, 0, 0, 9},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+// Second provider with attributes, merged in at run time
+class FixedAttrProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_UART, V4ROLE_CONSOLE, 0, 0, 1},
+        {V4DEV_I2C, V4ROLE_USER, 0, 0, 2},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+
+  span<const v4dev_attr_t> get_attributes() const override {
+    static constexpr v4dev_attr_t attributes[] = {
+        make_attr(UartAttr{115200, 8, 0, 1}),
+        make_attr(I2cAttr{0x3C, 400000}),
+    };
+    return span<const v4dev_attr_t>{attributes};
+  }
+};
+
+static FixedLedHal g_hal;
+static FixedDdtProvider g_provider;
+static FixedAttrProvider g_attr_provider;
+static uint8_t g_cap_memory[64];
+static uint8_t g_trace_buffer[256];
+
+static uint32_t fixed_clock() { return 0; }
+
+// Empty registry. ROM dispatch builds also hide every ROM table entry.
+static void reset_handlers() {
+  clear_sys_handlers();
+#if V4STD_ROM_DISPATCH
+  for (const SysHandlerEntry &entry : kRomSysHandlers) {
+    unregister_sys_handler(entry.sys_id);
+  }
+#endif
+  REQUIRE(get_sys_handler_count() == 0);
+}
+
+static int32_t mock_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                            int32_t arg2) {
+  return static_cast<int32_t>(sys_id) + arg0 + arg1 + arg2;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TEST_CASE("NoHeap: Harness detects allocations") {
+  arm();
+  g_sink = std::malloc(16);
+  std::free(g_sink);
+  g_sink = new int(1);
+  delete static_cast<int *>(g_sink);
+  size_t allocations = disarm();
+
+  CHECK(allocations >= 2);
+}
+
+TEST_CASE("NoHeap: SYS runtime does not allocate after init") {
+  // Initialization
+  reset_handlers();
+  register_led_sys_handlers();
+  set_led_hal(&g_hal);
+  Ddt::set_provider(&g_provider);
+
+  arm();
+
+  int32_t on = invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 1);
+  int32_t get = invoke_sys_handler(V4SYS_LED_GET, V4DEV_LED, V4ROLE_USER, 1);
+  int32_t toggle =
+      invoke_sys_handler(V4SYS_LED_TOGGLE, V4DEV_LED, V4ROLE_STATUS, 0);
+  int32_t missing = invoke_sys_handler(V4SYS_UART_WRITE, 0, 0, 0);
+
+  int32_t stack[8] = {V4DEV_LED, V4ROLE_USER, 0};
+  size_t depth = 3;
+  SysCallStatus status = dispatch_sys_call(V4SYS_LED_ON, stack, depth, 8);
+
+  bool replaced = register_sys_handler(V4SYS_LED_ON, mock_handler);
+  bool added = register_sys_handler(0x0F80, mock_handler);
+  unregister_sys_handler(0x0F80);
+  SysHandler handler = get_sys_handler(V4SYS_LED_ON);
+  size_t handlers = get_sys_handler_count();
+
+  const DeviceDesc *led = Ddt::find_device(V4DEV_LED, V4ROLE_USER, 1);
+  size_t leds = Ddt::count_devices(V4DEV_LED);
+  size_t all = Ddt::get_all_devices().size();
+  const SysMeta *meta = find_sys_meta(V4SYS_LED_SET);
+
+  clear_sys_handlers();
+
+  size_t allocations = disarm();
+
+  CHECK(allocations == 0);
+  CHECK(on == 1);
+  CHECK(get == 1);
+  CHECK(toggle == 1);
+  CHECK(missing == -1);
+  CHECK(status == SysCallStatus::Ok);
+  CHECK(depth == 1);
+  CHECK(stack[0] == 1);
+  CHECK(replaced);
+  CHECK(added);
+  CHECK(handler == mock_handler);
+  CHECK(handlers == 5);
+  REQUIRE(led != nullptr);
+  CHECK(led->handle == 10);
+  CHECK(leds == 3);
+  CHECK(all == 4);
+  REQUIRE(meta != nullptr);
+  CHECK(meta->in_arity == 4);
+
+  Ddt::set_provider(nullptr);
+  set_led_hal(nullptr);
+}
+
+TEST_CASE("NoHeap: Handler registry has fixed capacity") {
+  reset_handlers();
+
+  arm();
+  size_t accepted = 0;
+  for (uint16_t i = 0; i < kHandlerCapacity; ++i) {
+    // Register in descending order to exercise the sorted insert
+    uint16_t id = static_cast<uint16_t>(0x1000 + kHandlerCapacity - i);
+    accepted += register_sys_handler(id, mock_handler) ? 1 : 0;
+  }
+  bool overflow = register_sys_handler(0x2000, mock_handler);
+  bool replace = register_sys_handler(0x1001, mock_handler);
+  unregister_sys_handler(0x1001);
+  bool after_remove = register_sys_handler(0x2000, mock_handler);
+  int32_t result = invoke_sys_handler(0x2000, 1, 2, 3);
+  size_t count = get_sys_handler_count();
+  size_t allocations = disarm();
+
+  CHECK(allocations == 0);
+  CHECK(accepted == kHandlerCapacity);
+  CHECK_FALSE(overflow);
+  CHECK(replace);
+  CHECK(after_remove);
+  CHECK(result == 0x2000 + 6);
+  CHECK(count == kHandlerCapacity);
+  CHECK(get_sys_handler(0x1001) == nullptr);
+  CHECK(get_sys_handler(0x1002) == mock_handler);
+
+  reset_handlers();
+}
+
+TEST_CASE("NoHeap: DDT queries and providers do not allocate") {
+  reset_handlers();
+  register_cap_sys_handlers();
+  set_cap_memory(span<uint8_t>{g_cap_memory, sizeof(g_cap_memory)});
+  Ddt::set_provider(&g_provider);
+
+  arm();
+
+  bool added = Ddt::add_provider(&g_attr_provider, 1);
+  DeviceList leds = Ddt::devices_of(V4DEV_LED);
+  DeviceList users = Ddt::devices_of(V4DEV_LED, V4ROLE_USER);
+
+  DeviceQuery query = DeviceQuery{}.with_kind(V4DEV_LED);
+  size_t matching = Ddt::count_matching(query);
+  uint32_t positions[4] = {};
+  size_t picked = Ddt::select_matching(query, span<uint32_t>{positions});
+
+  const DeviceDesc *uart = Ddt::find_device(V4DEV_UART, V4ROLE_CONSOLE, 0);
+  const v4dev_attr_t *attr = Ddt::find_attributes(uart);
+  const v4dev_attr_t *no_attr =
+      Ddt::find_attributes(Ddt::find_device(V4DEV_LED, V4ROLE_STATUS, 0));
+
+  // Up to 4 descriptors at address 0
+  int32_t listed =
+      invoke_sys_handler(V4SYS_CAP_ENUM, V4DEV_LED, -1, (4 << 16) | 0);
+  int32_t stack[8] = {V4DEV_LED, V4ROLE_USER, 2, 32};
+  size_t depth = 4;
+  SysCallStatus status = dispatch_sys_call(V4SYS_CAP_ENUM, stack, depth, 8);
+
+  bool removed = Ddt::remove_provider(&g_attr_provider);
+  const DeviceDesc *gone = Ddt::find_device(V4DEV_UART, V4ROLE_CONSOLE, 0);
+
+  size_t allocations = disarm();
+
+  CHECK(allocations == 0);
+  CHECK(added);
+  CHECK(leds.size() == 3);
+  CHECK(users.size() == 2);
+  CHECK(matching == 3);
+  CHECK(picked == 3);
+  REQUIRE(uart != nullptr);
+  REQUIRE(attr != nullptr);
+  CHECK(attr->kind == V4DEV_UART);
+  CHECK(no_attr == nullptr);
+  CHECK(listed == 3);
+  CHECK(status == SysCallStatus::Ok);
+  CHECK(stack[0] == 2);
+  CHECK(removed);
+  CHECK(gone == nullptr);
+
+  set_cap_memory(span<uint8_t>{});
+  Ddt::set_provider(nullptr);
+  reset_handlers();
+}
+
+TEST_CASE("NoHeap: SYS tracing does not allocate") {
+  reset_handlers();
+  register_led_sys_handlers();
+  set_led_hal(&g_hal);
+  Ddt::set_provider(&g_provider);
+  SysTraceRecorder recorder{span<uint8_t>{g_trace_buffer}, fixed_clock};
+
+  arm();
+
+  int32_t in[3] = {V4DEV_LED, V4ROLE_USER, 0};
+  bool recorded = recorder.record_call(V4SYS_LED_ON, in, 3, 1);
+  recorder.attach();
+  int32_t on = invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 1);
+  recorder.detach();
+  size_t records = recorder.record_count();
+
+  size_t allocations = disarm();
+
+  CHECK(allocations == 0);
+  CHECK(recorded);
+  CHECK(on == 1);
+  CHECK(records == 2);
+
+  Ddt::set_provider(nullptr);
+  set_led_hal(nullptr);
+  reset_handlers();
+}
+
+static int32_t add_one(void *context) {
+  return *static_cast<int32_t *>(context) + 1;
+}
+
+TEST_CASE("NoHeap: Forwarding to a device owner does not allocate") {
+  reset_handlers();
+  register_led_sys_handlers();
+  set_led_hal(&g_hal);
+  Ddt::set_provider(&g_provider);
+
+  // The owner thread is started, and has bound itself, before arming
+  static DeviceOwner owner;
+  std::atomic<bool> ready{false};
+  std::atomic<bool> stop{false};
+  std::thread owner_thread([&] {
+    owner.bind_current_thread();
+    ready.store(true);
+    while (!stop.load()) {
+      owner.drain();
+      std::this_thread::yield();
+    }
+    DeviceOwner::unbind_current_thread();
+  });
+  while (!ready.load()) {
+    std::this_thread::yield();
+  }
+#if V4STD_MAX_DEVICE_OWNERS > 0
+  REQUIRE(set_device_owner(V4DEV_LED, V4ROLE_USER, 1, &owner));
+#endif
+
+  arm();
+
+  int32_t value = 41;
+  int32_t result = owner.forward(add_one, &value, V4DEV_LED, V4ROLE_USER, 1);
+#if V4STD_MAX_DEVICE_OWNERS > 0
+  int32_t on = invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 1);
+#else
+  int32_t on = 1;
+#endif
+  uint64_t forwarded = owner.forwarded();
+
+  size_t allocations = disarm();
+
+  stop.store(true);
+  owner_thread.join();
+
+  CHECK(allocations == 0);
+  CHECK(result == 42);
+  CHECK(on == 1);
+  CHECK(forwarded == (V4STD_MAX_DEVICE_OWNERS > 0 ? 2 : 1));
+
+  clear_device_owners();
+  Ddt::set_provider(nullptr);
+  set_led_hal(nullptr);
+  reset_handlers();
+}
+
+#if V4STD_HAS_COROUTINES
+static CoroEvent g_event;
+
+static SysTask coro_wait(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                         int32_t arg2) {
+  (void)sys_id;
+  (void)arg0;
+  (void)arg1;
+  (void)arg2;
+  int32_t value = co_await g_event;
+  co_return value;
+}
+
+TEST_CASE("NoHeap: Coroutine handlers use the frame pool") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_BUTTON_WAIT, coro_wait);
+
+  arm();
+  SysTask task = invoke_sys_coro_handler(V4SYS_BUTTON_WAIT, 0, 0, 0);
+  bool suspended = task.valid() && !task.done();
+  g_event.signal(5);
+  CoroScheduler::poll(0);
+  bool done = task.done();
+  int32_t result = task.result();
+  task.reset();
+  size_t allocations = disarm();
+
+  CHECK(allocations == 0);
+  CHECK(suspended);
+  CHECK(done);
+  CHECK(result == 5);
+
+  clear_sys_coro_handlers();
+}
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file test_pool.cpp
+ * @brief Tests for the lock-free fixed-block pool allocator
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/pool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace v4std;
+
+struct TimerNode {
+  static int live;
+
+  uint32_t deadline;
+  int32_t value;
+
+  TimerNode(uint32_t d, int32_t v) : deadline(d), value(v) { ++live; }
+  ~TimerNode() { --live; }
+};
+
+int TimerNode::live = 0;
+
+// No exit-time destructor for static pools
+static_assert(std::is_trivially_destructible<StaticPool<TimerNode, 4>>::value,
+              "StaticPool must be trivially destructible");
+static_assert(std::is_trivially_destructible<InlinePool<TimerNode, 4>>::value,
+              "InlinePool must be trivially destructible");
+
+struct alignas(16) Page {
+  uint8_t bytes[48];
+};
+
+TEST_CASE("Pool: Blocks come from the caller's storage") {
+  static PoolStorage<Page, 4> storage;
+  StaticPool<Page, 4> pool{storage};
+
+  CHECK(pool.capacity() == 4);
+  CHECK(sizeof(storage) == 4 * sizeof(Page));
+
+  void *a = pool.allocate();
+  void *b = pool.allocate();
+  REQUIRE(a != nullptr);
+  REQUIRE(b != nullptr);
+  CHECK(a != b);
+  CHECK(pool.owns(a));
+  CHECK(pool.owns(b));
+  CHECK(reinterpret_cast<uintptr_t>(a) % 16 == 0);
+  CHECK(a >= static_cast<void *>(&storage));
+  CHECK(a < static_cast<void *>(&storage + 1));
+
+  int outside = 0;
+  CHECK_FALSE(pool.owns(&outside));
+
+  pool.deallocate(a);
+  pool.deallocate(b);
+  pool.flush_thread_cache();
+  CHECK(pool.in_use() == 0);
+}
+
+TEST_CASE("Pool: create and destroy run constructors") {
+  InlinePool<TimerNode, 2> pool;
+  TimerNode::live = 0;
+
+  TimerNode *node = pool.create(100u, 7);
+  REQUIRE(node != nullptr);
+  CHECK(node->deadline == 100);
+  CHECK(node->value == 7);
+  CHECK(TimerNode::live == 1);
+
+  pool.destroy(node);
+  CHECK(TimerNode::live == 0);
+  CHECK(pool.in_use() == 0);
+
+  pool.destroy(nullptr); // No-op
+  pool.flush_thread_cache();
+}
+
+TEST_CASE("Pool: Exhaustion and counters") {
+  static PoolStorage<uint64_t, 3> storage;
+  StaticPool<uint64_t, 3> pool{storage};
+
+  void *blocks[3];
+  for (auto &block : blocks) {
+    block = pool.allocate();
+    REQUIRE(block != nullptr);
+  }
+
+  CHECK(pool.in_use() == 3);
+  CHECK(pool.high_water() == 3);
+  CHECK(pool.allocate() == nullptr);
+  CHECK(pool.allocate() == nullptr);
+  CHECK(pool.exhausted_count() == 2);
+
+  pool.deallocate(blocks[1]);
+  CHECK(pool.in_use() == 2);
+  CHECK(pool.high_water() == 3);
+
+  // Freed block is reused
+  void *again = pool.allocate();
+  CHECK(again == blocks[1]);
+
+  pool.deallocate(blocks[0]);
+  pool.deallocate(again);
+  pool.deallocate(blocks[2]);
+  CHECK(pool.in_use() == 0);
+  pool.flush_thread_cache();
+}
+
+TEST_CASE("Pool: Flushed pool can be replaced at the same address") {
+  static PoolStorage<uint16_t, 2> storage;
+  alignas(StaticPool<uint16_t, 2>) unsigned char
+      place[sizeof(StaticPool<uint16_t, 2>)];
+
+  // Free both blocks into this thread's cache, flush, then drop the pool
+  auto *pool = new (place) StaticPool<uint16_t, 2>{storage};
+  void *a = pool->allocate();
+  void *b = pool->allocate();
+  pool->deallocate(a);
+  pool->deallocate(b);
+  pool->flush_thread_cache();
+  pool->~StaticPool();
+
+  // A fresh pool at the same address starts with an empty cache
+  pool = new (place) StaticPool<uint16_t, 2>{storage};
+  void *c = pool->allocate();
+  void *d = pool->allocate();
+  CHECK(c != nullptr);
+  CHECK(d != nullptr);
+  CHECK(c != d);
+  CHECK(pool->allocate() == nullptr);
+  pool->deallocate(c);
+  pool->deallocate(d);
+  pool->flush_thread_cache();
+  pool->~StaticPool();
+}
+
+TEST_CASE("Pool: Largest pool uses every index below the sentinel") {
+  static PoolStorage<uint8_t, 0xFFFF> storage;
+  StaticPool<uint8_t, 0xFFFF> pool{storage};
+
+  size_t count = 0;
+  void *last = nullptr;
+  while (void *block = pool.allocate()) {
+    last = block;
+    ++count;
+  }
+  CHECK(count == 65535);
+  CHECK(last == &storage.blocks[0xFFFE]);
+
+  // The last block round-trips through the shared free list
+  pool.deallocate(last);
+  pool.flush_thread_cache();
+  CHECK(pool.allocate() == last);
+}
+
+TEST_CASE("Pool: Flushed blocks are visible to other threads") {
+  static PoolStorage<uint32_t, 4> storage;
+  StaticPool<uint32_t, 4> pool{storage};
+
+  void *blocks[4];
+  for (auto &block : blocks) {
+    block = pool.allocate();
+  }
+  for (auto *block : blocks) {
+    pool.deallocate(block);
+  }
+  pool.flush_thread_cache();
+
+  size_t allocated = 0;
+  std::thread worker([&] {
+    void *held[4];
+    for (auto &block : held) {
+      block = pool.allocate();
+      allocated += block ? 1 : 0;
+    }
+    for (auto *block : held) {
+      pool.deallocate(block);
+    }
+  });
+  worker.join();
+
+  // Worker's cache was flushed when the thread exited
+  CHECK(allocated == 4);
+  CHECK(pool.in_use() == 0);
+  for (auto &block : blocks) {
+    block = pool.allocate();
+    CHECK(block != nullptr);
+  }
+}
+
+TEST_CASE("Pool: Concurrent allocate/deallocate never hands out a block "
+          "twice") {
+  constexpr size_t kThreads = 4;
+  constexpr size_t kBlocks = 64;
+  constexpr int kRounds = 20000;
+
+  static PoolStorage<std::atomic<uint32_t>, kBlocks> storage;
+  static StaticPool<std::atomic<uint32_t>, kBlocks> pool{storage};
+
+  std::atomic<size_t> conflicts{0};
+  std::vector<std::thread> threads;
+  for (uint32_t t = 1; t <= kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      std::atomic<uint32_t> *held[4];
+      for (int round = 0; round < kRounds; ++round) {
+        size_t n = 0;
+        for (auto &slot : held) {
+          slot = pool.create(t);
+          if (slot) {
+            ++n;
+          }
+        }
+        for (size_t i = 0; i < n; ++i) {
+          // Another owner writing the same block would change the tag
+          if (held[i]->exchange(t) != t) {
+            conflicts.fetch_add(1);
+          }
+        }
+        for (size_t i = 0; i < n; ++i) {
+          if (held[i]->load() != t) {
+            conflicts.fetch_add(1);
+          }
+          pool.destroy(held[i]);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  CHECK(conflicts.load() == 0);
+  CHECK(pool.in_use() == 0);
+  CHECK(pool.high_water() <= kThreads * 4);
+  CHECK(pool.exhausted_count() == 0);
+
+  // Every block is reachable again once all caches are flushed
+  std::atomic<uint32_t> *all[kBlocks];
+  size_t got = 0;
+  for (auto &slot : all) {
+    slot = pool.create(0u);
+    got += slot ? 1 : 0;
+  }
+  CHECK(got == kBlocks);
+}
@@ -0,0 +1,172 @@
+/**
+ * @file test_rom_dispatch.cpp
+ * @brief Tests for the ROM SYS dispatch table (V4STD_ROM_DISPATCH builds)
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/capability.hpp"
+#include "v4std/ddt.hpp"
+#include "v4std/sys_dispatch_table.h"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_led.hpp"
+#include <type_traits>
+
+using namespace v4std;
+
+static_assert(V4STD_ROM_DISPATCH, "built only with V4STD_ROM_DISPATCH");
+
+// The table is a constant: no registration needed, no RAM copy
+static_assert(std::is_const_v<decltype(kRomSysHandlers)>);
+static_assert(kRomSysHandlerCount == 10);
+static_assert(kRomSysHandlers[0].sys_id == V4SYS_LED_ON);
+static_assert(kRomSysHandlers[0].flags == V4SYS_HANDLER_DEVICE_LOCK);
+
+class MockProvider : public DdtProvider {
+public:
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
+        {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
+    };
+    return span<const DeviceDesc>{devices};
+  }
+};
+
+class MockLedHal : public LedHal {
+public:
+  bool set_led(uint32_t handle, bool state, bool active_low) override {
+    (void)active_low;
+    last_handle = handle;
+    on = state;
+    return true;
+  }
+
+  bool get_led(uint32_t handle, bool active_low) override {
+    (void)handle;
+    (void)active_low;
+    return on;
+  }
+
+  uint32_t last_handle = 0;
+  bool on = false;
+};
+
+static int32_t override_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                                int32_t arg2) {
+  (void)sys_id;
+  (void)arg1;
+  (void)arg2;
+  return arg0 + 100;
+}
+
+static MockProvider g_provider;
+static MockLedHal g_hal;
+
+TEST_CASE("ROM dispatch: Table serves without registration") {
+  clear_sys_handlers();
+  Ddt::set_provider(&g_provider);
+  set_led_hal(&g_hal);
+
+  CHECK(get_sys_handler_count() == kRomSysHandlerCount);
+  CHECK(get_sys_handler(V4SYS_LED_ON) == &sys_led_on);
+  CHECK(get_sys_handler_flags(V4SYS_LED_ON) == V4SYS_HANDLER_DEVICE_LOCK);
+  CHECK(get_sys_cell_handler(V4SYS_CAP_ENUM) == &sys_cap_enum);
+  CHECK(get_sys_handler(V4SYS_CAP_ENUM) == nullptr);
+  CHECK(get_sys_handler(V4SYS_BUTTON_READ) == nullptr);
+
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_STATUS, 0) == 1);
+  CHECK(g_hal.last_handle == 7);
+  CHECK(g_hal.on);
+
+  int32_t stack[4] = {V4DEV_LED, V4ROLE_STATUS, 0};
+  size_t depth = 3;
+  CHECK(dispatch_sys_call(V4SYS_CAP_EXISTS, stack, depth, 4) ==
+        SysCallStatus::Ok);
+  REQUIRE(depth == 1);
+  CHECK(stack[0] == 1);
+
+  Ddt::set_provider(nullptr);
+}
+
+TEST_CASE("ROM dispatch: Boot registration is a no-op") {
+  clear_sys_handlers();
+
+  register_led_sys_handlers();
+  register_cap_sys_handlers();
+  CHECK(get_sys_handler_count() == kRomSysHandlerCount);
+
+  // Fills the overlay only if something was stored
+  for (uint16_t id = 0x0B00; id < 0x0B00 + V4STD_SYS_OVERLAY_HANDLERS;
+       ++id) {
+    CHECK(register_sys_handler(id, override_handler));
+  }
+  CHECK_FALSE(register_sys_handler(0x0BFF, override_handler));
+  register_led_sys_handlers();
+  CHECK(get_sys_handler(V4SYS_LED_GET) == &sys_led_get);
+  CHECK(get_sys_handler_count() ==
+        kRomSysHandlerCount + V4STD_SYS_OVERLAY_HANDLERS);
+
+  clear_sys_handlers();
+}
+
+TEST_CASE("ROM dispatch: Overlay") {
+  clear_sys_handlers();
+
+  // Dynamic IDs
+  CHECK(register_sys_handler(V4SYS_BUTTON_READ, override_handler));
+  CHECK(invoke_sys_handler(V4SYS_BUTTON_READ, 1, 0, 0) == 101);
+  CHECK(get_sys_handler_count() == kRomSysHandlerCount + 1);
+
+  // Overrides shadow the table, and go away when re-registered as built
+  CHECK(register_sys_handler(V4SYS_CAP_COUNT, override_handler));
+  CHECK(invoke_sys_handler(V4SYS_CAP_COUNT, 2, 0, 0) == 102);
+  CHECK(get_sys_handler_count() == kRomSysHandlerCount + 1);
+  CHECK(register_sys_handler(V4SYS_CAP_COUNT, sys_cap_count));
+  CHECK(get_sys_handler(V4SYS_CAP_COUNT) == &sys_cap_count);
+
+  // Different flags are an override too
+  CHECK(register_sys_handler(V4SYS_LED_OFF, sys_led_off));
+  CHECK(get_sys_handler_flags(V4SYS_LED_OFF) == 0);
+  CHECK(register_sys_handler(V4SYS_LED_OFF, sys_led_off,
+                             V4SYS_HANDLER_DEVICE_LOCK));
+  CHECK(get_sys_handler_flags(V4SYS_LED_OFF) == V4SYS_HANDLER_DEVICE_LOCK);
+
+  // Unregistering hides a table entry until cleared
+  unregister_sys_handler(V4SYS_LED_TOGGLE);
+  CHECK(get_sys_handler(V4SYS_LED_TOGGLE) == nullptr);
+  CHECK(invoke_sys_handler(V4SYS_LED_TOGGLE, V4DEV_LED, 0, 0) == -1);
+  CHECK(get_sys_handler_count() == kRomSysHandlerCount);
+  unregister_sys_handler(V4SYS_BUTTON_READ);
+  CHECK(get_sys_handler(V4SYS_BUTTON_READ) == nullptr);
+  CHECK(get_sys_handler_count() == kRomSysHandlerCount - 1);
+
+  clear_sys_handlers();
+  CHECK(get_sys_handler(V4SYS_LED_TOGGLE) == &sys_led_toggle);
+  CHECK(get_sys_handler_count() == kRomSysHandlerCount);
+}
+
+TEST_CASE("ROM dispatch: Hiding the table takes no overlay entries") {
+  clear_sys_handlers();
+
+  for (const SysHandlerEntry &entry : kRomSysHandlers) {
+    unregister_sys_handler(entry.sys_id);
+  }
+  CHECK(get_sys_handler_count() == 0);
+  CHECK(get_sys_handler(V4SYS_CAP_COUNT) == nullptr);
+
+  for (uint16_t id = 0x0B00; id < 0x0B00 + V4STD_SYS_OVERLAY_HANDLERS;
+       ++id) {
+    CHECK(register_sys_handler(id, override_handler));
+  }
+  CHECK(get_sys_handler_count() == V4STD_SYS_OVERLAY_HANDLERS);
+
+  // Registering as built shows the entry again
+  register_cap_sys_handlers();
+  CHECK(get_sys_handler(V4SYS_CAP_COUNT) == &sys_cap_count);
+  CHECK(get_sys_handler(V4SYS_LED_ON) == nullptr);
+
+  clear_sys_handlers();
+  CHECK(get_sys_handler_count() == kRomSysHandlerCount);
+}
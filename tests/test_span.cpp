@@ -0,0 +1,193 @@
+/**
+ * @file test_span.cpp
+ * @brief Tests for the C++17 span implementation
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt_types.h"
+#include "v4std/span.hpp"
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+using namespace v4std;
+
+// Static extent holds only a pointer
+static_assert(sizeof(span<int, 4>) == sizeof(int *),
+              "static-extent span must be pointer-sized");
+static_assert(sizeof(span<int>) == sizeof(int *) + sizeof(size_t),
+              "dynamic span holds pointer and size");
+static_assert(span<int, 4>::extent == 4, "static extent");
+static_assert(span<int>::extent == dynamic_extent, "dynamic extent");
+
+// (pointer, count) is explicit for a static extent, as in std::span
+template <typename S> void take_span(S);
+template <typename S, typename = void>
+struct implicit_from_pointer : std::false_type {};
+template <typename S>
+struct implicit_from_pointer<
+    S, std::void_t<decltype(take_span<S>({static_cast<int *>(nullptr),
+                                          size_t{0}}))>> : std::true_type {};
+
+static_assert(implicit_from_pointer<span<int>>::value,
+              "dynamic span converts from {pointer, count}");
+static_assert(!implicit_from_pointer<span<int, 4>>::value,
+              "static span needs explicit construction");
+static_assert(std::is_constructible<span<int, 4>, int *, size_t>::value,
+              "static span is explicitly constructible");
+
+// Minimal contiguous container (data()/size() only)
+struct FrameBuffer {
+  uint8_t pixels[16] = {};
+  uint8_t *data() { return pixels; }
+  const uint8_t *data() const { return pixels; }
+  size_t size() const { return sizeof(pixels); }
+};
+
+TEST_CASE("span: Default and pointer construction") {
+  span<int> empty;
+  CHECK(empty.empty());
+  CHECK(empty.size() == 0);
+  CHECK(empty.data() == nullptr);
+
+  int values[] = {1, 2, 3};
+  span<int> s{values, 3};
+  CHECK(s.size() == 3);
+  CHECK(s.front() == 1);
+  CHECK(s.back() == 3);
+}
+
+TEST_CASE("span: C-array construction and deduction") {
+  int values[] = {1, 2, 3, 4};
+
+  span s{values};
+  static_assert(decltype(s)::extent == 4, "deduced static extent");
+  CHECK(s.size() == 4);
+
+  span<const int> c{values}; // Qualification conversion
+  CHECK(c.size() == 4);
+  CHECK(c[2] == 3);
+}
+
+TEST_CASE("span: std::array construction") {
+  std::array<uint8_t, 8> page{};
+  page[7] = 0xAA;
+
+  span s{page};
+  static_assert(decltype(s)::extent == 8, "deduced from std::array");
+  CHECK(s[7] == 0xAA);
+
+  const std::array<uint8_t, 8> &cpage = page;
+  span cs{cpage};
+  static_assert(std::is_same<decltype(cs)::element_type, const uint8_t>::value,
+                "const std::array yields span<const T>");
+  CHECK(cs.size() == 8);
+
+  span<uint8_t> dyn{page};
+  CHECK(dyn.size() == 8);
+}
+
+TEST_CASE("span: Container construction") {
+  std::vector<int> vec{5, 6, 7};
+  span<int> s{vec};
+  CHECK(s.size() == 3);
+  CHECK(s[1] == 6);
+
+  const std::vector<int> &cvec = vec;
+  span<const int> cs{cvec};
+  CHECK(cs.size() == 3);
+
+  FrameBuffer fb;
+  span<uint8_t> pixels{fb};
+  CHECK(pixels.size() == 16);
+  pixels[0] = 9;
+  CHECK(fb.pixels[0] == 9);
+}
+
+TEST_CASE("span: Static to dynamic conversion") {
+  int values[] = {1, 2, 3, 4};
+  span<int, 4> fixed{values};
+  span<const int> dyn = fixed;
+  CHECK(dyn.size() == 4);
+  CHECK(dyn.data() == values);
+}
+
+TEST_CASE("span: first/last with compile-time counts") {
+  int values[] = {0, 1, 2, 3, 4, 5};
+  span<int, 6> s{values};
+
+  auto head = s.first<2>();
+  static_assert(decltype(head)::extent == 2, "first<2> extent");
+  CHECK(head[0] == 0);
+  CHECK(head[1] == 1);
+
+  auto tail = s.last<3>();
+  static_assert(decltype(tail)::extent == 3, "last<3> extent");
+  CHECK(tail[0] == 3);
+  CHECK(tail[2] == 5);
+}
+
+TEST_CASE("span: subspan with compile-time offset") {
+  int values[] = {0, 1, 2, 3, 4, 5};
+  span<int, 6> s{values};
+
+  auto mid = s.subspan<1, 3>();
+  static_assert(decltype(mid)::extent == 3, "subspan<1, 3> extent");
+  CHECK(mid[0] == 1);
+  CHECK(mid[2] == 3);
+
+  auto rest = s.subspan<4>();
+  static_assert(decltype(rest)::extent == 2, "subspan<4> extent");
+  CHECK(rest[0] == 4);
+
+  span<int> dyn{values, 6};
+  auto drest = dyn.subspan<4>();
+  static_assert(decltype(drest)::extent == dynamic_extent, "dynamic rest");
+  CHECK(drest.size() == 2);
+}
+
+TEST_CASE("span: Runtime first/last/subspan") {
+  int values[] = {0, 1, 2, 3, 4, 5};
+  span<int> s{values, 6};
+
+  CHECK(s.first(2).size() == 2);
+  CHECK(s.last(2)[0] == 4);
+  CHECK(s.subspan(2, 3)[0] == 2);
+  CHECK(s.subspan(2, 3).size() == 3);
+  CHECK(s.subspan(5).size() == 1);
+  CHECK(s.subspan(6).empty());
+}
+
+TEST_CASE("span: as_bytes and as_writable_bytes") {
+  v4dev_desc_t descs[2] = {
+      {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
+      {V4DEV_BUTTON, V4ROLE_USER, 0, 0, 9},
+  };
+
+  span<const v4dev_desc_t, 2> s{descs};
+  auto bytes = as_bytes(s);
+  static_assert(decltype(bytes)::extent == 16, "2 x 8-byte descriptors");
+  CHECK(bytes.size() == 16);
+  CHECK(bytes[0] == std::byte{V4DEV_LED});
+  CHECK(bytes[8] == std::byte{V4DEV_BUTTON});
+
+  span<v4dev_desc_t> dyn{descs, 2};
+  auto wbytes = as_writable_bytes(dyn);
+  static_assert(decltype(wbytes)::extent == dynamic_extent, "dynamic bytes");
+  wbytes[1] = std::byte{V4ROLE_DEBUG};
+  CHECK(descs[0].role == V4ROLE_DEBUG);
+}
+
+TEST_CASE("span: Range-based for") {
+  const int values[] = {1, 2, 3};
+  span<const int> s{values};
+
+  int sum = 0;
+  for (int v : s) {
+    sum += v;
+  }
+  CHECK(sum == 6);
+}
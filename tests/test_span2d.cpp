@@ -0,0 +1,192 @@
+/**
+ * @file test_span2d.cpp
+ * @brief Tests for the strided 2D view and its kernels
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/span2d.hpp"
+#include <cstdint>
+
+using namespace v4std;
+
+// 4 x 6 buffer filled with r * 10 + c
+static void init_grid(uint8_t (&grid)[4][6]) {
+  for (int r = 0; r < 4; ++r) {
+    for (int c = 0; c < 6; ++c) {
+      grid[r][c] = static_cast<uint8_t>(r * 10 + c);
+    }
+  }
+}
+
+TEST_CASE("span2d: Extents and element access") {
+  uint8_t grid[4][6];
+  init_grid(grid);
+  span2d<uint8_t> view{&grid[0][0], 4, 6};
+
+  CHECK(view.rows() == 4);
+  CHECK(view.cols() == 6);
+  CHECK(view.stride() == 6);
+  CHECK(view.size() == 24);
+  CHECK(view.contiguous());
+  CHECK(view(2, 3) == 23);
+
+  span2d<uint8_t> empty;
+  CHECK(empty.empty());
+}
+
+TEST_CASE("span2d: Row access and iteration") {
+  uint8_t grid[4][6];
+  init_grid(grid);
+  span2d<uint8_t> view{&grid[0][0], 4, 6};
+
+  span<uint8_t> row2 = view.row(2);
+  CHECK(row2.size() == 6);
+  CHECK(row2[0] == 20);
+  CHECK(row2[5] == 25);
+
+  int rows = 0;
+  for (span<uint8_t> r : view) {
+    CHECK(r[0] == rows * 10);
+    ++rows;
+  }
+  CHECK(rows == 4);
+}
+
+TEST_CASE("span2d: Subviews share storage") {
+  uint8_t grid[4][6];
+  init_grid(grid);
+  span2d<uint8_t> view{&grid[0][0], 4, 6};
+
+  auto window = view.subview(1, 2, 2, 3);
+  CHECK(window.rows() == 2);
+  CHECK(window.cols() == 3);
+  CHECK(window.stride() == 6);
+  CHECK_FALSE(window.contiguous());
+  CHECK(window(0, 0) == 12);
+  CHECK(window(1, 2) == 24);
+
+  window(0, 0) = 99;
+  CHECK(grid[1][2] == 99);
+
+  auto col = view.column(4);
+  CHECK(col.rows() == 4);
+  CHECK(col.cols() == 1);
+  CHECK(col(3, 0) == 34);
+
+  auto band = view.row_range(1, 2);
+  CHECK(band.contiguous());
+  CHECK(band.flat().size() == 12);
+  CHECK(band.flat()[6] == 20);
+
+  auto cols = view.col_range(1, 2);
+  CHECK(cols(3, 1) == 32);
+
+  // Iterating a window that reaches the last row stays inside the buffer
+  int rows = 0;
+  for (span<uint8_t> r : view.col_range(4, 2)) {
+    CHECK(r[1] == rows * 10 + 5);
+    ++rows;
+  }
+  CHECK(rows == 4);
+}
+
+TEST_CASE("span2d: Const conversion") {
+  uint8_t grid[4][6];
+  init_grid(grid);
+  span2d<uint8_t> view{&grid[0][0], 4, 6};
+
+  span2d<const uint8_t> cview = view;
+  CHECK(cview(3, 5) == 35);
+}
+
+TEST_CASE("span2d: fill on a strided window") {
+  uint8_t grid[4][6];
+  init_grid(grid);
+  span2d<uint8_t> view{&grid[0][0], 4, 6};
+
+  fill(view.subview(1, 1, 2, 2), uint8_t{0});
+
+  CHECK(grid[1][1] == 0);
+  CHECK(grid[2][2] == 0);
+  CHECK(grid[1][0] == 10); // Outside the window
+  CHECK(grid[1][3] == 13);
+  CHECK(grid[3][1] == 31);
+
+  fill(view, uint8_t{7});
+  CHECK(grid[0][0] == 7);
+  CHECK(grid[3][5] == 7);
+}
+
+TEST_CASE("span2d: blit between buffers") {
+  uint16_t sprite[2][3] = {{1, 2, 3}, {4, 5, 6}};
+  uint16_t screen[4][8] = {};
+
+  span2d<uint16_t> dst{&screen[0][0], 4, 8};
+  span2d<const uint16_t> src{&sprite[0][0], 2, 3};
+
+  blit(dst.subview(1, 4, 2, 3), src);
+
+  CHECK(screen[1][4] == 1);
+  CHECK(screen[1][6] == 3);
+  CHECK(screen[2][4] == 4);
+  CHECK(screen[2][6] == 6);
+  CHECK(screen[0][4] == 0);
+  CHECK(screen[1][7] == 0);
+}
+
+TEST_CASE("span2d: blit clips to the smaller view") {
+  uint8_t src_buf[3][3] = {{1, 1, 1}, {1, 1, 1}, {1, 1, 1}};
+  uint8_t dst_buf[2][2] = {};
+
+  blit(span2d<uint8_t>{&dst_buf[0][0], 2, 2},
+       span2d<uint8_t>{&src_buf[0][0], 3, 3});
+
+  CHECK(dst_buf[0][0] == 1);
+  CHECK(dst_buf[1][1] == 1);
+}
+
+TEST_CASE("span2d: scroll_up and scroll_down") {
+  uint8_t grid[4][6];
+  init_grid(grid);
+  span2d<uint8_t> view{&grid[0][0], 4, 6};
+
+  SUBCASE("scroll_up") {
+    scroll_up(view, 1, uint8_t{0xFF});
+    CHECK(grid[0][0] == 10);
+    CHECK(grid[2][5] == 35);
+    CHECK(grid[3][0] == 0xFF);
+    CHECK(grid[3][5] == 0xFF);
+  }
+
+  SUBCASE("scroll_down") {
+    scroll_down(view, 2, uint8_t{0});
+    CHECK(grid[0][0] == 0);
+    CHECK(grid[1][5] == 0);
+    CHECK(grid[2][0] == 0);
+    CHECK(grid[2][1] == 1);
+    CHECK(grid[3][3] == 13);
+  }
+
+  SUBCASE("scroll a window only") {
+    scroll_up(view.subview(0, 2, 4, 2), 1, uint8_t{0});
+    CHECK(grid[0][2] == 12);
+    CHECK(grid[0][1] == 1); // Outside the window
+    CHECK(grid[3][3] == 0);
+  }
+
+  SUBCASE("scroll by zero rows is a no-op") {
+    scroll_up(view, 0, uint8_t{0xFF});
+    scroll_down(view, 0, uint8_t{0xFF});
+    CHECK(grid[0][0] == 0);
+    CHECK(grid[2][4] == 24);
+    CHECK(grid[3][5] == 35);
+  }
+
+  SUBCASE("scroll past the end clears") {
+    scroll_up(view, 10, uint8_t{0});
+    CHECK(grid[0][0] == 0);
+    CHECK(grid[3][5] == 0);
+  }
+}
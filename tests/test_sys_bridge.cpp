@@ -0,0 +1,163 @@
+/**
+ * @file test_sys_bridge.cpp
+ * @brief Tests for the shared-memory SYS call bridge
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/linux/sys_bridge.hpp"
+#include "v4std/sys_handlers.hpp"
+#include <chrono>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace v4std;
+
+static constexpr uint16_t kSumId = 0x7F00;
+static constexpr uint16_t kCountId = 0x7F01;
+
+static int32_t sum_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                           int32_t arg2) {
+  (void)sys_id;
+  return arg0 + arg1 + arg2;
+}
+
+// State that only exists in the serving process
+static int32_t g_count = 0;
+static int32_t count_handler(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                             int32_t arg2) {
+  (void)sys_id;
+  (void)arg1;
+  (void)arg2;
+  g_count += arg0;
+  return g_count;
+}
+
+static void register_bridge_handlers() {
+  clear_sys_handlers();
+  g_count = 0;
+  register_sys_handler(kSumId, sum_handler);
+  register_sys_handler(kCountId, count_handler);
+}
+
+TEST_CASE("SysBridge: Create and attach") {
+  SysBridge bridge;
+  CHECK_FALSE(bridge.is_open());
+  CHECK(bridge.fd() == -1);
+
+  REQUIRE(bridge.create());
+  CHECK(bridge.is_open());
+  CHECK(bridge.fd() >= 0);
+  CHECK_FALSE(bridge.is_shutdown());
+
+  SysBridge peer;
+  CHECK(peer.attach(dup(bridge.fd())));
+  CHECK(peer.is_open());
+
+  CHECK_FALSE(peer.attach(-1));
+  CHECK_FALSE(peer.is_open());
+
+  // Unsealed or wrongly sized regions are rejected
+  int other = memfd_create("not-a-bridge", MFD_CLOEXEC);
+  REQUIRE(other >= 0);
+  CHECK(ftruncate(other, 4096) == 0);
+  CHECK_FALSE(peer.attach(other));
+
+  bridge.shutdown();
+  CHECK(bridge.is_shutdown());
+
+  int32_t result = 0;
+  CHECK_FALSE(bridge.call(kSumId, 1, 2, 3, result));
+
+  bridge.close();
+  CHECK_FALSE(bridge.is_open());
+  CHECK_FALSE(bridge.call(kSumId, 1, 2, 3, result));
+}
+
+TEST_CASE("SysBridge: Calls are served by another process") {
+  SysBridge bridge;
+  REQUIRE(bridge.create());
+
+  pid_t pid = fork();
+  REQUIRE(pid >= 0);
+  if (pid == 0) {
+    // HAL process
+    register_bridge_handlers();
+    bridge.run();
+    _exit(bridge.corrupt() ? 1 : 0);
+  }
+
+  // VM process has no handlers of its own
+  clear_sys_handlers();
+  g_count = 0;
+
+  int32_t result = 0;
+  CHECK(bridge.call(kSumId, 1, 2, 3, result));
+  CHECK(result == 6);
+  CHECK(bridge.call(kCountId, 5, 0, 0, result));
+  CHECK(result == 5);
+  CHECK(bridge.call(kCountId, 2, 0, 0, result));
+  CHECK(result == 7);
+  CHECK(g_count == 0); // State lives in the HAL process
+
+  // Unknown IDs behave as invoke_sys_handler() does
+  CHECK(bridge.call(0x7F7F, 1, 2, 3, result));
+  CHECK(result == invoke_sys_handler(0x7F7F, 1, 2, 3));
+
+  // Batches larger than a ring are split
+  constexpr size_t kCalls = SysBridge::kRingSize * 3 + 17;
+  std::vector<SysBridgeCall> calls(kCalls);
+  std::vector<int32_t> results(kCalls, -1);
+  for (size_t i = 0; i < kCalls; ++i) {
+    int32_t n = static_cast<int32_t>(i);
+    calls[i] = {kSumId, {n, n, 1}};
+  }
+  CHECK(bridge.call_batch(calls.data(), results.data(), kCalls) == kCalls);
+  bool all_correct = true;
+  for (size_t i = 0; i < kCalls; ++i) {
+    all_correct =
+        all_correct && results[i] == static_cast<int32_t>(2 * i + 1);
+  }
+  CHECK(all_correct);
+  CHECK_FALSE(bridge.corrupt());
+
+  bridge.shutdown();
+  int status = 0;
+  REQUIRE(waitpid(pid, &status, 0) == pid);
+  CHECK(WIFEXITED(status));
+  CHECK(WEXITSTATUS(status) == 0);
+
+  CHECK_FALSE(bridge.call(kSumId, 1, 2, 3, result));
+}
+
+TEST_CASE("SysBridge: Idle server parks and is woken") {
+  register_bridge_handlers();
+
+  SysBridge client;
+  REQUIRE(client.create());
+  SysBridge server;
+  REQUIRE(server.attach(dup(client.fd())));
+
+  std::thread hal([&server] { server.run(); });
+
+  // Long enough for the server to exhaust its spin budget and park
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  int32_t result = 0;
+  CHECK(client.call(kSumId, 10, 20, 30, result));
+  CHECK(result == 60);
+
+  // Shutdown wakes the parked server
+  client.shutdown();
+  hal.join();
+  CHECK(server.futex_waits() >= 1);
+  CHECK(server.spin_budget() >= 16);
+  CHECK(server.is_shutdown());
+  CHECK_FALSE(server.corrupt());
+
+  clear_sys_handlers();
+}
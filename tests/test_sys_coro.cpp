@@ -0,0 +1,214 @@
+/**
+ * @file test_sys_coro.cpp
+ * @brief Tests for coroutine SYS handlers (C++20)
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/sys_coro.hpp"
+#include "v4std/sys_ids.h"
+
+using namespace v4std;
+
+// Simulated button edge source
+static CoroEvent g_button_event;
+
+// Handler that completes without suspending
+static SysTask coro_immediate(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                              int32_t arg2) {
+  (void)sys_id;
+  (void)arg1;
+  (void)arg2;
+  co_return arg0 + 1;
+}
+
+// BUTTON_WAIT-style handler: block until the button event fires
+static SysTask coro_button_wait(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                                int32_t arg2) {
+  (void)sys_id;
+  (void)arg0;
+  (void)arg1;
+  (void)arg2;
+  int32_t state = co_await g_button_event;
+  co_return state;
+}
+
+// Handler that sleeps for arg0 milliseconds
+static SysTask coro_sleep(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                          int32_t arg2) {
+  (void)sys_id;
+  (void)arg1;
+  (void)arg2;
+  bool slept = co_await sleep_ms(static_cast<uint32_t>(arg0));
+  if (!slept) {
+    co_return -1;
+  }
+  co_return 7;
+}
+
+TEST_CASE("SYS Coro: Unregistered handler yields invalid task") {
+  clear_sys_coro_handlers();
+
+  SysTask task = invoke_sys_coro_handler(V4SYS_BUTTON_WAIT, 0, 0, 0);
+  CHECK_FALSE(task.valid());
+  CHECK(task.result() == -1);
+}
+
+TEST_CASE("SYS Coro: Register and look up handler") {
+  clear_sys_coro_handlers();
+
+  CHECK(register_sys_coro_handler(V4SYS_BUTTON_WAIT, coro_button_wait));
+  CHECK_FALSE(register_sys_coro_handler(V4SYS_UART_READ, nullptr));
+  CHECK(get_sys_coro_handler(V4SYS_BUTTON_WAIT) == coro_button_wait);
+  CHECK(get_sys_coro_handler(V4SYS_UART_READ) == nullptr);
+
+  unregister_sys_coro_handler(V4SYS_BUTTON_WAIT);
+  CHECK(get_sys_coro_handler(V4SYS_BUTTON_WAIT) == nullptr);
+}
+
+TEST_CASE("SYS Coro: Non-blocking handler completes immediately") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_UART_READ, coro_immediate);
+
+  SysTask task = invoke_sys_coro_handler(V4SYS_UART_READ, 41, 0, 0);
+  REQUIRE(task.valid());
+  CHECK(task.done());
+  CHECK(task.result() == 42);
+}
+
+TEST_CASE("SYS Coro: Handler resumes on device event") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_BUTTON_WAIT, coro_button_wait);
+
+  SysTask task = invoke_sys_coro_handler(V4SYS_BUTTON_WAIT, V4SYS_BUTTON_WAIT,
+                                         0, 0);
+  REQUIRE(task.valid());
+  CHECK_FALSE(task.done());
+  CHECK(CoroScheduler::pending() == 1);
+
+  // Nothing signaled yet
+  CHECK(CoroScheduler::poll(0) == 0);
+  CHECK_FALSE(task.done());
+
+  // Signal queues the handler; the scheduler resumes it
+  g_button_event.signal(1);
+  CHECK_FALSE(task.done());
+  CHECK(CoroScheduler::poll(0) == 1);
+  CHECK(task.done());
+  CHECK(task.result() == 1);
+  CHECK(CoroScheduler::pending() == 0);
+}
+
+TEST_CASE("SYS Coro: Latched event is consumed without suspending") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_BUTTON_WAIT, coro_button_wait);
+
+  g_button_event.signal(0);
+  CHECK(g_button_event.pending());
+
+  SysTask task = invoke_sys_coro_handler(V4SYS_BUTTON_WAIT, 0, 0, 0);
+  CHECK(task.done());
+  CHECK(task.result() == 0);
+  CHECK_FALSE(g_button_event.pending());
+}
+
+TEST_CASE("SYS Coro: Timer wait") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_TIMER_ONESHOT, coro_sleep);
+
+  CoroScheduler::poll(1000);
+  SysTask task = invoke_sys_coro_handler(V4SYS_TIMER_ONESHOT, 10, 0, 0);
+  CHECK_FALSE(task.done());
+
+  CoroScheduler::poll(1005);
+  CHECK_FALSE(task.done());
+
+  CoroScheduler::poll(1010);
+  CHECK(task.done());
+  CHECK(task.result() == 7);
+}
+
+TEST_CASE("SYS Coro: Timer wait across clock wraparound") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_TIMER_ONESHOT, coro_sleep);
+
+  CoroScheduler::poll(0xFFFFFFF0u);
+  SysTask task = invoke_sys_coro_handler(V4SYS_TIMER_ONESHOT, 0x20, 0, 0);
+  CHECK_FALSE(task.done());
+
+  CoroScheduler::poll(0x00000008u);
+  CHECK_FALSE(task.done());
+
+  CoroScheduler::poll(0x00000010u);
+  CHECK(task.done());
+}
+
+TEST_CASE("SYS Coro: Frame pool exhaustion") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_TIMER_ONESHOT, coro_sleep);
+  CoroScheduler::poll(0);
+
+  REQUIRE(CoroFramePool::in_use() == 0);
+
+  SysTask tasks[CoroFramePool::capacity()];
+  for (auto &task : tasks) {
+    task = invoke_sys_coro_handler(V4SYS_TIMER_ONESHOT, 100, 0, 0);
+    REQUIRE(task.valid());
+  }
+  CHECK(CoroFramePool::in_use() == CoroFramePool::capacity());
+
+  // Pool is full: no frame, no heap fallback
+  SysTask overflow = invoke_sys_coro_handler(V4SYS_TIMER_ONESHOT, 100, 0, 0);
+  CHECK_FALSE(overflow.valid());
+
+  // Releasing one frame makes room again
+  tasks[0].reset();
+  CHECK(CoroFramePool::in_use() == CoroFramePool::capacity() - 1);
+  SysTask again = invoke_sys_coro_handler(V4SYS_TIMER_ONESHOT, 100, 0, 0);
+  CHECK(again.valid());
+}
+
+TEST_CASE("SYS Coro: Sleep reports when no wait slot is free") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_TIMER_ONESHOT, coro_sleep);
+  CoroScheduler::poll(0);
+
+  SysTask tasks[CoroFramePool::capacity()];
+  for (auto &task : tasks) {
+    task = invoke_sys_coro_handler(V4SYS_TIMER_ONESHOT, 100, 0, 0);
+    REQUIRE(task.valid());
+  }
+  CHECK(CoroScheduler::pending() == CoroFramePool::capacity());
+
+  // A coroutine outside the frame pool finds every slot taken
+  SleepAwaiter sleep = sleep_ms(10);
+  CHECK_FALSE(sleep.await_suspend(std::noop_coroutine()));
+  CHECK_FALSE(sleep.await_resume());
+
+  CoroScheduler::poll(100);
+  for (auto &task : tasks) {
+    CHECK(task.done());
+    CHECK(task.result() == 7);
+  }
+  CHECK(sleep_ms(0).await_resume());
+}
+
+TEST_CASE("SYS Coro: Destroying a suspended task cancels its wait") {
+  clear_sys_coro_handlers();
+  register_sys_coro_handler(V4SYS_BUTTON_WAIT, coro_button_wait);
+
+  {
+    SysTask task = invoke_sys_coro_handler(V4SYS_BUTTON_WAIT, 0, 0, 0);
+    REQUIRE(task.valid());
+    CHECK(CoroScheduler::pending() == 1);
+  }
+
+  CHECK(CoroScheduler::pending() == 0);
+  CHECK(CoroFramePool::in_use() == 0);
+
+  // The event no longer has a waiter, so the signal is latched
+  g_button_event.signal(1);
+  CHECK(g_button_event.pending());
+  CHECK(CoroScheduler::poll(0) == 0);
+}
@@ -9,8 +9,30 @@
 #include "v4std/sys_handlers.hpp"
 #include "v4std/sys_ids.h"
 
+#if V4STD_ROM_DISPATCH
+#include "v4std/sys_dispatch_table.h"
+#endif
+
 using namespace v4std;
 
+#if V4STD_ROM_DISPATCH
+// clear_sys_handlers() leaves the ROM table in place
+static constexpr size_t kBaseHandlers = kRomSysHandlerCount;
+#else
+static constexpr size_t kBaseHandlers = 0;
+#endif
+
+// Empty registry. ROM dispatch builds also hide every ROM table entry.
+static void reset_handlers() {
+  clear_sys_handlers();
+#if V4STD_ROM_DISPATCH
+  for (const SysHandlerEntry &entry : kRomSysHandlers) {
+    unregister_sys_handler(entry.sys_id);
+  }
+#endif
+  REQUIRE(get_sys_handler_count() == 0);
+}
+
 // Mock handlers for testing
 
 static int32_t mock_led_on(uint16_t sys_id, int32_t arg0, int32_t arg1,
@@ -50,14 +72,14 @@ static int32_t mock_echo_args(uint16_t sys_id, int32_t arg0, int32_t arg1,
 }
 
 TEST_CASE("SYS Handlers: Initial state - no handlers") {
-  clear_sys_handlers();
+  reset_handlers();
 
   CHECK(get_sys_handler_count() == 0);
   CHECK(get_sys_handler(V4SYS_LED_ON) == nullptr);
 }
 
 TEST_CASE("SYS Handlers: Register single handler") {
-  clear_sys_handlers();
+  reset_handlers();
 
   bool result = register_sys_handler(V4SYS_LED_ON, mock_led_on);
   CHECK(result == true);
@@ -69,7 +91,7 @@ TEST_CASE("SYS Handlers: Register single handler") {
 }
 
 TEST_CASE("SYS Handlers: Invoke registered handler") {
-  clear_sys_handlers();
+  reset_handlers();
   register_sys_handler(V4SYS_LED_ON, mock_led_on);
 
   int32_t result = invoke_sys_handler(V4SYS_LED_ON, 0, 0, 0);
@@ -77,7 +99,7 @@ TEST_CASE("SYS Handlers: Invoke registered handler") {
 }
 
 TEST_CASE("SYS Handlers: Register multiple handlers") {
-  clear_sys_handlers();
+  reset_handlers();
 
   register_sys_handler(V4SYS_LED_ON, mock_led_on);
   register_sys_handler(V4SYS_LED_OFF, mock_led_off);
@@ -90,7 +112,7 @@ TEST_CASE("SYS Handlers: Register multiple handlers") {
 }
 
 TEST_CASE("SYS Handlers: Invoke different handlers") {
-  clear_sys_handlers();
+  reset_handlers();
 
   register_sys_handler(V4SYS_LED_ON, mock_led_on);
   register_sys_handler(V4SYS_LED_OFF, mock_led_off);
@@ -106,14 +128,14 @@ TEST_CASE("SYS Handlers: Invoke different handlers") {
 }
 
 TEST_CASE("SYS Handlers: Invoke unregistered handler") {
-  clear_sys_handlers();
+  reset_handlers();
 
   int32_t result = invoke_sys_handler(V4SYS_TIMER_START, 0, 0, 0);
   CHECK(result == -1); // Error: no handler
 }
 
 TEST_CASE("SYS Handlers: Replace existing handler") {
-  clear_sys_handlers();
+  reset_handlers();
 
   register_sys_handler(V4SYS_LED_ON, mock_led_on);
   size_t count_before = get_sys_handler_count();
@@ -129,7 +151,7 @@ TEST_CASE("SYS Handlers: Replace existing handler") {
 }
 
 TEST_CASE("SYS Handlers: Unregister handler") {
-  clear_sys_handlers();
+  reset_handlers();
 
   register_sys_handler(V4SYS_LED_ON, mock_led_on);
   register_sys_handler(V4SYS_LED_OFF, mock_led_off);
@@ -145,7 +167,7 @@ TEST_CASE("SYS Handlers: Unregister handler") {
 }
 
 TEST_CASE("SYS Handlers: Unregister non-existent handler (no-op)") {
-  clear_sys_handlers();
+  reset_handlers();
 
   register_sys_handler(V4SYS_LED_ON, mock_led_on);
   size_t count_before = get_sys_handler_count();
@@ -155,7 +177,7 @@ TEST_CASE("SYS Handlers: Unregister non-existent handler (no-op)") {
 }
 
 TEST_CASE("SYS Handlers: Register null handler fails") {
-  clear_sys_handlers();
+  reset_handlers();
 
   bool result = register_sys_handler(V4SYS_TIMER_START, nullptr);
   CHECK(result == false);
@@ -163,7 +185,7 @@ TEST_CASE("SYS Handlers: Register null handler fails") {
 }
 
 TEST_CASE("SYS Handlers: Handler argument passing") {
-  clear_sys_handlers();
+  reset_handlers();
 
   register_sys_handler(V4SYS_CAP_COUNT, mock_echo_args);
 
@@ -172,7 +194,7 @@ TEST_CASE("SYS Handlers: Handler argument passing") {
 }
 
 TEST_CASE("SYS Handlers: Clear all handlers") {
-  clear_sys_handlers();
+  reset_handlers();
 
   register_sys_handler(V4SYS_LED_ON, mock_led_on);
   register_sys_handler(V4SYS_LED_OFF, mock_led_off);
@@ -180,13 +202,13 @@ TEST_CASE("SYS Handlers: Clear all handlers") {
 
   clear_sys_handlers();
 
-  CHECK(get_sys_handler_count() == 0);
-  CHECK(get_sys_handler(V4SYS_LED_OFF) == nullptr);
+  CHECK(get_sys_handler_count() == kBaseHandlers);
+  CHECK(get_sys_handler(V4SYS_LED_OFF) != mock_led_off);
   CHECK(get_sys_handler(V4SYS_BUTTON_READ) == nullptr);
 }
 
 TEST_CASE("SYS Handlers: Register many handlers") {
-  clear_sys_handlers();
+  reset_handlers();
 
   register_sys_handler(V4SYS_LED_ON, mock_led_on);
   register_sys_handler(V4SYS_LED_OFF, mock_led_off);
@@ -207,3 +229,166 @@ TEST_CASE("SYS Handlers: Register many handlers") {
   CHECK(get_sys_handler(V4SYS_UART_READ) != nullptr);
   CHECK(get_sys_handler(V4SYS_CAP_COUNT) != nullptr);
 }
+
+// Records its inputs; results are the last input, plus 1 for each further
+// result cell
+static int32_t cells_seen[kSysMaxCells];
+
+static void mock_cells(uint16_t sys_id, const int32_t *in, size_t in_count,
+                       int32_t *out, size_t out_count) {
+  (void)sys_id;
+  for (size_t i = 0; i < in_count; ++i) {
+    cells_seen[i] = in[i];
+  }
+  for (size_t i = 0; i < out_count; ++i) {
+    out[i] = in[in_count - 1] + static_cast<int32_t>(i);
+  }
+}
+
+TEST_CASE("SYS Dispatch: Pops inputs and pushes result") {
+  reset_handlers();
+  register_sys_handler(V4SYS_LED_ON, mock_echo_args);
+
+  // ( kind role index -- success )
+  int32_t stack[8] = {99, 5, 6, 7};
+  size_t depth = 4;
+
+  CHECK(dispatch_sys_call(V4SYS_LED_ON, stack, depth, 8) == SysCallStatus::Ok);
+  CHECK(depth == 2);
+  CHECK(stack[0] == 99); // Untouched cell below the arguments
+  CHECK(stack[1] == 5);  // mock_echo_args returns arg0 (deepest input)
+}
+
+TEST_CASE("SYS Dispatch: Stack-cell handlers get every input and result") {
+  reset_handlers();
+  REQUIRE(register_sys_cell_handler(V4SYS_I2C_READ_REG, mock_cells));
+  REQUIRE(register_sys_cell_handler(V4SYS_DISPLAY_PUTC, mock_cells));
+
+  // ( kind role index addr reg -- value success ), full-width cells
+  int32_t stack[8] = {99, 1, 2, 0x12345678, -5, 70000};
+  size_t depth = 6;
+  CHECK(dispatch_sys_call(V4SYS_I2C_READ_REG, stack, depth, 8) ==
+        SysCallStatus::Ok);
+  CHECK(depth == 3);
+  CHECK(stack[0] == 99);
+  CHECK(stack[1] == 70000);
+  CHECK(stack[2] == 70001);
+  CHECK(cells_seen[2] == 0x12345678);
+  CHECK(cells_seen[3] == -5);
+
+  // Six inputs, one result
+  int32_t wide[8] = {1, 2, 3, 4, 5, 6};
+  depth = 6;
+  CHECK(dispatch_sys_call(V4SYS_DISPLAY_PUTC, wide, depth, 8) ==
+        SysCallStatus::Ok);
+  CHECK(depth == 1);
+  CHECK(wide[0] == 6);
+  CHECK(cells_seen[0] == 1);
+}
+
+TEST_CASE("SYS Handlers: Stack-cell handler registration and invoke") {
+  reset_handlers();
+
+  CHECK_FALSE(register_sys_cell_handler(V4SYS_LED_SET, nullptr));
+  CHECK_FALSE(register_sys_cell_handler(0x01FF, mock_cells)); // Undefined
+  REQUIRE(register_sys_cell_handler(V4SYS_LED_SET, mock_cells));
+  REQUIRE(register_sys_cell_handler(V4SYS_CAP_FLAGS, mock_cells));
+  REQUIRE(register_sys_cell_handler(V4SYS_I2C_READ_REG, mock_cells));
+  CHECK(get_sys_handler_count() == 3);
+  CHECK(get_sys_cell_handler(V4SYS_LED_SET) == mock_cells);
+  CHECK(get_sys_handler(V4SYS_LED_SET) == nullptr);
+
+  // A fourth input arrives packed into arg2
+  CHECK(invoke_sys_handler(V4SYS_LED_SET, 1, 2, (3 << 16) | 1) == 1);
+  CHECK(cells_seen[2] == 3);
+  CHECK(cells_seen[3] == 1);
+
+  CHECK(invoke_sys_handler(V4SYS_CAP_FLAGS, 4, 5, 6) == 6);
+
+  // More inputs than invoke_sys_handler() carries
+  CHECK(invoke_sys_handler(V4SYS_I2C_READ_REG, 1, 2, 3) == -1);
+
+  // Registering a SysHandler replaces the stack-cell handler
+  register_sys_handler(V4SYS_LED_SET, mock_led_on);
+  CHECK(get_sys_cell_handler(V4SYS_LED_SET) == nullptr);
+  CHECK(get_sys_handler(V4SYS_LED_SET) == mock_led_on);
+  CHECK(get_sys_handler_count() == 3);
+}
+
+TEST_CASE("SYS Dispatch: Zero outputs push nothing") {
+  reset_handlers();
+  register_sys_handler(V4SYS_PWM_START, mock_led_on);
+
+  // ( kind role index -- )
+  int32_t stack[4] = {9, 9, 9};
+  size_t depth = 3;
+
+  CHECK(dispatch_sys_call(V4SYS_PWM_START, stack, depth, 4) ==
+        SysCallStatus::Ok);
+  CHECK(depth == 0);
+}
+
+TEST_CASE("SYS Dispatch: Malformed calls never reach the handler") {
+  reset_handlers();
+  register_sys_handler(V4SYS_LED_ON, mock_led_on);
+  register_sys_handler(V4SYS_I2C_READ_REG, mock_led_on);
+  register_sys_handler(V4SYS_SYS_VERSION, mock_led_on);
+
+  int32_t stack[4] = {1, 2, 3, 4};
+
+  SUBCASE("Unknown ID") {
+    size_t depth = 3;
+    CHECK(dispatch_sys_call(0x01FF, stack, depth, 4) ==
+          SysCallStatus::UnknownId);
+    CHECK(depth == 3);
+  }
+
+  SUBCASE("Stack underflow") {
+    size_t depth = 2;
+    CHECK(dispatch_sys_call(V4SYS_LED_ON, stack, depth, 4) ==
+          SysCallStatus::StackUnderflow);
+    CHECK(depth == 2);
+  }
+
+  SUBCASE("Stack overflow") {
+    size_t depth = 4;
+    CHECK(dispatch_sys_call(V4SYS_SYS_VERSION, stack, depth, 4) ==
+          SysCallStatus::StackOverflow);
+    CHECK(depth == 4);
+  }
+
+  SUBCASE("Four inputs to a SysHandler") {
+    register_sys_handler(V4SYS_LED_SET, mock_led_on);
+    size_t depth = 4;
+    CHECK(dispatch_sys_call(V4SYS_LED_SET, stack, depth, 4) ==
+          SysCallStatus::BadArity);
+    CHECK(depth == 4);
+  }
+
+  SUBCASE("Arity beyond the SysHandler ABI") {
+    int32_t wide[8] = {1, 2, 3, 4, 5};
+    size_t depth = 5;
+    CHECK(dispatch_sys_call(V4SYS_I2C_READ_REG, wide, depth, 8) ==
+          SysCallStatus::BadArity);
+    CHECK(depth == 5);
+  }
+
+  SUBCASE("No handler") {
+    size_t depth = 3;
+    CHECK(dispatch_sys_call(V4SYS_LED_OFF, stack, depth, 4) ==
+          SysCallStatus::NoHandler);
+    CHECK(depth == 3);
+  }
+}
+
+TEST_CASE("SYS Dispatch: Blocking calls are routed to the async path") {
+  reset_handlers();
+  register_sys_handler(V4SYS_BUTTON_WAIT, mock_led_on);
+
+  int32_t stack[4] = {2, 2, 0, 1};
+  size_t depth = 4;
+
+  CHECK(dispatch_sys_call(V4SYS_BUTTON_WAIT, stack, depth, 4) ==
+        SysCallStatus::Blocking);
+  CHECK(depth == 4); // Arguments left for the async path
+}
@@ -7,6 +7,11 @@
 #include "doctest.h"
 
 #include "v4std/sys_ids.h"
+#include "v4std/sys_meta.hpp"
+#include <cstdio>
+#include <cstring>
+
+using namespace v4std;
 
 TEST_CASE("SYS IDs: LED operations range (0x0100-0x01FF)") {
   CHECK(V4SYS_LED_ON == 0x0100);
@@ -72,6 +77,7 @@ TEST_CASE("SYS IDs: System/Capability operations range (0x0F00-0x0FFF)") {
   CHECK(V4SYS_CAP_EXISTS == 0x0F01);
   CHECK(V4SYS_CAP_FLAGS == 0x0F02);
   CHECK(V4SYS_CAP_HANDLE == 0x0F03);
+  CHECK(V4SYS_CAP_ENUM == 0x0F04);
   CHECK(V4SYS_SYS_VERSION == 0x0FF0);
   CHECK(V4SYS_SYS_PLATFORM == 0x0FF1);
 }
@@ -115,3 +121,149 @@ TEST_CASE("SYS IDs: No overlapping IDs between categories") {
   CHECK((V4SYS_RNG_READ & 0xFF00) == 0x0B00);
   CHECK((V4SYS_CAP_COUNT & 0xFF00) == 0x0F00);
 }
+
+TEST_CASE("SYS IDs: Metadata table covers every ID") {
+  CHECK(sys_meta_count == 33);
+
+  for (size_t i = 0; i < sys_meta_count; ++i) {
+    CHECK(find_sys_meta(sys_meta_table[i].id) == &sys_meta_table[i]);
+  }
+
+  CHECK(find_sys_meta(0x0000) == nullptr);
+  CHECK(find_sys_meta(0x01FF) == nullptr);
+}
+
+TEST_CASE("SYS IDs: Metadata arity from stack effects") {
+  // ( kind role index -- success )
+  static_assert(find_sys_meta(V4SYS_LED_ON)->in_arity == 3, "LED_ON in");
+  static_assert(find_sys_meta(V4SYS_LED_ON)->out_arity == 1, "LED_ON out");
+
+  // ( kind role index state -- success )
+  CHECK(find_sys_meta(V4SYS_LED_SET)->in_arity == 4);
+
+  // ( kind role index state -- )
+  CHECK(find_sys_meta(V4SYS_BUTTON_WAIT)->in_arity == 4);
+  CHECK(find_sys_meta(V4SYS_BUTTON_WAIT)->out_arity == 0);
+
+  // ( kind role index addr reg -- value success )
+  CHECK(find_sys_meta(V4SYS_I2C_READ_REG)->in_arity == 5);
+  CHECK(find_sys_meta(V4SYS_I2C_READ_REG)->out_arity == 2);
+
+  // ( kind -- count )
+  CHECK(find_sys_meta(V4SYS_CAP_COUNT)->in_arity == 1);
+
+  // ( -- version )
+  CHECK(find_sys_meta(V4SYS_SYS_VERSION)->in_arity == 0);
+  CHECK(find_sys_meta(V4SYS_SYS_VERSION)->out_arity == 1);
+}
+
+TEST_CASE("SYS IDs: Metadata device kind and flags") {
+  CHECK(find_sys_meta(V4SYS_LED_ON)->kind == V4DEV_LED);
+  CHECK(find_sys_meta(V4SYS_UART_WRITE)->kind == V4DEV_UART);
+  CHECK(find_sys_meta(V4SYS_CAP_EXISTS)->kind == V4DEV_NONE);
+
+  CHECK(sys_is_pure(*find_sys_meta(V4SYS_LED_GET)));
+  CHECK_FALSE(sys_is_pure(*find_sys_meta(V4SYS_LED_ON)));
+
+  CHECK(sys_is_blocking(*find_sys_meta(V4SYS_BUTTON_WAIT)));
+  CHECK(sys_is_blocking(*find_sys_meta(V4SYS_UART_READ)));
+  CHECK_FALSE(sys_is_blocking(*find_sys_meta(V4SYS_BUTTON_READ)));
+}
+
+TEST_CASE("SYS IDs: Sorted ID array and dense ordinals") {
+  static_assert(sys_id_count == sys_meta_count, "One metadata row per ID");
+  static_assert(sys_ordinal(V4SYS_LED_ON) == V4SYS_ORD_LED_ON, "ordinal");
+  static_assert(sys_ordinal(V4SYS_SYS_PLATFORM) == sys_id_count - 1,
+                "highest ID has the last ordinal");
+
+  for (size_t i = 1; i < sys_id_count; ++i) {
+    CHECK(sys_ids_sorted[i - 1] < sys_ids_sorted[i]);
+  }
+
+  for (size_t i = 0; i < sys_id_count; ++i) {
+    CHECK(sys_ordinal(sys_ids_sorted[i]) == i);
+    CHECK(sys_meta_table[i].id == sys_ids_sorted[i]);
+  }
+
+  CHECK(sys_ordinal(0x0000) == sys_id_count);
+  CHECK(sys_ordinal(0x0104) == sys_id_count);
+  CHECK(sys_ordinal(0xFFFF) == sys_id_count);
+}
+
+TEST_CASE("SYS IDs: Ordinal-sized stats array") {
+  uint32_t calls[sys_id_count] = {};
+
+  calls[sys_ordinal(V4SYS_LED_TOGGLE)]++;
+  calls[V4SYS_ORD_LED_TOGGLE]++;
+
+  CHECK(calls[V4SYS_ORD_LED_TOGGLE] == 2);
+  CHECK(calls[V4SYS_ORD_LED_ON] == 0);
+}
+
+TEST_CASE("SYS IDs: Range ownership") {
+  CHECK(sys_range_kind(V4SYS_LED_GET) == V4DEV_LED);
+  CHECK(sys_range_kind(V4SYS_TIMER_RUNNING) == V4DEV_TIMER);
+  CHECK(sys_range_kind(V4SYS_CAP_COUNT) == V4DEV_NONE);
+  CHECK(sys_range_kind(0x0C00) == 0xFF);
+
+  for (size_t i = 0; i < sys_meta_count; ++i) {
+    CHECK(sys_range_kind(sys_meta_table[i].id) == sys_meta_table[i].kind);
+  }
+}
+
+#if V4STD_SYS_NAMES
+TEST_CASE("SYS IDs: Name and description lookup") {
+  static_assert(sys_name(V4SYS_LED_ON)[0] == 'L', "constexpr lookup");
+
+  CHECK(std::strcmp(sys_name(V4SYS_LED_ON), "LED_ON") == 0);
+  CHECK(std::strcmp(sys_name(V4SYS_SYS_PLATFORM), "SYS_PLATFORM") == 0);
+  CHECK(std::strcmp(sys_description(V4SYS_BUTTON_WAIT),
+                    "Wait for button state (0=release, 1=press)") == 0);
+  CHECK(std::strcmp(sys_description(V4SYS_RNG_READ), "Read random number") ==
+        0);
+
+  CHECK(sys_name(0x0104) == nullptr);
+  CHECK(sys_description(0x0104) == nullptr);
+
+  for (size_t i = 0; i < sys_id_count; ++i) {
+    REQUIRE(sys_name(sys_ids_sorted[i]) != nullptr);
+    CHECK(std::strlen(sys_name(sys_ids_sorted[i])) > 0);
+    CHECK(std::strlen(sys_description(sys_ids_sorted[i])) > 0);
+  }
+}
+#else
+TEST_CASE("SYS IDs: Name tables stripped") {
+  CHECK(sys_name(V4SYS_LED_ON) == nullptr);
+  CHECK(sys_description(V4SYS_LED_ON) == nullptr);
+}
+#endif
+
+// Returns true if the generated Forth library contains the given line
+static bool fth_has_line(const char *expected) {
+  FILE *f = std::fopen(V4SYS_FTH_FILE, "r");
+  if (!f) {
+    return false;
+  }
+
+  char line[256];
+  bool found = false;
+  while (!found && std::fgets(line, sizeof(line), f)) {
+    line[std::strcspn(line, "\n")] = '\0';
+    found = std::strcmp(line, expected) == 0;
+  }
+
+  std::fclose(f);
+  return found;
+}
+
+TEST_CASE("SYS IDs: Generated Forth word library") {
+  CHECK(fth_has_line(": led-on ( kind role index -- success ) 256 sys ;"));
+  CHECK(fth_has_line(
+      ": led-set ( kind role index state -- success ) 259 sys ;"));
+  CHECK(fth_has_line(": button-wait ( kind role index state -- ) 513 sys ;"));
+  CHECK(fth_has_line(
+      ": i2c-read-reg ( kind role index addr reg -- value success ) 1280 "
+      "sys ;"));
+  CHECK(fth_has_line(": cap-count ( kind -- count ) 3840 sys ;"));
+  CHECK(fth_has_line(": sys-version ( -- version ) 4080 sys ;"));
+}
@@ -40,8 +40,8 @@ public:
 // Mock DDT provider with LED devices
 class MockDdtProvider : public DdtProvider {
 public:
-  span<const v4dev_desc_t> get_devices() const override {
-    static constexpr v4dev_desc_t devices[] = {
+  span<const DeviceDesc> get_devices() const override {
+    static constexpr DeviceDesc devices[] = {
         // STATUS LED (GPIO7, active-high)
         {V4DEV_LED, V4ROLE_STATUS, 0, 0, 7},
         // USER LED (GPIO8, active-high)
@@ -50,7 +50,7 @@ public:
         {V4DEV_LED, V4ROLE_USER, 1, V4DEV_FLAG_ACTIVE_LOW, 10},
     };
 
-    return span<const v4dev_desc_t>{devices, 3};
+    return span<const DeviceDesc>{devices, 3};
   }
 };
 
@@ -169,6 +169,38 @@ TEST_CASE("LED SYS: LED_SET (set to OFF)") {
   CHECK(g_hal.led_states[7] == false);
 }
 
+TEST_CASE("LED SYS: Out-of-range indices match no LED") {
+  g_hal.clear();
+  set_led_hal(&g_hal);
+  Ddt::set_provider(&g_provider);
+  register_led_sys_handlers();
+
+  // 256 would truncate to index 0
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_STATUS, 256) ==
+        0);
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_STATUS + 0x100,
+                           0) == 0);
+  CHECK(g_hal.led_states.empty());
+}
+
+TEST_CASE("LED SYS: LED_SET through dispatch_sys_call") {
+  g_hal.clear();
+  set_led_hal(&g_hal);
+  Ddt::set_provider(&g_provider);
+  register_led_sys_handlers();
+  g_hal.led_states[10] = true; // Active-low LED starts off
+
+  // ( kind role index state -- success ), each in its own cell
+  int32_t stack[4] = {V4DEV_LED, V4ROLE_USER, 1, 0x10000};
+  size_t depth = 4;
+  CHECK(dispatch_sys_call(V4SYS_LED_SET, stack, depth, 4) ==
+        SysCallStatus::Ok);
+  REQUIRE(depth == 1);
+  CHECK(stack[0] == 1);
+  CHECK(g_hal.led_states[10] == false); // Active-low: on is level 0
+  CHECK(invoke_sys_handler(V4SYS_LED_GET, V4DEV_LED, V4ROLE_USER, 1) == 1);
+}
+
 TEST_CASE("LED SYS: LED_GET") {
   g_hal.clear();
   set_led_hal(&g_hal);
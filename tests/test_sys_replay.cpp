@@ -0,0 +1,136 @@
+/**
+ * @file test_sys_replay.cpp
+ * @brief Tests for SYS call log replay against a virtual board
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt.hpp"
+#include "v4std/sim/sys_replay.hpp"
+#include "v4std/sim/virtual_board.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_led.hpp"
+#include "v4std/sys_trace.hpp"
+#include <chrono>
+#include <vector>
+
+using namespace v4std;
+
+static uint32_t g_now_us = 0;
+static uint32_t fake_clock() { return g_now_us; }
+
+static void install(VirtualBoard &board) {
+  clear_sys_handlers();
+  Ddt::set_provider(&board);
+  set_led_hal(&board.led_hal());
+  register_led_sys_handlers();
+}
+
+static void uninstall() {
+  clear_sys_handlers();
+  set_led_hal(nullptr);
+  Ddt::set_provider(nullptr);
+}
+
+// Record a short LED workload on a fresh board
+static std::vector<uint8_t> record_workload(size_t calls) {
+  VirtualBoard board;
+  board.add_devices(V4DEV_LED, V4ROLE_USER, 8);
+  install(board);
+
+  std::vector<uint8_t> buffer(kSysTraceHeaderSize +
+                              calls * kSysTraceMaxRecordSize);
+  SysTraceRecorder recorder{span<uint8_t>{buffer}, fake_clock};
+  recorder.attach();
+
+  g_now_us = 0;
+  for (size_t i = 0; i < calls; ++i) {
+    g_now_us += 100;
+    int32_t index = static_cast<int32_t>(i % 10); // 8, 9 do not exist
+    uint16_t op = (i % 3 == 0) ? V4SYS_LED_TOGGLE : V4SYS_LED_GET;
+    invoke_sys_handler(op, V4DEV_LED, V4ROLE_USER, index);
+  }
+
+  recorder.detach();
+  uninstall();
+
+  buffer.resize(recorder.data().size());
+  return buffer;
+}
+
+TEST_CASE("SysReplay: Same board replays without divergence") {
+  std::vector<uint8_t> log = record_workload(300);
+
+  VirtualBoard board;
+  board.add_devices(V4DEV_LED, V4ROLE_USER, 8);
+  install(board);
+
+  SysReplayStats stats = replay_sys_trace(span<const uint8_t>{log});
+
+  CHECK_FALSE(stats.malformed);
+  CHECK(stats.calls == 300);
+  CHECK(stats.divergences == 0);
+  CHECK(stats.elapsed_ns > 0);
+  CHECK(stats.throughput() > 0.0);
+
+  uint64_t histogram_total = 0;
+  for (uint64_t count : stats.latency_histogram) {
+    histogram_total += count;
+  }
+  CHECK(histogram_total == 300);
+  CHECK(stats.latency_percentile_ns(50) <= stats.latency_percentile_ns(99));
+
+  // Calls to indices 8 and 9 never reach the HAL; toggles read and write
+  uint64_t hal_calls = 0;
+  for (size_t i = 0; i < 300; ++i) {
+    if (i % 10 < 8) {
+      hal_calls += (i % 3 == 0) ? 2 : 1;
+    }
+  }
+  CHECK(board.hal(V4DEV_LED).calls() == hal_calls);
+
+  uninstall();
+}
+
+TEST_CASE("SysReplay: Different board reports divergence") {
+  std::vector<uint8_t> log = record_workload(100);
+
+  // Only 4 LEDs: calls to indices 4..7 now fail
+  VirtualBoard board;
+  board.add_devices(V4DEV_LED, V4ROLE_USER, 4);
+  install(board);
+
+  SysReplayStats stats = replay_sys_trace(span<const uint8_t>{log});
+
+  CHECK(stats.calls == 100);
+  CHECK(stats.divergences > 0);
+
+  uninstall();
+}
+
+TEST_CASE("SysReplay: Paced replay follows recorded timing") {
+  std::vector<uint8_t> log = record_workload(50); // 49 gaps of 100 us
+
+  VirtualBoard board;
+  board.add_devices(V4DEV_LED, V4ROLE_USER, 8);
+  install(board);
+
+  SysReplayOptions options;
+  options.paced = true;
+  options.speed = 2.0;
+  SysReplayStats stats = replay_sys_trace(span<const uint8_t>{log}, options);
+
+  CHECK(stats.calls == 50);
+  CHECK(stats.elapsed_ns >= 2450 * 1000); // 4.9 ms recorded / 2
+
+  uninstall();
+}
+
+TEST_CASE("SysReplay: Malformed log") {
+  const uint8_t garbage[] = {1, 2, 3, 4, 5, 6};
+  SysReplayStats stats = replay_sys_trace(span<const uint8_t>{garbage});
+  CHECK(stats.malformed);
+  CHECK(stats.calls == 0);
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_sys_trace.cpp
+ * @brief Tests for the SYS call recorder and trace log reader
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt_types.h"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_trace.hpp"
+#include <cstdint>
+
+using namespace v4std;
+
+static uint32_t g_now_us = 0;
+static uint32_t fake_clock() { return g_now_us; }
+
+static int32_t mock_sum(uint16_t sys_id, int32_t arg0, int32_t arg1,
+                        int32_t arg2) {
+  (void)sys_id;
+  return arg0 + arg1 + arg2;
+}
+
+// ( a b c d -- a^d c )
+static void mock_cells(uint16_t sys_id, const int32_t *in, size_t in_count,
+                       int32_t *out, size_t out_count) {
+  (void)sys_id;
+  (void)in_count;
+  (void)out_count;
+  out[0] = in[0] ^ in[3];
+  out[1] = in[2];
+}
+
+TEST_CASE("SysTrace: Record and decode round trip") {
+  uint8_t buffer[256];
+  SysTraceRecorder recorder{span<uint8_t>{buffer}, fake_clock};
+
+  CHECK(recorder.data().size() == kSysTraceHeaderSize);
+
+  const SysTraceRecord records[] = {
+      {0, V4SYS_LED_ON, 3, {V4DEV_LED, V4ROLE_USER, 0}, 1},
+      {1500, V4SYS_LED_SET, 3, {1, 2, (3 << 16) | 1}, 0},
+      {70000, 0xFFFF, 8, {INT32_MIN, INT32_MAX, -1, 0x12345, -0x8000, 5, 6, 7},
+       -1},
+      {3, V4SYS_LED_ON, 0, {}, 2},
+  };
+  for (const auto &rec : records) {
+    CHECK(recorder.record(rec));
+  }
+  CHECK(recorder.record_count() == 4);
+
+  SysTraceReader reader{recorder.data()};
+  REQUIRE(reader.valid());
+
+  SysTraceRecord rec;
+  for (const auto &expected : records) {
+    REQUIRE(reader.next(rec));
+    CHECK(rec.delta_us == expected.delta_us);
+    CHECK(rec.sys_id == expected.sys_id);
+    REQUIRE(rec.in_count == expected.in_count);
+    for (size_t i = 0; i < rec.in_count; ++i) {
+      CHECK(rec.in[i] == expected.in[i]);
+    }
+    CHECK(rec.result == expected.result);
+  }
+  CHECK_FALSE(reader.next(rec));
+  CHECK_FALSE(reader.error());
+
+  reader.rewind();
+  REQUIRE(reader.next(rec));
+  CHECK(rec.sys_id == V4SYS_LED_ON);
+}
+
+TEST_CASE("SysTrace: Small values encode compactly") {
+  uint8_t buffer[64];
+  SysTraceRecorder recorder{span<uint8_t>{buffer}, fake_clock};
+
+  recorder.record(SysTraceRecord{10, V4SYS_LED_ON, 3, {1, 2, 0}, 1});
+
+  // delta (1) + ID 0x0100 (2) + count (1) + four small values (1 each)
+  CHECK(recorder.data().size() == kSysTraceHeaderSize + 8);
+}
+
+TEST_CASE("SysTrace: Full buffer drops records") {
+  uint8_t buffer[kSysTraceHeaderSize + 10];
+  SysTraceRecorder recorder{span<uint8_t>{buffer}, fake_clock};
+
+  const SysTraceRecord led_on = {0, V4SYS_LED_ON, 3, {1, 2, 0}, 1};
+  CHECK(recorder.record(led_on));
+  CHECK_FALSE(recorder.record(led_on));
+  CHECK(recorder.record_count() == 1);
+  CHECK(recorder.dropped() == 1);
+
+  // The log stays decodable
+  SysTraceReader reader{recorder.data()};
+  SysTraceRecord rec;
+  CHECK(reader.next(rec));
+  CHECK_FALSE(reader.next(rec));
+  CHECK_FALSE(reader.error());
+
+  recorder.reset();
+  CHECK(recorder.record_count() == 0);
+  CHECK(recorder.dropped() == 0);
+  CHECK(recorder.data().size() == kSysTraceHeaderSize);
+}
+
+TEST_CASE("SysTrace: Reader rejects bad logs") {
+  const uint8_t bad_magic[] = {'X', '4', 'T', 'R', 1};
+  CHECK_FALSE(SysTraceReader{span<const uint8_t>{bad_magic}}.valid());
+
+  const uint8_t bad_version[] = {'V', '4', 'T', 'R', 99};
+  CHECK_FALSE(SysTraceReader{span<const uint8_t>{bad_version}}.valid());
+
+  // Version 1 logs packed a fourth cell into arg2
+  const uint8_t version1[] = {'V', '4', 'T', 'R', 1};
+  CHECK_FALSE(SysTraceReader{span<const uint8_t>{version1}}.valid());
+
+  // Record truncated in the middle of a varint
+  const uint8_t truncated[] = {'V', '4', 'T', 'R', 2, 0x00, 0x80};
+  SysTraceReader reader{span<const uint8_t>{truncated}};
+  REQUIRE(reader.valid());
+  SysTraceRecord rec;
+  CHECK_FALSE(reader.next(rec));
+  CHECK(reader.error());
+
+  // More input cells than any call has
+  const uint8_t too_many[] = {'V', '4', 'T', 'R', 2, 0x00, 0x01, 0x09};
+  SysTraceReader wide{span<const uint8_t>{too_many}};
+  CHECK_FALSE(wide.next(rec));
+  CHECK(wide.error());
+
+  // The recorder refuses them too
+  uint8_t buffer[64];
+  SysTraceRecorder recorder{span<uint8_t>{buffer}, fake_clock};
+  SysTraceRecord over = {};
+  over.in_count = kSysMaxCells + 1;
+  CHECK_FALSE(recorder.record(over));
+  CHECK(recorder.dropped() == 1);
+}
+
+TEST_CASE("SysTrace: Recorder captures invoke_sys_handler stream") {
+  clear_sys_handlers();
+  register_sys_handler(V4SYS_LED_ON, mock_sum);
+
+  uint8_t buffer[256];
+  SysTraceRecorder recorder{span<uint8_t>{buffer}, fake_clock};
+  recorder.attach();
+
+  g_now_us = 0xFFFFFF00; // Exercise clock wraparound
+  invoke_sys_handler(V4SYS_LED_ON, 1, 2, 3);
+  g_now_us += 0x200;
+  invoke_sys_handler(V4SYS_BUTTON_READ, 4, 5, 6); // No handler: -1
+
+  int32_t stack[4] = {1, 2, 4};
+  size_t depth = 3;
+  g_now_us += 50;
+  dispatch_sys_call(V4SYS_LED_ON, stack, depth, 4);
+
+  recorder.detach();
+  invoke_sys_handler(V4SYS_LED_ON, 0, 0, 0); // Not recorded
+
+  CHECK(recorder.record_count() == 3);
+
+  SysTraceReader reader{recorder.data()};
+  SysTraceRecord rec;
+  REQUIRE(reader.next(rec));
+  CHECK(rec.delta_us == 0);
+  CHECK(rec.sys_id == V4SYS_LED_ON);
+  CHECK(rec.result == 6);
+
+  REQUIRE(reader.next(rec));
+  CHECK(rec.delta_us == 0x200);
+  CHECK(rec.sys_id == V4SYS_BUTTON_READ);
+  CHECK(rec.in_count == 3);
+  CHECK(rec.in[2] == 6);
+  CHECK(rec.result == -1);
+
+  REQUIRE(reader.next(rec));
+  CHECK(rec.delta_us == 50);
+  CHECK(rec.result == 7);
+
+  clear_sys_handlers();
+}
+
+TEST_CASE("SysTrace: Stack-cell calls keep every cell") {
+  clear_sys_handlers();
+  REQUIRE(register_sys_cell_handler(V4SYS_CAP_ENUM, mock_cells));
+
+  uint8_t buffer[256];
+  SysTraceRecorder recorder{span<uint8_t>{buffer}, fake_clock};
+  recorder.attach();
+
+  // Neither an address above 0xFFFF nor a count of 0x8000 or more fits
+  // the packed invoke_sys_handler() form
+  int32_t stack[4] = {V4DEV_LED, -1, 0x9000, 0x12345};
+  size_t depth = 4;
+  REQUIRE(dispatch_sys_call(V4SYS_CAP_ENUM, stack, depth, 4) ==
+          SysCallStatus::Ok);
+  int32_t result = stack[0];
+  recorder.detach();
+
+  SysTraceReader reader{recorder.data()};
+  SysTraceRecord rec;
+  REQUIRE(reader.next(rec));
+  REQUIRE(rec.in_count == 4);
+  CHECK(rec.in[0] == V4DEV_LED);
+  CHECK(rec.in[1] == -1);
+  CHECK(rec.in[2] == 0x9000);
+  CHECK(rec.in[3] == 0x12345);
+  CHECK(rec.result == result);
+
+  // Replaying the record repeats the call
+  CHECK(invoke_sys_cells(rec.sys_id, rec.in, rec.in_count) == rec.result);
+
+  clear_sys_handlers();
+}
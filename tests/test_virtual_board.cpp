@@ -0,0 +1,166 @@
+/**
+ * @file test_virtual_board.cpp
+ * @brief Tests for the host virtual board simulator
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "v4std/ddt.hpp"
+#include "v4std/sim/virtual_board.hpp"
+#include "v4std/sys_handlers.hpp"
+#include "v4std/sys_ids.h"
+#include "v4std/sys_led.hpp"
+#include <thread>
+#include <vector>
+
+using namespace v4std;
+
+// Handles are positions, so the compact layout holds 256 devices
+constexpr uint64_t kMaxDevices =
+    uint64_t{DeviceDescTraits<DeviceDesc>::max_handle} + 1;
+
+TEST_CASE("VirtualBoard: Devices per kind/role") {
+  VirtualBoard board;
+
+  CHECK(board.add_devices(V4DEV_LED, V4ROLE_USER, 200));
+  CHECK(board.add_devices(V4DEV_LED, V4ROLE_STATUS, 3, V4DEV_FLAG_ACTIVE_LOW));
+  CHECK_FALSE(board.add_devices(V4DEV_NONE, V4ROLE_USER, 1));
+  CHECK_FALSE(board.add_devices(V4DEV_LED, V4ROLE_NONE, 1));
+
+  if (kMaxDevices > 259) {
+    CHECK(board.add_devices(V4DEV_LED, V4ROLE_USER, 56)); // Up to index 255
+    CHECK_FALSE(board.add_devices(V4DEV_LED, V4ROLE_USER, 1));
+    CHECK(board.device_count() == 259);
+    CHECK(board.get_devices()[258].index == 255);
+  } else {
+    // Handles past max_handle do not fit the descriptor
+    CHECK_FALSE(board.add_devices(V4DEV_LED, V4ROLE_USER, 56));
+    CHECK(board.add_devices(V4DEV_LED, V4ROLE_USER, 53));
+    CHECK_FALSE(board.add_devices(V4DEV_LED, V4ROLE_USER, 1));
+    CHECK(board.device_count() == kMaxDevices);
+  }
+
+  auto devices = board.get_devices();
+  CHECK(desc_role(devices[200]) == V4ROLE_STATUS);
+  CHECK(devices[200].index == 0);
+  CHECK(desc_flags(devices[200]) == V4DEV_FLAG_ACTIVE_LOW);
+  for (size_t i = 0; i < devices.size(); ++i) {
+    CHECK(devices[i].handle == i);
+  }
+
+  board.clear();
+  CHECK(board.device_count() == 0);
+  CHECK(board.add_devices(V4DEV_LED, V4ROLE_USER, 256));
+}
+
+TEST_CASE("VirtualBoard: add_all populates every kind/role") {
+  // 12 kinds x 5 roles
+  constexpr size_t kGroups = 12 * 5;
+  constexpr size_t kPerRole =
+      kMaxDevices / kGroups < 64 ? kMaxDevices / kGroups : 64;
+
+  VirtualBoard board;
+  REQUIRE(board.add_all(kPerRole));
+  CHECK(board.device_count() == kGroups * kPerRole);
+
+  Ddt::set_provider(&board);
+  CHECK(Ddt::count_devices(V4DEV_UART) == 5 * kPerRole);
+  CHECK(Ddt::devices_of(V4DEV_UART).size() == 5 * kPerRole);
+
+  const DeviceDesc *dev =
+      Ddt::find_device(V4DEV_RNG, V4ROLE_DEBUG, kPerRole - 1);
+  REQUIRE(dev != nullptr);
+  CHECK(dev->handle == board.device_count() - 1);
+  CHECK(Ddt::find_device(V4DEV_RNG, V4ROLE_DEBUG, kPerRole) == nullptr);
+
+  Ddt::set_provider(nullptr);
+}
+
+TEST_CASE("VirtualBoard: HAL state and counters") {
+  VirtualBoard board;
+  board.add_devices(V4DEV_ADC, V4ROLE_USER, 2);
+  board.add_devices(V4DEV_PWM, V4ROLE_USER, 1);
+
+  VirtualHal &adc = board.hal(V4DEV_ADC);
+  VirtualHal &pwm = board.hal(V4DEV_PWM);
+
+  board.set_value(1, 512); // Inject a sample
+  int32_t sample = 0;
+  CHECK(adc.read(1, sample));
+  CHECK(sample == 512);
+
+  CHECK(pwm.write(2, 128));
+  CHECK(board.value(2) == 128);
+
+  // Handle 2 is a PWM, not an ADC
+  CHECK_FALSE(adc.write(2, 0));
+  CHECK_FALSE(adc.read(99, sample));
+
+  CHECK(adc.reads() == 1);
+  CHECK(adc.writes() == 0);
+  CHECK(adc.errors() == 2);
+  CHECK(pwm.writes() == 1);
+  CHECK(board.device_calls(1) == 1);
+  CHECK(board.device_calls(2) == 1);
+  CHECK(board.total_calls() == 4);
+
+  board.reset_counters();
+  CHECK(board.total_calls() == 0);
+  CHECK(board.device_calls(1) == 0);
+}
+
+TEST_CASE("VirtualBoard: LED SYS calls through the virtual HAL") {
+  VirtualBoard board;
+  board.add_devices(V4DEV_LED, V4ROLE_USER, 100);
+  board.add_devices(V4DEV_LED, V4ROLE_STATUS, 1, V4DEV_FLAG_ACTIVE_LOW);
+
+  clear_sys_handlers();
+  Ddt::set_provider(&board);
+  set_led_hal(&board.led_hal());
+  register_led_sys_handlers();
+
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_USER, 99) == 1);
+  CHECK(board.value(99) == 1);
+  CHECK(invoke_sys_handler(V4SYS_LED_GET, V4DEV_LED, V4ROLE_USER, 99) == 1);
+
+  // Active-low: logical on drives the pin low
+  CHECK(invoke_sys_handler(V4SYS_LED_ON, V4DEV_LED, V4ROLE_STATUS, 0) == 1);
+  CHECK(board.value(100) == 0);
+  CHECK(invoke_sys_handler(V4SYS_LED_GET, V4DEV_LED, V4ROLE_STATUS, 0) == 1);
+
+  CHECK(board.hal(V4DEV_LED).writes() == 2);
+  CHECK(board.hal(V4DEV_LED).reads() == 2);
+
+  clear_sys_handlers();
+  set_led_hal(nullptr);
+  Ddt::set_provider(nullptr);
+}
+
+TEST_CASE("VirtualBoard: Concurrent HAL calls are all counted") {
+  VirtualBoard board;
+  board.add_devices(V4DEV_LED, V4ROLE_USER, 16);
+  VirtualHal &leds = board.hal(V4DEV_LED);
+  leds.set_latency_ns(100);
+
+  constexpr int kThreads = 4;
+  constexpr int kCalls = 2000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&leds, t] {
+      for (int i = 0; i < kCalls; ++i) {
+        leds.write(static_cast<uint32_t>((t * kCalls + i) % 16), i & 1);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  CHECK(leds.writes() == kThreads * kCalls);
+  uint64_t per_device = 0;
+  for (uint32_t h = 0; h < 16; ++h) {
+    per_device += board.device_calls(h);
+  }
+  CHECK(per_device == kThreads * kCalls);
+}
@@ -0,0 +1,255 @@
+/**
+ * @file v4ddt_compile.cpp
+ * @brief Compile a text device list into a binary DDT image
+ *
+ * Usage:
+ *   v4ddt_compile <input.ddt> <output> [--c-array <symbol>]
+ *
+ * Input has one device per line: kind, role, index, flags, handle.
+ * Kinds and roles are names from ddt_types.h without their prefix
+ * (LED, USER, ...) or numbers; flags are '-', a number, or names joined
+ * with '|' (ACTIVE_LOW); numbers may be decimal or 0x-prefixed hex.
+ * '#' starts a comment. Each (kind, role, index) may appear once.
+ *
+ *   # kind  role     index  flags       handle
+ *   LED     STATUS   0      -           7
+ *   LED     USER     1      ACTIVE_LOW  10
+ *   UART    CONSOLE  0      -           0
+ *
+ * By default the output is the raw image (for mmap or a flash
+ * partition). With --c-array it is a C++ source file defining an aligned
+ * byte array <symbol> and <symbol>_size to link into firmware. Images
+ * are written in host byte order (little-endian on usual build hosts,
+ * matching every supported target).
+ */
+
+#include "v4std/ddt_image.hpp"
+#include "v4std/ddt_types.h"
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace v4std;
+
+static const char *const kKindNames[] = {
+    "NONE", "LED", "BUTTON", "BUZZER", "TIMER",   "UART",    "I2C",
+    "SPI",  "ADC", "PWM",    "STORAGE", "DISPLAY", "RNG"};
+
+static const char *const kRoleNames[] = {"NONE", "STATUS",  "USER",
+                                         "POWER", "CONSOLE", "DEBUG"};
+
+static bool equals_ignore_case(const char *a, const char *b) {
+  for (; *a && *b; ++a, ++b) {
+    if (std::toupper(static_cast<unsigned char>(*a)) !=
+        std::toupper(static_cast<unsigned char>(*b))) {
+      return false;
+    }
+  }
+  return *a == *b;
+}
+
+static bool parse_number(const char *text, unsigned long max,
+                         unsigned long &value) {
+  char *end = nullptr;
+  errno = 0;
+  value = std::strtoul(text, &end, 0);
+  return errno == 0 && end != text && *end == '\0' && value <= max;
+}
+
+// Name from a table, or a number below 256
+static bool parse_name(const char *text, const char *const *names,
+                       size_t count, uint8_t &value) {
+  for (size_t i = 0; i < count; ++i) {
+    if (equals_ignore_case(text, names[i])) {
+      value = static_cast<uint8_t>(i);
+      return true;
+    }
+  }
+
+  unsigned long number;
+  if (!parse_number(text, 0xFF, number)) {
+    return false;
+  }
+  value = static_cast<uint8_t>(number);
+  return true;
+}
+
+static bool parse_flags(const char *text, uint8_t &flags) {
+  flags = 0;
+  if (std::strcmp(text, "-") == 0) {
+    return true;
+  }
+
+  std::string all = text;
+  size_t start = 0;
+  while (start <= all.size()) {
+    size_t bar = all.find('|', start);
+    std::string part = all.substr(start, bar - start);
+    unsigned long number;
+    if (equals_ignore_case(part.c_str(), "ACTIVE_LOW")) {
+      flags |= V4DEV_FLAG_ACTIVE_LOW;
+    } else if (parse_number(part.c_str(), 0xFF, number)) {
+      flags |= static_cast<uint8_t>(number);
+    } else {
+      return false;
+    }
+    if (bar == std::string::npos) {
+      break;
+    }
+    start = bar + 1;
+  }
+  return true;
+}
+
+static bool parse_line(char *line, v4dev_desc_t &dev, bool &empty,
+                       std::string &error) {
+  char *hash = std::strchr(line, '#');
+  if (hash) {
+    *hash = '\0';
+  }
+
+  const char *fields[6] = {};
+  size_t count = 0;
+  for (char *token = std::strtok(line, " \t\r\n"); token;
+       token = std::strtok(nullptr, " \t\r\n")) {
+    if (count == 5) {
+      error = "too many fields";
+      return false;
+    }
+    fields[count++] = token;
+  }
+
+  empty = count == 0;
+  if (empty) {
+    return true;
+  }
+  if (count != 5) {
+    error = "expected: kind role index flags handle";
+    return false;
+  }
+
+  unsigned long index;
+  unsigned long handle;
+  size_t kinds = sizeof(kKindNames) / sizeof(*kKindNames);
+  size_t roles = sizeof(kRoleNames) / sizeof(*kRoleNames);
+  if (!parse_name(fields[0], kKindNames, kinds, dev.kind)) {
+    error = std::string("unknown kind '") + fields[0] + "'";
+  } else if (!parse_name(fields[1], kRoleNames, roles, dev.role)) {
+    error = std::string("unknown role '") + fields[1] + "'";
+  } else if (!parse_number(fields[2], 0xFF, index)) {
+    error = std::string("bad index '") + fields[2] + "'";
+  } else if (!parse_flags(fields[3], dev.flags)) {
+    error = std::string("bad flags '") + fields[3] + "'";
+  } else if (!parse_number(fields[4], 0xFFFFFFFFul, handle)) {
+    error = std::string("bad handle '") + fields[4] + "'";
+  } else {
+    dev.index = static_cast<uint8_t>(index);
+    dev.handle = static_cast<uint32_t>(handle);
+    return true;
+  }
+  return false;
+}
+
+static bool write_c_array(std::FILE *out, const char *symbol,
+                          const std::vector<uint8_t> &image) {
+  std::fprintf(out, "// Generated by v4ddt_compile. DO NOT EDIT.\n\n");
+  std::fprintf(out, "#include <cstddef>\n#include <cstdint>\n\n");
+  std::fprintf(out, "alignas(4) extern const uint8_t %s[] = {", symbol);
+  for (size_t i = 0; i < image.size(); ++i) {
+    std::fprintf(out, "%s0x%02x,", i % 12 == 0 ? "\n    " : " ", image[i]);
+  }
+  std::fprintf(out, "\n};\n\n");
+  std::fprintf(out, "extern const size_t %s_size = %zu;\n", symbol,
+               image.size());
+  return !std::ferror(out);
+}
+
+int main(int argc, char **argv) {
+  const char *symbol = nullptr;
+  if (argc == 5 && std::strcmp(argv[3], "--c-array") == 0) {
+    symbol = argv[4];
+  } else if (argc != 3) {
+    std::fprintf(stderr,
+                 "usage: %s <input.ddt> <output> [--c-array <symbol>]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  std::FILE *in = std::fopen(argv[1], "r");
+  if (!in) {
+    std::perror(argv[1]);
+    return 1;
+  }
+
+  std::vector<DeviceDesc> devices;
+  std::unordered_map<uint32_t, int> key_lines;
+  char line[512];
+  int line_number = 0;
+  bool ok = true;
+  while (std::fgets(line, sizeof(line), in)) {
+    ++line_number;
+    v4dev_desc_t dev = {};
+    bool empty = false;
+    std::string error;
+    if (!parse_line(line, dev, empty, error)) {
+      std::fprintf(stderr, "%s:%d: error: %s\n", argv[1], line_number,
+                   error.c_str());
+      ok = false;
+    } else if (!empty && !desc_fits(dev)) {
+      std::fprintf(stderr,
+                   "%s:%d: error: role, flags or handle too large for the "
+                   "compact layout\n",
+                   argv[1], line_number);
+      ok = false;
+    } else if (!empty) {
+      uint32_t key = (static_cast<uint32_t>(dev.kind) << 16) |
+                     (static_cast<uint32_t>(dev.role) << 8) | dev.index;
+      auto first = key_lines.emplace(key, line_number);
+      if (!first.second) {
+        std::fprintf(stderr,
+                     "%s:%d: error: duplicate device (first on line %d)\n",
+                     argv[1], line_number, first.first->second);
+        ok = false;
+      } else {
+        devices.push_back(make_desc(dev));
+      }
+    }
+  }
+  std::fclose(in);
+  if (!ok) {
+    return 1;
+  }
+
+  span<const DeviceDesc> table{devices.data(), devices.size()};
+  std::vector<uint8_t> image(ddt_image_size(table));
+  size_t size =
+      build_ddt_image(table, span<uint8_t>{image.data(), image.size()});
+  if (size == 0) {
+    std::fprintf(stderr, "%s: too many devices (max %zu)\n", argv[1],
+                 kDdtImageMaxDevices);
+    return 1;
+  }
+  image.resize(size);
+
+  std::FILE *out = std::fopen(argv[2], symbol ? "w" : "wb");
+  if (!out) {
+    std::perror(argv[2]);
+    return 1;
+  }
+  bool written = symbol ? write_c_array(out, symbol, image)
+                        : std::fwrite(image.data(), 1, image.size(), out) ==
+                              image.size();
+  if (std::fclose(out) != 0 || !written) {
+    std::fprintf(stderr, "%s: write failed\n", argv[2]);
+    return 1;
+  }
+
+  std::printf("%s: %zu devices, %zu bytes\n", argv[2], devices.size(),
+              image.size());
+  return 0;
+}